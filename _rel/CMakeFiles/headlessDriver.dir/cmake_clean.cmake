@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/headlessDriver.dir/bench/headless/Driver.cpp.o"
+  "CMakeFiles/headlessDriver.dir/bench/headless/Driver.cpp.o.d"
+  "headlessDriver"
+  "headlessDriver.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/headlessDriver.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,23 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/src/core/Array.cpp" "CMakeFiles/mathNodesCore.dir/src/core/Array.cpp.o" "gcc" "CMakeFiles/mathNodesCore.dir/src/core/Array.cpp.o.d"
+  "/root/repo/src/core/Interpolate.cpp" "CMakeFiles/mathNodesCore.dir/src/core/Interpolate.cpp.o" "gcc" "CMakeFiles/mathNodesCore.dir/src/core/Interpolate.cpp.o.d"
+  "/root/repo/src/core/Matrix.cpp" "CMakeFiles/mathNodesCore.dir/src/core/Matrix.cpp.o" "gcc" "CMakeFiles/mathNodesCore.dir/src/core/Matrix.cpp.o.d"
+  "/root/repo/src/core/Rotation.cpp" "CMakeFiles/mathNodesCore.dir/src/core/Rotation.cpp.o" "gcc" "CMakeFiles/mathNodesCore.dir/src/core/Rotation.cpp.o.d"
+  "/root/repo/src/core/Simd.cpp" "CMakeFiles/mathNodesCore.dir/src/core/Simd.cpp.o" "gcc" "CMakeFiles/mathNodesCore.dir/src/core/Simd.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,19 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/mathNodesCore.dir/src/core/Array.cpp.o"
+  "CMakeFiles/mathNodesCore.dir/src/core/Array.cpp.o.d"
+  "CMakeFiles/mathNodesCore.dir/src/core/Interpolate.cpp.o"
+  "CMakeFiles/mathNodesCore.dir/src/core/Interpolate.cpp.o.d"
+  "CMakeFiles/mathNodesCore.dir/src/core/Matrix.cpp.o"
+  "CMakeFiles/mathNodesCore.dir/src/core/Matrix.cpp.o.d"
+  "CMakeFiles/mathNodesCore.dir/src/core/Rotation.cpp.o"
+  "CMakeFiles/mathNodesCore.dir/src/core/Rotation.cpp.o.d"
+  "CMakeFiles/mathNodesCore.dir/src/core/Simd.cpp.o"
+  "CMakeFiles/mathNodesCore.dir/src/core/Simd.cpp.o.d"
+  "libmathNodesCore.a"
+  "libmathNodesCore.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/mathNodesCore.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,22 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/bench/headless/HeadlessMaya.cpp" "CMakeFiles/mathNodesHeadless.dir/bench/headless/HeadlessMaya.cpp.o" "gcc" "CMakeFiles/mathNodesHeadless.dir/bench/headless/HeadlessMaya.cpp.o.d"
+  "/root/repo/bench/headless/Inputs.cpp" "CMakeFiles/mathNodesHeadless.dir/bench/headless/Inputs.cpp.o" "gcc" "CMakeFiles/mathNodesHeadless.dir/bench/headless/Inputs.cpp.o.d"
+  "/root/repo/src/Plugin.cpp" "CMakeFiles/mathNodesHeadless.dir/src/Plugin.cpp.o" "gcc" "CMakeFiles/mathNodesHeadless.dir/src/Plugin.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/_rel/CMakeFiles/mathNodesCore.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,15 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/mathNodesHeadless.dir/bench/headless/HeadlessMaya.cpp.o"
+  "CMakeFiles/mathNodesHeadless.dir/bench/headless/HeadlessMaya.cpp.o.d"
+  "CMakeFiles/mathNodesHeadless.dir/bench/headless/Inputs.cpp.o"
+  "CMakeFiles/mathNodesHeadless.dir/bench/headless/Inputs.cpp.o.d"
+  "CMakeFiles/mathNodesHeadless.dir/src/Plugin.cpp.o"
+  "CMakeFiles/mathNodesHeadless.dir/src/Plugin.cpp.o.d"
+  "libmathNodesHeadless.a"
+  "libmathNodesHeadless.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/mathNodesHeadless.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/testCore.dir/tests/core/test_core.cpp.o"
+  "CMakeFiles/testCore.dir/tests/core/test_core.cpp.o.d"
+  "testCore"
+  "testCore.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/testCore.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,12 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo
+# Build directory: /root/repo/_rel
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
+add_test(core "/root/repo/_rel/testCore")
+set_tests_properties(core PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;54;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(headless "/root/repo/_rel/headlessDriver" "--iterations" "10")
+set_tests_properties(headless PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;70;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(bench "/root/repo/_rel/bench" "--min-time" "0" "--repetitions" "1" "--output" "bench.json" "--baseline" "/root/repo/bench/baseline.json" "--allocations-only")
+set_tests_properties(bench PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;74;add_test;/root/repo/CMakeLists.txt;0;")
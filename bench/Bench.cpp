@@ -0,0 +1,504 @@
+// Copyright (c) 2018-2023 Serguei Kalentchouk et al. All rights reserved.
+// Use of this source code is governed by an MIT license that can be found in the LICENSE file.
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "HeadlessMaya.h"
+#include "Inputs.h"
+
+MStatus initializePlugin(MObject pluginObj);
+MStatus uninitializePlugin(MObject pluginObj);
+
+// Allocation counting, every allocation made by the process goes through these operators
+// Only the allocations of the evaluating thread are counted, the background threads of the nodes such as the
+// DebugLog writer run at their own pace and would make the counts depend on timing
+namespace
+{
+thread_local unsigned long long allocationCount = 0u;
+}
+
+void* operator new(size_t size)
+{
+    ++allocationCount;
+
+    void* pointer = std::malloc(size != 0u ? size : 1u);
+    if (pointer == nullptr) throw std::bad_alloc();
+
+    return pointer;
+}
+
+void* operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void* pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer, size_t) noexcept
+{
+    std::free(pointer);
+}
+
+// Node benchmark suite
+// Every registered node type is evaluated through the headless data block, nodes with array inputs
+// are evaluated once per requested element count. Results are written as JSON and can be compared
+// against a stored baseline, in which case the exit code reports regressions.
+namespace
+{
+
+struct Options
+{
+    std::vector<unsigned> sizes = {1u, 16u, 256u};
+    double minTime = 0.01;
+    unsigned repetitions = 5u;
+    const char* filter = nullptr;
+    const char* output = nullptr;
+    const char* baseline = nullptr;
+    double threshold = 0.2;
+    bool allocationsOnly = false;
+    bool fixedInputs = false;
+    std::vector<std::pair<std::string, double>> overrides;
+};
+
+struct Result
+{
+    std::string node;
+    unsigned elements = 0u;
+    double nsPerEval = 0.0;
+    double allocsPerEval = 0.0;
+};
+
+void printUsage()
+{
+    std::printf("Usage: bench [--sizes 1,16,256] [--min-time SECONDS] [--repetitions N] [--filter NAME]\n"
+                "             [--output FILE] [--baseline FILE] [--threshold RATIO] [--allocations-only]\n"
+                "             [--fixed-inputs] [--set ATTRIBUTE=VALUE]...\n");
+}
+
+std::vector<unsigned> parseSizes(const char* text)
+{
+    std::vector<unsigned> out;
+
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ','))
+    {
+        const unsigned size = unsigned(std::strtoul(item.c_str(), nullptr, 10));
+        if (size > 0u)
+        {
+            out.push_back(size);
+        }
+    }
+
+    return out;
+}
+
+bool parseOptions(int argc, char** argv, Options& options)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        const bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--sizes") == 0 && hasValue)
+        {
+            options.sizes = parseSizes(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "--min-time") == 0 && hasValue)
+        {
+            options.minTime = std::strtod(argv[++i], nullptr);
+        }
+        else if (std::strcmp(argv[i], "--repetitions") == 0 && hasValue)
+        {
+            options.repetitions = unsigned(std::strtoul(argv[++i], nullptr, 10));
+        }
+        else if (std::strcmp(argv[i], "--filter") == 0 && hasValue)
+        {
+            options.filter = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--output") == 0 && hasValue)
+        {
+            options.output = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--baseline") == 0 && hasValue)
+        {
+            options.baseline = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--threshold") == 0 && hasValue)
+        {
+            options.threshold = std::strtod(argv[++i], nullptr);
+        }
+        else if (std::strcmp(argv[i], "--allocations-only") == 0)
+        {
+            options.allocationsOnly = true;
+        }
+        else if (std::strcmp(argv[i], "--fixed-inputs") == 0)
+        {
+            options.fixedInputs = true;
+        }
+        else if (std::strcmp(argv[i], "--set") == 0 && hasValue)
+        {
+            const std::string item = argv[++i];
+            const size_t separator = item.find('=');
+            if (separator == std::string::npos) return false;
+
+            options.overrides.emplace_back(item.substr(0u, separator), std::strtod(item.c_str() + separator + 1u, nullptr));
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    return !options.sizes.empty() && options.repetitions > 0u;
+}
+
+bool hasArrayInput(const headless::NodeType& type)
+{
+    for (const MObject& attribute : type.attributes)
+    {
+        const headless::AttributeData& data = *attribute.attribute();
+        if (!data.writable) continue;
+
+        if (data.array) return true;
+        if (data.dataType == MFnData::kDoubleArray || data.dataType == MFnData::kVectorArray ||
+            data.dataType == MFnData::kMatrixArray) return true;
+    }
+
+    return false;
+}
+
+double elapsedSeconds(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Overrides the random value of the scalar inputs named on the command line, such as the mode of a node
+void setOverrides(headless::NodeInstance& instance, const Options& options)
+{
+    for (const auto& item : options.overrides)
+    {
+        for (const MObject& attribute : instance.type().attributes)
+        {
+            const headless::AttributeData& data = *attribute.attribute();
+            if (data.name != item.first || !data.writable || data.array) continue;
+            if (data.kind != headless::AttributeData::kNumeric && data.kind != headless::AttributeData::kEnum) continue;
+
+            instance.dataBlock().find(&data)->numeric[0] = item.second;
+        }
+    }
+}
+
+// Writable attributes of the node type, the ones swapped between the two input sets
+std::vector<MObject> inputAttributes(const headless::NodeType& type)
+{
+    std::vector<MObject> out;
+    for (const MObject& attribute : type.attributes)
+    {
+        if (attribute.attribute()->writable)
+        {
+            out.push_back(attribute);
+        }
+    }
+
+    return out;
+}
+
+bool run(const headless::NodeType& type, unsigned elements, const Options& options, Result& result)
+{
+    headless::NodeInstance instance(type, type.name + "1");
+    const std::vector<MObject> inputs = inputAttributes(type);
+
+    // Unless the inputs are fixed every evaluation swaps in the other set of input values and dirties the inputs,
+    // otherwise the memoized and incremental nodes would only measure the reuse of their previous result
+    std::vector<headless::DataValue> alternate;
+    std::vector<headless::DataValue*> values;
+    std::vector<MPlug> plugs;
+    if (!options.fixedInputs)
+    {
+        headless::setInputs(instance, elements, 1u);
+        setOverrides(instance, options);
+
+        for (const MObject& input : inputs)
+        {
+            headless::DataValue& value = *instance.dataBlock().find(input.attribute());
+            alternate.push_back(std::move(value));
+            value = headless::createValue(*input.attribute());
+
+            values.push_back(&value);
+            plugs.emplace_back(instance.node()->thisMObject(), input);
+        }
+    }
+
+    headless::setInputs(instance, elements);
+    setOverrides(instance, options);
+
+    MPlugArray affected;
+    const auto swapInputs = [&instance, &alternate, &values, &plugs, &affected]()
+    {
+        for (size_t i = 0u; i < alternate.size(); ++i)
+        {
+            std::swap(*values[i], alternate[i]);
+            instance.node()->setDependentsDirty(plugs[i], affected);
+        }
+    };
+
+    const std::vector<MObject> outputs = headless::outputAttributes(type);
+    const auto evaluate = [&instance, &swapInputs, &outputs]() -> bool
+    {
+        swapInputs();
+
+        bool success = true;
+        for (const MObject& output : outputs)
+        {
+            success &= instance.compute(output) == MS::kSuccess;
+        }
+
+        return success;
+    };
+
+    // The first evaluation validates the node and warms up the caches
+    if (!evaluate()) return false;
+
+    // Calibrate the iteration count so that each repetition runs for at least the minimum time
+    unsigned iterations = 1u;
+    for (;;)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        for (unsigned i = 0u; i < iterations; ++i)
+        {
+            evaluate();
+        }
+
+        if (elapsedSeconds(start) >= options.minTime || iterations >= (1u << 24)) break;
+
+        iterations *= 2u;
+    }
+
+    // The swaps are timed on their own and taken out of the samples so that the results compare with fixed inputs
+    double overhead = 0.0;
+    if (!alternate.empty())
+    {
+        const auto start = std::chrono::steady_clock::now();
+        for (unsigned i = 0u; i < iterations; ++i)
+        {
+            swapInputs();
+        }
+
+        overhead = elapsedSeconds(start) * 1.0e9 / iterations;
+    }
+
+    std::vector<double> samples;
+    samples.reserve(options.repetitions);
+
+    const unsigned long long allocationsStart = allocationCount;
+    for (unsigned repetition = 0u; repetition < options.repetitions; ++repetition)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        for (unsigned i = 0u; i < iterations; ++i)
+        {
+            evaluate();
+        }
+
+        samples.push_back(std::max(elapsedSeconds(start) * 1.0e9 / iterations - overhead, 0.0));
+    }
+    const unsigned long long allocations = allocationCount - allocationsStart;
+
+    std::sort(samples.begin(), samples.end());
+
+    result.node = type.name;
+    result.elements = elements;
+    result.nsPerEval = samples[samples.size() / 2u];
+    result.allocsPerEval = double(allocations) / (double(iterations) * options.repetitions);
+
+    return true;
+}
+
+std::string toJson(const std::vector<Result>& results)
+{
+    std::string out = "{\n  \"results\": [\n";
+
+    char buffer[256];
+    for (size_t i = 0u; i < results.size(); ++i)
+    {
+        const Result& result = results[i];
+        std::snprintf(buffer, sizeof(buffer),
+                      "    {\"node\": \"%s\", \"elements\": %u, \"ns_per_eval\": %.2f, \"allocs_per_eval\": %.2f}%s\n",
+                      result.node.c_str(), result.elements, result.nsPerEval, result.allocsPerEval,
+                      i + 1u < results.size() ? "," : "");
+        out += buffer;
+    }
+
+    out += "  ]\n}\n";
+
+    return out;
+}
+
+bool readNumber(const std::string& text, size_t begin, size_t end, const char* key, double& value)
+{
+    const size_t position = text.find(key, begin);
+    if (position == std::string::npos || position >= end) return false;
+
+    const size_t colon = text.find(':', position);
+    if (colon == std::string::npos || colon >= end) return false;
+
+    value = std::strtod(text.c_str() + colon + 1u, nullptr);
+
+    return true;
+}
+
+// Reads the results written by toJson, other JSON layouts are not supported
+std::vector<Result> readBaseline(const char* path)
+{
+    std::vector<Result> out;
+
+    std::ifstream stream(path);
+    if (!stream) return out;
+
+    const std::string text((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+
+    size_t position = 0u;
+    while ((position = text.find("{\"node\"", position)) != std::string::npos)
+    {
+        const size_t end = text.find('}', position);
+        if (end == std::string::npos) break;
+
+        const size_t nameBegin = text.find('"', text.find(':', position)) + 1u;
+        const size_t nameEnd = text.find('"', nameBegin);
+
+        Result result;
+        result.node = text.substr(nameBegin, nameEnd - nameBegin);
+
+        double elements = 0.0;
+        if (readNumber(text, position, end, "\"elements\"", elements) &&
+            readNumber(text, position, end, "\"ns_per_eval\"", result.nsPerEval) &&
+            readNumber(text, position, end, "\"allocs_per_eval\"", result.allocsPerEval))
+        {
+            result.elements = unsigned(elements);
+            out.push_back(result);
+        }
+
+        position = end;
+    }
+
+    return out;
+}
+
+// Returns the number of regressions, timings regress past the threshold ratio while allocations must not grow
+unsigned compare(const std::vector<Result>& results, const std::vector<Result>& baseline, const Options& options)
+{
+    unsigned regressions = 0u;
+    for (const Result& result : results)
+    {
+        const auto it = std::find_if(baseline.begin(), baseline.end(), [&result](const Result& other)
+        {
+            return other.node == result.node && other.elements == result.elements;
+        });
+
+        if (it == baseline.end()) continue;
+
+        if (result.allocsPerEval > it->allocsPerEval + 0.01)
+        {
+            std::printf("REGRESSION %s[%u]: %.2f allocs/eval, baseline %.2f\n",
+                        result.node.c_str(), result.elements, result.allocsPerEval, it->allocsPerEval);
+            ++regressions;
+        }
+
+        if (!options.allocationsOnly && result.nsPerEval > it->nsPerEval * (1.0 + options.threshold))
+        {
+            std::printf("REGRESSION %s[%u]: %.1f ns/eval, baseline %.1f\n",
+                        result.node.c_str(), result.elements, result.nsPerEval, it->nsPerEval);
+            ++regressions;
+        }
+    }
+
+    return regressions;
+}
+
+}
+
+int main(int argc, char** argv)
+{
+    Options options;
+    if (!parseOptions(argc, argv, options))
+    {
+        printUsage();
+        return EXIT_FAILURE;
+    }
+
+    initializePlugin(MObject());
+
+    std::vector<Result> results;
+    unsigned failures = 0u;
+
+    for (const headless::NodeType& type : headless::nodeTypes())
+    {
+        if (options.filter != nullptr && type.name.find(options.filter) == std::string::npos) continue;
+
+        const std::vector<unsigned> sizes = hasArrayInput(type) ? options.sizes : std::vector<unsigned>{1u};
+        for (const unsigned elements : sizes)
+        {
+            Result result;
+            if (!run(type, elements, options, result))
+            {
+                std::fprintf(stderr, "%s failed to compute\n", type.name.c_str());
+                ++failures;
+                continue;
+            }
+
+            results.push_back(result);
+        }
+    }
+
+    uninitializePlugin(MObject());
+
+    const std::string json = toJson(results);
+    if (options.output != nullptr)
+    {
+        std::ofstream stream(options.output);
+        stream << json;
+    }
+    else
+    {
+        std::fputs(json.c_str(), stdout);
+    }
+
+    if (options.baseline != nullptr)
+    {
+        const std::vector<Result> baseline = readBaseline(options.baseline);
+        if (baseline.empty())
+        {
+            std::fprintf(stderr, "Could not read baseline %s\n", options.baseline);
+            return EXIT_FAILURE;
+        }
+
+        const unsigned regressions = compare(results, baseline, options);
+        if (regressions != 0u)
+        {
+            std::printf("%u regression(s) against %s\n", regressions, options.baseline);
+            return EXIT_FAILURE;
+        }
+    }
+
+    return failures == 0u ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,185 @@
+// Copyright (c) 2018-2023 Serguei Kalentchouk et al. All rights reserved.
+// Use of this source code is governed by an MIT license that can be found in the LICENSE file.
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <initializer_list>
+#include <map>
+#include <string>
+
+#include "HeadlessMaya.h"
+#include "Inputs.h"
+
+MStatus initializePlugin(MObject pluginObj);
+MStatus uninitializePlugin(MObject pluginObj);
+
+// Headless driver
+// Instantiates every node type registered by the plugin, fills its inputs and evaluates compute() in a loop
+namespace
+{
+
+struct Options
+{
+    unsigned iterations = 1000u;
+    unsigned elements = 16u;
+    const char* filter = nullptr;
+    bool stats = false;
+    bool profile = false;
+    const char* trace = nullptr;
+};
+
+void printUsage()
+{
+    std::printf("Usage: headlessDriver [--iterations N] [--elements N] [--filter NAME] [--stats] [--profile] [--trace FILE]\n");
+}
+
+bool parseOptions(int argc, char** argv, Options& options)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        const bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--iterations") == 0 && hasValue)
+        {
+            options.iterations = unsigned(std::strtoul(argv[++i], nullptr, 10));
+        }
+        else if (std::strcmp(argv[i], "--elements") == 0 && hasValue)
+        {
+            options.elements = unsigned(std::strtoul(argv[++i], nullptr, 10));
+        }
+        else if (std::strcmp(argv[i], "--filter") == 0 && hasValue)
+        {
+            options.filter = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--stats") == 0)
+        {
+            options.stats = true;
+        }
+        else if (std::strcmp(argv[i], "--profile") == 0)
+        {
+            options.profile = true;
+        }
+        else if (std::strcmp(argv[i], "--trace") == 0 && hasValue)
+        {
+            options.trace = argv[++i];
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    return options.iterations > 0u;
+}
+
+MStatus executeCommand(const char* commandName, std::initializer_list<const char*> flags)
+{
+    MArgList args;
+    for (const char* flag : flags)
+    {
+        args.addArg(flag);
+    }
+
+    return headless::executeCommand(commandName, args);
+}
+
+}
+
+int main(int argc, char** argv)
+{
+    Options options;
+    if (!parseOptions(argc, argv, options))
+    {
+        printUsage();
+        return EXIT_FAILURE;
+    }
+
+    initializePlugin(MObject());
+
+    if (options.stats)
+    {
+        executeCommand("mathNodesStats", {"-enable", "1", "-reset"});
+    }
+
+    if (options.trace != nullptr)
+    {
+        executeCommand("mathNodesTrace", {"-enable", "1", "-clear"});
+    }
+
+    if (options.profile)
+    {
+        executeCommand("mathNodesStats", {"-profileIO", "1"});
+        headless::setProfilerRecording(true);
+    }
+
+    unsigned failures = 0u;
+    for (const headless::NodeType& type : headless::nodeTypes())
+    {
+        if (options.filter != nullptr && type.name.find(options.filter) == std::string::npos) continue;
+
+        headless::NodeInstance instance(type, type.name + "1");
+        headless::setInputs(instance, options.elements);
+
+        const std::vector<MObject> outputs = headless::outputAttributes(type);
+
+        MStatus status;
+        for (const MObject& output : outputs)
+        {
+            status = instance.compute(output);
+            if (status != MS::kSuccess) break;
+        }
+
+        if (status != MS::kSuccess)
+        {
+            std::printf("%-36s failed to compute\n", type.name.c_str());
+            ++failures;
+            continue;
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        for (unsigned iteration = 0u; iteration < options.iterations; ++iteration)
+        {
+            for (const MObject& output : outputs)
+            {
+                instance.compute(output);
+            }
+        }
+        const auto end = std::chrono::steady_clock::now();
+
+        const double nanoseconds = std::chrono::duration<double, std::nano>(end - start).count();
+        std::printf("%-36s %12.1f ns/eval\n", type.name.c_str(), nanoseconds / options.iterations);
+
+        headless::idle();
+    }
+
+    if (options.stats && executeCommand("mathNodesStats", {"-json"}) == MS::kSuccess)
+    {
+        std::printf("%s\n", headless::commandResult()[0].asChar());
+    }
+
+    if (options.trace != nullptr && executeCommand("mathNodesTrace", {"-enable", "0", "-file", options.trace}) != MS::kSuccess)
+    {
+        std::printf("Could not write trace %s\n", options.trace);
+        ++failures;
+    }
+
+    if (options.profile)
+    {
+        headless::setProfilerRecording(false);
+
+        std::map<std::string, unsigned> counts;
+        for (const headless::ProfilerEvent& event : headless::profilerEvents())
+        {
+            counts[headless::profilerCategories()[event.category] + "/" + event.name]++;
+        }
+
+        for (const auto& count : counts)
+        {
+            std::printf("%-48s %8u events\n", count.first.c_str(), count.second);
+        }
+    }
+
+    uninitializePlugin(MObject());
+
+    return failures == 0u ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,1834 @@
+// Copyright (c) 2018-2023 Serguei Kalentchouk et al. All rights reserved.
+// Use of this source code is governed by an MIT license that can be found in the LICENSE file.
+#include "HeadlessMaya.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "../../src/Core.h"
+#include "../../src/core/Interpolate.h"
+#include "../../src/core/Rotation.h"
+
+namespace
+{
+
+struct NodeObject : headless::ObjectData
+{
+    MPxNode* node = nullptr;
+    MDataBlock* dataBlock = nullptr;
+    std::string name;
+};
+
+bool echoMessages = false;
+bool profilerRecording = false;
+double currentFrame = 1.0;
+
+std::vector<std::string>& profilerCategoryNames()
+{
+    static std::vector<std::string> names;
+    return names;
+}
+headless::NodeType* currentNodeType = nullptr;
+
+std::vector<headless::NodeType>& registry()
+{
+    static std::vector<headless::NodeType> types;
+    return types;
+}
+
+struct CommandType
+{
+    std::string name;
+    MCreatorFunction creator = nullptr;
+    MCreateSyntaxFunction createSyntax = nullptr;
+};
+
+std::vector<CommandType>& commandRegistry()
+{
+    static std::vector<CommandType> commands;
+    return commands;
+}
+
+struct DataType
+{
+    std::string name;
+    MTypeId typeId;
+    MCreatorFunction creator = nullptr;
+};
+
+std::vector<DataType>& dataRegistry()
+{
+    static std::vector<DataType> types;
+    return types;
+}
+
+// Flags are declared and passed with a leading dash, they are stored and compared without it
+std::string flagName(const char* flag)
+{
+    if (flag == nullptr) return std::string();
+
+    return flag[0] == '-' ? std::string(flag + 1) : std::string(flag);
+}
+
+struct TimerCallback
+{
+    MCallbackId id;
+    MMessage::MElapsedTimeFunction function;
+    void* clientData;
+};
+
+std::vector<TimerCallback>& timerCallbacks()
+{
+    static std::vector<TimerCallback> callbacks;
+    return callbacks;
+}
+
+// Callback ids are shared by every message class so that removeCallback never removes another callback
+MCallbackId nextCallbackId()
+{
+    static MCallbackId nextId = 1u;
+    return nextId++;
+}
+
+MStringArray& commandResultValues()
+{
+    static MStringArray result;
+    return result;
+}
+
+void echo(const char* prefix, const MString& message)
+{
+    if (echoMessages)
+    {
+        std::printf("%s%s\n", prefix, message.asChar());
+    }
+}
+
+MObject toObject(headless::AttributeData* attribute)
+{
+    return MObject(attribute->shared_from_this());
+}
+
+}
+
+
+// String
+std::string MString::toString(double value)
+{
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%g", value);
+
+    return buffer;
+}
+
+void MGlobal::displayInfo(const MString& message)
+{
+    headless::messageCounts().info++;
+    echo("", message);
+}
+
+void MGlobal::displayWarning(const MString& message)
+{
+    headless::messageCounts().warning++;
+    echo("Warning: ", message);
+}
+
+void MGlobal::displayError(const MString& message)
+{
+    headless::messageCounts().error++;
+    echo("Error: ", message);
+}
+
+
+int MProfiler::addCategory(const char* categoryName, const char*)
+{
+    std::vector<std::string>& names = profilerCategoryNames();
+
+    const auto it = std::find(names.begin(), names.end(), categoryName);
+    if (it != names.end()) return int(it - names.begin());
+
+    names.push_back(categoryName);
+    return int(names.size() - 1u);
+}
+
+void MProfiler::removeCategory(const char* categoryName)
+{
+    std::vector<std::string>& names = profilerCategoryNames();
+
+    // Categories keep their index, the slot is cleared so that the name can be registered again
+    const auto it = std::find(names.begin(), names.end(), categoryName);
+    if (it != names.end()) it->clear();
+}
+
+bool MProfiler::isRecordingActive()
+{
+    return profilerRecording;
+}
+
+int MProfiler::eventBegin(int categoryId, ProfilingColor, const char* eventName, const char*)
+{
+    if (!profilerRecording || categoryId < 0) return -1;
+
+    std::vector<headless::ProfilerEvent>& events = headless::profilerEvents();
+
+    headless::ProfilerEvent event;
+    event.category = categoryId;
+    event.name = eventName != nullptr ? eventName : "";
+    events.push_back(event);
+
+    return int(events.size() - 1u);
+}
+
+void MProfiler::eventEnd(int eventId)
+{
+    std::vector<headless::ProfilerEvent>& events = headless::profilerEvents();
+    if (eventId >= 0 && size_t(eventId) < events.size())
+    {
+        events[eventId].closed = true;
+    }
+}
+
+
+// Vector
+const MVector MVector::zero(0.0, 0.0, 0.0);
+const MVector MVector::one(1.0, 1.0, 1.0);
+const MVector MVector::xAxis(1.0, 0.0, 0.0);
+const MVector MVector::yAxis(0.0, 1.0, 0.0);
+const MVector MVector::zAxis(0.0, 0.0, 1.0);
+const MVector MVector::xNegAxis(-1.0, 0.0, 0.0);
+const MVector MVector::yNegAxis(0.0, -1.0, 0.0);
+const MVector MVector::zNegAxis(0.0, 0.0, -1.0);
+
+MVector MVector::operator*(const MMatrix& matrix) const
+{
+    return MVector(x * matrix[0][0] + y * matrix[1][0] + z * matrix[2][0],
+                   x * matrix[0][1] + y * matrix[1][1] + z * matrix[2][1],
+                   x * matrix[0][2] + y * matrix[1][2] + z * matrix[2][2]);
+}
+
+MVector MVector::operator^(const MVector& other) const
+{
+    return toMaya(core::cross(toCore(*this), toCore(other)));
+}
+
+MVector MVector::normal() const
+{
+    const double len = length();
+    if (len == 0.0) return *this;
+
+    return *this / len;
+}
+
+MStatus MVector::normalize()
+{
+    *this = normal();
+    return MS::kSuccess;
+}
+
+double MVector::angle(const MVector& other) const
+{
+    const double len = length() * other.length();
+    if (len == 0.0) return 0.0;
+
+    return std::acos(std::max(-1.0, std::min((*this * other) / len, 1.0)));
+}
+
+bool MVector::isEquivalent(const MVector& other, double tolerance) const
+{
+    return (*this - other).length() <= tolerance;
+}
+
+bool MVector::isParallel(const MVector& other, double tolerance) const
+{
+    return (normal() ^ other.normal()).length() <= tolerance;
+}
+
+MVector MVector::rotateBy(const MQuaternion& rotation) const
+{
+    return *this * rotation.asMatrix();
+}
+
+MVector MVector::rotateBy(const MEulerRotation& rotation) const
+{
+    return *this * rotation.asMatrix();
+}
+
+
+// Point
+const MPoint MPoint::origin(0.0, 0.0, 0.0, 1.0);
+
+MPoint MPoint::operator*(const MMatrix& matrix) const
+{
+    return MPoint(x * matrix[0][0] + y * matrix[1][0] + z * matrix[2][0] + w * matrix[3][0],
+                  x * matrix[0][1] + y * matrix[1][1] + z * matrix[2][1] + w * matrix[3][1],
+                  x * matrix[0][2] + y * matrix[1][2] + z * matrix[2][2] + w * matrix[3][2],
+                  x * matrix[0][3] + y * matrix[1][3] + z * matrix[2][3] + w * matrix[3][3]);
+}
+
+
+// Matrix
+const MMatrix MMatrix::identity;
+
+MMatrix::MMatrix()
+{
+    setToIdentity();
+}
+
+MMatrix::MMatrix(const double4 value[4])
+{
+    std::copy(&value[0][0], &value[0][0] + 16, &matrix[0][0]);
+}
+
+MMatrix MMatrix::operator+(const MMatrix& other) const
+{
+    MMatrix out;
+    for (unsigned i = 0u; i < 16u; ++i)
+    {
+        out.matrix[i / 4][i % 4] = matrix[i / 4][i % 4] + other.matrix[i / 4][i % 4];
+    }
+
+    return out;
+}
+
+MMatrix MMatrix::operator-(const MMatrix& other) const
+{
+    MMatrix out;
+    for (unsigned i = 0u; i < 16u; ++i)
+    {
+        out.matrix[i / 4][i % 4] = matrix[i / 4][i % 4] - other.matrix[i / 4][i % 4];
+    }
+
+    return out;
+}
+
+MMatrix MMatrix::operator*(const MMatrix& other) const
+{
+    return toMaya(toCore(*this) * toCore(other));
+}
+
+MMatrix MMatrix::operator*(double scale) const
+{
+    MMatrix out;
+    for (unsigned i = 0u; i < 16u; ++i)
+    {
+        out.matrix[i / 4][i % 4] = matrix[i / 4][i % 4] * scale;
+    }
+
+    return out;
+}
+
+bool MMatrix::operator==(const MMatrix& other) const
+{
+    return std::equal(&matrix[0][0], &matrix[0][0] + 16, &other.matrix[0][0]);
+}
+
+MStatus MMatrix::get(double4 out[4]) const
+{
+    std::copy(&matrix[0][0], &matrix[0][0] + 16, &out[0][0]);
+    return MS::kSuccess;
+}
+
+MMatrix& MMatrix::setToIdentity()
+{
+    for (unsigned i = 0u; i < 16u; ++i)
+    {
+        matrix[i / 4][i % 4] = i / 4 == i % 4 ? 1.0 : 0.0;
+    }
+
+    return *this;
+}
+
+MMatrix MMatrix::transpose() const
+{
+    MMatrix out;
+    for (unsigned i = 0u; i < 16u; ++i)
+    {
+        out.matrix[i / 4][i % 4] = matrix[i % 4][i / 4];
+    }
+
+    return out;
+}
+
+MMatrix MMatrix::inverse() const
+{
+    // Gauss-Jordan elimination with partial pivoting
+    double work[4][8];
+    for (unsigned i = 0u; i < 4u; ++i)
+    {
+        for (unsigned j = 0u; j < 4u; ++j)
+        {
+            work[i][j] = matrix[i][j];
+            work[i][j + 4] = i == j ? 1.0 : 0.0;
+        }
+    }
+
+    for (unsigned col = 0u; col < 4u; ++col)
+    {
+        unsigned pivot = col;
+        for (unsigned row = col + 1; row < 4u; ++row)
+        {
+            if (std::abs(work[row][col]) > std::abs(work[pivot][col]))
+            {
+                pivot = row;
+            }
+        }
+
+        if (work[pivot][col] == 0.0) return identity;
+
+        if (pivot != col)
+        {
+            std::swap_ranges(work[pivot], work[pivot] + 8, work[col]);
+        }
+
+        const double scale = 1.0 / work[col][col];
+        for (unsigned j = 0u; j < 8u; ++j)
+        {
+            work[col][j] *= scale;
+        }
+
+        for (unsigned row = 0u; row < 4u; ++row)
+        {
+            if (row == col) continue;
+
+            const double factor = work[row][col];
+            for (unsigned j = 0u; j < 8u; ++j)
+            {
+                work[row][j] -= factor * work[col][j];
+            }
+        }
+    }
+
+    MMatrix out;
+    for (unsigned i = 0u; i < 16u; ++i)
+    {
+        out.matrix[i / 4][i % 4] = work[i / 4][i % 4 + 4];
+    }
+
+    return out;
+}
+
+double MMatrix::det3x3() const
+{
+    return matrix[0][0] * (matrix[1][1] * matrix[2][2] - matrix[1][2] * matrix[2][1]) -
+           matrix[0][1] * (matrix[1][0] * matrix[2][2] - matrix[1][2] * matrix[2][0]) +
+           matrix[0][2] * (matrix[1][0] * matrix[2][1] - matrix[1][1] * matrix[2][0]);
+}
+
+double MMatrix::det4x4() const
+{
+    double out = 0.0;
+    for (unsigned col = 0u; col < 4u; ++col)
+    {
+        MMatrix minor;
+        for (unsigned i = 1u; i < 4u; ++i)
+        {
+            for (unsigned j = 0u, k = 0u; j < 4u; ++j)
+            {
+                if (j == col) continue;
+                minor.matrix[i - 1][k++] = matrix[i][j];
+            }
+        }
+
+        out += (col % 2 == 0 ? 1.0 : -1.0) * matrix[0][col] * minor.det3x3();
+    }
+
+    return out;
+}
+
+bool MMatrix::isEquivalent(const MMatrix& other, double tolerance) const
+{
+    for (unsigned i = 0u; i < 16u; ++i)
+    {
+        if (std::abs(matrix[i / 4][i % 4] - other.matrix[i / 4][i % 4]) > tolerance) return false;
+    }
+
+    return true;
+}
+
+
+// Euler rotation
+const MEulerRotation MEulerRotation::identity;
+
+MEulerRotation MEulerRotation::operator*(const MEulerRotation& other) const
+{
+    return *this * other.asQuaternion();
+}
+
+MEulerRotation MEulerRotation::operator*(const MQuaternion& other) const
+{
+    return decompose((asQuaternion() * other).asMatrix(), order);
+}
+
+MQuaternion MEulerRotation::asQuaternion() const
+{
+    return toMaya(core::toQuaternion(toCore(*this)));
+}
+
+MMatrix MEulerRotation::asMatrix() const
+{
+    return toMaya(core::toMatrix(toCore(*this)));
+}
+
+MEulerRotation MEulerRotation::inverse() const
+{
+    // Negated angles applied in the reverse order
+    static const RotationOrder kReverseOrder[6] = {kZYX, kXZY, kYXZ, kYZX, kZXY, kXYZ};
+
+    return MEulerRotation(-x, -y, -z, kReverseOrder[order]);
+}
+
+MEulerRotation MEulerRotation::reorder(RotationOrder ord) const
+{
+    return decompose(asMatrix(), ord);
+}
+
+MStatus MEulerRotation::reorderIt(RotationOrder ord)
+{
+    *this = reorder(ord);
+    return MS::kSuccess;
+}
+
+bool MEulerRotation::isEquivalent(const MEulerRotation& other, double tolerance) const
+{
+    return order == other.order &&
+           std::abs(x - other.x) <= tolerance &&
+           std::abs(y - other.y) <= tolerance &&
+           std::abs(z - other.z) <= tolerance;
+}
+
+MEulerRotation MEulerRotation::decompose(const MMatrix& matrix, RotationOrder ord)
+{
+    return toMaya(core::toEulerRotation(toCore(matrix), core::RotationOrder(ord)));
+}
+
+
+// Quaternion
+const MQuaternion MQuaternion::identity;
+
+MQuaternion::MQuaternion(double angle, const MVector& axis)
+{
+    const MVector normal = axis.normal() * std::sin(angle * 0.5);
+
+    x = normal.x;
+    y = normal.y;
+    z = normal.z;
+    w = std::cos(angle * 0.5);
+}
+
+MQuaternion::MQuaternion(const MVector& from, const MVector& to)
+{
+    const MVector axis = from ^ to;
+    if (axis.length() == 0.0) return;
+
+    *this = MQuaternion(from.angle(to), axis);
+}
+
+MQuaternion MQuaternion::operator*(const MQuaternion& other) const
+{
+    return toMaya(toCore(*this) * toCore(other));
+}
+
+MMatrix MQuaternion::asMatrix() const
+{
+    return toMaya(core::toMatrix(toCore(*this)));
+}
+
+MEulerRotation MQuaternion::asEulerRotation() const
+{
+    return toMaya(core::toEulerRotation(toCore(*this)));
+}
+
+MQuaternion MQuaternion::inverse() const
+{
+    const double norm = x * x + y * y + z * z + w * w;
+    if (norm == 0.0) return *this;
+
+    return MQuaternion(-x / norm, -y / norm, -z / norm, w / norm);
+}
+
+MQuaternion MQuaternion::normal() const
+{
+    return toMaya(core::normal(toCore(*this)));
+}
+
+MQuaternion MQuaternion::log() const
+{
+    return toMaya(core::log(toCore(*this)));
+}
+
+MQuaternion MQuaternion::exp() const
+{
+    return toMaya(core::exp(toCore(*this)));
+}
+
+bool MQuaternion::isEquivalent(const MQuaternion& other, double tolerance) const
+{
+    return std::abs(x - other.x) <= tolerance &&
+           std::abs(y - other.y) <= tolerance &&
+           std::abs(z - other.z) <= tolerance &&
+           std::abs(w - other.w) <= tolerance;
+}
+
+MQuaternion slerp(const MQuaternion& p, const MQuaternion& q, double t, short spin)
+{
+    return toMaya(core::slerp(toCore(p), toCore(q), t, spin));
+}
+
+
+// Transformation matrix
+MTransformationMatrix::MTransformationMatrix(const MMatrix& matrix)
+{
+    // Gram-Schmidt orthogonalization of the rows, matching the [S] * [Sh] * [R] * [T] composition order
+    MVector row0(matrix[0][0], matrix[0][1], matrix[0][2]);
+    MVector row1(matrix[1][0], matrix[1][1], matrix[1][2]);
+    MVector row2(matrix[2][0], matrix[2][1], matrix[2][2]);
+
+    scale_.x = row0.length();
+    row0 = row0.normal();
+
+    const double xy = row1 * row0;
+    row1 -= row0 * xy;
+    scale_.y = row1.length();
+    row1 = row1.normal();
+
+    const double xz = row2 * row0;
+    const double yz = row2 * row1;
+    row2 -= row0 * xz + row1 * yz;
+    scale_.z = row2.length();
+    row2 = row2.normal();
+
+    if ((row0 ^ row1) * row2 < 0.0)
+    {
+        scale_.z = -scale_.z;
+        row2 = -row2;
+    }
+
+    shear_.x = scale_.y != 0.0 ? xy / scale_.y : 0.0;
+    shear_.y = scale_.z != 0.0 ? xz / scale_.z : 0.0;
+    shear_.z = scale_.z != 0.0 ? yz / scale_.z : 0.0;
+
+    core::Matrix rotation = core::kIdentityMatrix;
+    for (unsigned i = 0u; i < 3u; ++i)
+    {
+        rotation.m[0][i] = row0[i];
+        rotation.m[1][i] = row1[i];
+        rotation.m[2][i] = row2[i];
+    }
+
+    rotation_ = toMaya(core::MatrixToQuaternion(rotation));
+    translation_ = MVector(matrix[3][0], matrix[3][1], matrix[3][2]);
+}
+
+MMatrix MTransformationMatrix::asMatrix() const
+{
+    const core::Transform transform = {toCore(scale_), toCore(shear_), toCore(rotation_), toCore(translation_)};
+    return toMaya(core::compose(transform));
+}
+
+MEulerRotation MTransformationMatrix::eulerRotation() const
+{
+    return MEulerRotation::decompose(rotation_.asMatrix(), MEulerRotation::RotationOrder(rotationOrder_ - 1));
+}
+
+MStatus MTransformationMatrix::getRotation(double3 rotation, RotationOrder& order) const
+{
+    const MEulerRotation euler = eulerRotation();
+    rotation[0] = euler.x;
+    rotation[1] = euler.y;
+    rotation[2] = euler.z;
+    order = rotationOrder_;
+
+    return MS::kSuccess;
+}
+
+MStatus MTransformationMatrix::setRotation(const double3 rotation, RotationOrder order)
+{
+    if (order <= kInvalid || order >= kLast) return MS::kInvalidParameter;
+
+    rotationOrder_ = order;
+    rotation_ = MEulerRotation(rotation[0], rotation[1], rotation[2], MEulerRotation::RotationOrder(order - 1)).asQuaternion();
+
+    return MS::kSuccess;
+}
+
+MTransformationMatrix& MTransformationMatrix::rotateTo(const MEulerRotation& rotation)
+{
+    rotationOrder_ = RotationOrder(rotation.order + 1);
+    rotation_ = rotation.asQuaternion();
+
+    return *this;
+}
+
+MStatus MTransformationMatrix::getScale(double3 scale, MSpace::Space) const
+{
+    return scale_.get(scale);
+}
+
+MStatus MTransformationMatrix::setScale(const double3 scale, MSpace::Space)
+{
+    scale_ = MVector(scale);
+    return MS::kSuccess;
+}
+
+MStatus MTransformationMatrix::getShear(double3 shear, MSpace::Space) const
+{
+    return shear_.get(shear);
+}
+
+MStatus MTransformationMatrix::setShear(const double3 shear, MSpace::Space)
+{
+    shear_ = MVector(shear);
+    return MS::kSuccess;
+}
+
+
+// Objects and plugs
+const MObject MObject::kNullObj;
+
+headless::AttributeData* MObject::attribute() const
+{
+    return static_cast<headless::AttributeData*>(data_.get());
+}
+
+bool MPlug::isChild() const
+{
+    return attribute_.attribute()->parent != nullptr;
+}
+
+bool MPlug::isArray() const
+{
+    return attribute_.attribute()->array && !isElement();
+}
+
+bool MPlug::isCompound() const
+{
+    return !attribute_.attribute()->children.empty();
+}
+
+unsigned MPlug::logicalIndex(MStatus* status) const
+{
+    if (status != nullptr) *status = isElement() ? MS::kSuccess : MS::kFailure;
+
+    return isElement() ? unsigned(logicalIndex_) : 0u;
+}
+
+unsigned MPlug::numElements(MStatus* status) const
+{
+    const NodeObject* node = static_cast<const NodeObject*>(node_.data());
+    const headless::DataValue* value = isArray() && node != nullptr && node->dataBlock != nullptr
+                                           ? node->dataBlock->find(attribute_.attribute()) : nullptr;
+
+    if (status != nullptr) *status = value != nullptr ? MS::kSuccess : MS::kFailure;
+
+    return value != nullptr && value->array != nullptr ? unsigned(value->array->indices.size()) : 0u;
+}
+
+MPlug MPlug::elementByLogicalIndex(unsigned index, MStatus* status) const
+{
+    if (!isArray())
+    {
+        if (status != nullptr) *status = MS::kFailure;
+        return MPlug();
+    }
+
+    MPlug out(node_, attribute_);
+    out.logicalIndex_ = int(index);
+
+    if (status != nullptr) *status = MS::kSuccess;
+
+    return out;
+}
+
+// Physical indices are positions in the array of the node's data block
+MPlug MPlug::elementByPhysicalIndex(unsigned index, MStatus* status) const
+{
+    if (index >= numElements())
+    {
+        if (status != nullptr) *status = MS::kFailure;
+        return MPlug();
+    }
+
+    const NodeObject* node = static_cast<const NodeObject*>(node_.data());
+    return elementByLogicalIndex(node->dataBlock->find(attribute_.attribute())->array->indices[index], status);
+}
+
+MPlug MPlug::parent() const
+{
+    headless::AttributeData* parentAttribute = attribute_.attribute()->parent;
+    if (parentAttribute == nullptr) return MPlug();
+
+    // Children of an element plug belong to that element
+    MPlug out(node_, toObject(parentAttribute));
+    out.logicalIndex_ = logicalIndex_;
+
+    return out;
+}
+
+MString MPlug::partialName() const
+{
+    return MString(attribute_.attribute()->name);
+}
+
+
+bool MEvaluationNode::dirtyPlugExists(const MObject& attribute, MStatus* status) const
+{
+    if (status != nullptr) *status = MS::kSuccess;
+
+    return std::any_of(dirtyPlugs_.begin(), dirtyPlugs_.end(), [&attribute](const MPlug& plug)
+    {
+        return plug.attribute() == attribute;
+    });
+}
+
+
+// Data handles
+MVector MDataHandle::asVector() const
+{
+    if (value_->children.size() >= 3u)
+    {
+        return MVector(value_->children[0].numeric[0], value_->children[1].numeric[0], value_->children[2].numeric[0]);
+    }
+
+    return MVector(value_->numeric[0], value_->numeric[1], value_->numeric[2]);
+}
+
+double3& MDataHandle::asDouble3() const
+{
+    // Numeric compounds keep their children separately, gather them so the values are contiguous
+    if (value_->children.size() >= 3u)
+    {
+        value_->numeric[0] = value_->children[0].numeric[0];
+        value_->numeric[1] = value_->children[1].numeric[0];
+        value_->numeric[2] = value_->children[2].numeric[0];
+    }
+
+    return *reinterpret_cast<double3*>(value_->numeric);
+}
+
+MPxData* MDataHandle::asPluginData() const
+{
+    return MFnPluginData(value_->object).data();
+}
+
+MDataHandle MDataHandle::child(const MObject& attribute) const
+{
+    const headless::AttributeData* childAttribute = attribute.attribute();
+    if (childAttribute->parent != value_->attribute || childAttribute->childIndex >= value_->children.size())
+    {
+        return MDataHandle();
+    }
+
+    return MDataHandle(&value_->children[childAttribute->childIndex]);
+}
+
+void MDataHandle::set(const MVector& value)
+{
+    if (value_->children.size() >= 3u)
+    {
+        value_->children[0].numeric[0] = value.x;
+        value_->children[1].numeric[0] = value.y;
+        value_->children[2].numeric[0] = value.z;
+        return;
+    }
+
+    value_->numeric[0] = value.x;
+    value_->numeric[1] = value.y;
+    value_->numeric[2] = value.z;
+}
+
+void MDataHandle::set(const MMatrix& value)
+{
+    std::copy(&value.matrix[0][0], &value.matrix[0][0] + 16, value_->numeric);
+}
+
+
+// Array data
+MArrayDataBuilder::MArrayDataBuilder(MDataBlock*, const MObject& attribute, unsigned numElements, MStatus* status)
+    : MArrayDataBuilder(attribute, numElements, status)
+{
+}
+
+MArrayDataBuilder::MArrayDataBuilder(const MObject& attribute, unsigned numElements, MStatus* status)
+    : attribute_(attribute.attribute())
+    , storage_(std::make_shared<headless::ArrayStorage>())
+{
+    storage_->elements.reserve(numElements);
+    storage_->indices.reserve(numElements);
+
+    if (status != nullptr) *status = MS::kSuccess;
+}
+
+MDataHandle MArrayDataBuilder::addLast(MStatus* status)
+{
+    const unsigned index = storage_->indices.empty() ? 0u : storage_->indices.back() + 1;
+
+    storage_->elements.push_back(headless::createValue(*attribute_, true));
+    storage_->indices.push_back(index);
+
+    if (status != nullptr) *status = MS::kSuccess;
+
+    return MDataHandle(&storage_->elements.back());
+}
+
+MDataHandle MArrayDataBuilder::addElement(unsigned index, MStatus* status)
+{
+    if (status != nullptr) *status = MS::kSuccess;
+
+    const auto it = std::lower_bound(storage_->indices.begin(), storage_->indices.end(), index);
+    const auto position = it - storage_->indices.begin();
+
+    if (it != storage_->indices.end() && *it == index)
+    {
+        return MDataHandle(&storage_->elements[position]);
+    }
+
+    storage_->indices.insert(it, index);
+    storage_->elements.insert(storage_->elements.begin() + position, headless::createValue(*attribute_, true));
+
+    return MDataHandle(&storage_->elements[position]);
+}
+
+MStatus MArrayDataBuilder::removeElement(unsigned index)
+{
+    const auto it = std::lower_bound(storage_->indices.begin(), storage_->indices.end(), index);
+    if (it == storage_->indices.end() || *it != index) return MS::kInvalidParameter;
+
+    storage_->elements.erase(storage_->elements.begin() + (it - storage_->indices.begin()));
+    storage_->indices.erase(it);
+
+    return MS::kSuccess;
+}
+
+MStatus MArrayDataBuilder::growArray(unsigned amount)
+{
+    storage_->elements.reserve(storage_->elements.size() + amount);
+    storage_->indices.reserve(storage_->indices.size() + amount);
+
+    return MS::kSuccess;
+}
+
+unsigned MArrayDataHandle::elementIndex(MStatus* status) const
+{
+    if (position_ >= elementCount())
+    {
+        if (status != nullptr) *status = MS::kFailure;
+        return 0u;
+    }
+
+    if (status != nullptr) *status = MS::kSuccess;
+
+    return value_->array->indices[position_];
+}
+
+MDataHandle MArrayDataHandle::inputValue(MStatus* status) const
+{
+    if (position_ >= elementCount())
+    {
+        if (status != nullptr) *status = MS::kFailure;
+        return MDataHandle();
+    }
+
+    if (status != nullptr) *status = MS::kSuccess;
+
+    return MDataHandle(&value_->array->elements[position_]);
+}
+
+MDataHandle MArrayDataHandle::outputValue(MStatus* status) const
+{
+    return inputValue(status);
+}
+
+MStatus MArrayDataHandle::next()
+{
+    if (position_ >= elementCount()) return MS::kFailure;
+
+    return ++position_ < elementCount() ? MS::kSuccess : MS::kFailure;
+}
+
+MStatus MArrayDataHandle::jumpToElement(unsigned index)
+{
+    const std::vector<unsigned>& indices = value_->array->indices;
+
+    const auto it = std::lower_bound(indices.begin(), indices.end(), index);
+    if (it == indices.end() || *it != index) return MS::kInvalidParameter;
+
+    position_ = unsigned(it - indices.begin());
+
+    return MS::kSuccess;
+}
+
+MStatus MArrayDataHandle::jumpToArrayElement(unsigned position)
+{
+    if (position >= elementCount()) return MS::kInvalidParameter;
+
+    position_ = position;
+
+    return MS::kSuccess;
+}
+
+MArrayDataBuilder MArrayDataHandle::builder(MStatus* status) const
+{
+    MArrayDataBuilder out;
+    out.attribute_ = value_->attribute;
+    out.storage_ = value_->array;
+
+    if (status != nullptr) *status = MS::kSuccess;
+
+    return out;
+}
+
+MStatus MArrayDataHandle::set(const MArrayDataBuilder& builder)
+{
+    value_->array = builder.storage();
+    position_ = 0u;
+
+    return MS::kSuccess;
+}
+
+void MArrayDataHandle::setAllClean()
+{
+    value_->clean = true;
+    for (headless::DataValue& element : value_->array->elements)
+    {
+        element.clean = true;
+    }
+}
+
+
+// Data block
+MDGContext MDGContext::fsNormal;
+
+MDataBlock::MDataBlock(const std::vector<MObject>& attributes)
+{
+    values_.reserve(attributes.size());
+    for (const MObject& attribute : attributes)
+    {
+        values_.push_back(headless::createValue(*attribute.attribute()));
+    }
+}
+
+MStatus MDataBlock::setClean(const MObject& attribute)
+{
+    headless::DataValue* value = find(attribute.attribute());
+    if (value == nullptr) return MS::kInvalidParameter;
+
+    value->clean = true;
+
+    return MS::kSuccess;
+}
+
+// Element plugs only touch their own element, like Maya a missing element is added with the default value
+MDataHandle MDataBlock::inputValue(const MPlug& plug, MStatus* status)
+{
+    if (!plug.isElement()) return inputValue(plug.attribute(), status);
+
+    headless::DataValue* value = find(plug.attribute().attribute());
+    if (value == nullptr || value->array == nullptr)
+    {
+        if (status != nullptr) *status = MS::kInvalidParameter;
+        return MDataHandle();
+    }
+
+    std::vector<unsigned>& indices = value->array->indices;
+    const auto it = std::lower_bound(indices.begin(), indices.end(), plug.logicalIndex());
+    const size_t position = size_t(it - indices.begin());
+    if (it == indices.end() || *it != plug.logicalIndex())
+    {
+        indices.insert(it, plug.logicalIndex());
+        value->array->elements.insert(value->array->elements.begin() + position, headless::createValue(*value->attribute, true));
+    }
+
+    if (status != nullptr) *status = MS::kSuccess;
+
+    return MDataHandle(&value->array->elements[position]);
+}
+
+headless::DataValue* MDataBlock::find(const headless::AttributeData* attribute)
+{
+    if (attribute->parent == nullptr)
+    {
+        return attribute->index >= 0 && size_t(attribute->index) < values_.size() ? &values_[attribute->index] : nullptr;
+    }
+
+    headless::DataValue* parent = find(attribute->parent);
+    if (parent == nullptr || attribute->childIndex >= parent->children.size()) return nullptr;
+
+    return &parent->children[attribute->childIndex];
+}
+
+
+// Attribute function sets
+MString MFnAttribute::name() const
+{
+    return MString(data()->name);
+}
+
+MStatus MFnAttribute::setKeyable(bool state)
+{
+    data()->keyable = state;
+    return MS::kSuccess;
+}
+
+MStatus MFnAttribute::setStorable(bool state)
+{
+    data()->storable = state;
+    return MS::kSuccess;
+}
+
+MStatus MFnAttribute::setReadable(bool state)
+{
+    data()->readable = state;
+    return MS::kSuccess;
+}
+
+MStatus MFnAttribute::setWritable(bool state)
+{
+    data()->writable = state;
+    return MS::kSuccess;
+}
+
+MStatus MFnAttribute::setArray(bool state)
+{
+    data()->array = state;
+    return MS::kSuccess;
+}
+
+MStatus MFnAttribute::setUsesArrayDataBuilder(bool state)
+{
+    data()->usesArrayDataBuilder = state;
+    return MS::kSuccess;
+}
+
+MStatus MFnAttribute::setChannelBox(bool state)
+{
+    data()->channelBox = state;
+    return MS::kSuccess;
+}
+
+MStatus MFnAttribute::setHidden(bool state)
+{
+    data()->hidden = state;
+    return MS::kSuccess;
+}
+
+bool MFnAttribute::isKeyable() const
+{
+    return data()->keyable;
+}
+
+bool MFnAttribute::isWritable() const
+{
+    return data()->writable;
+}
+
+bool MFnAttribute::isArray() const
+{
+    return data()->array;
+}
+
+MObject MFnAttribute::createAttribute(const MString& fullName, headless::AttributeData::Kind kind)
+{
+    auto attribute = std::make_shared<headless::AttributeData>();
+    attribute->name = fullName.asChar();
+    attribute->kind = kind;
+
+    object_ = MObject(attribute);
+
+    return object_;
+}
+
+MObject MFnNumericAttribute::create(const MString& fullName, const MString&, MFnNumericData::Type type, double defaultValue, MStatus* status)
+{
+    createAttribute(fullName, headless::AttributeData::kNumeric);
+    data()->numericType = type;
+    data()->defaultValue[0] = defaultValue;
+
+    if (status != nullptr) *status = MS::kSuccess;
+
+    return object_;
+}
+
+MObject MFnNumericAttribute::create(const MString& fullName, const MString&, const MObject& child1, const MObject& child2, const MObject& child3, MStatus* status)
+{
+    createAttribute(fullName, headless::AttributeData::kCompound);
+    data()->numericType = MFnNumericData::k3Double;
+
+    MFnCompoundAttribute compoundFn(object_);
+    compoundFn.addChild(child1);
+    compoundFn.addChild(child2);
+    compoundFn.addChild(child3);
+
+    if (status != nullptr) *status = MS::kSuccess;
+
+    return object_;
+}
+
+MStatus MFnNumericAttribute::setMin(double value)
+{
+    data()->hasMin = true;
+    data()->min = value;
+
+    return MS::kSuccess;
+}
+
+MStatus MFnNumericAttribute::setMax(double value)
+{
+    data()->hasMax = true;
+    data()->max = value;
+
+    return MS::kSuccess;
+}
+
+MStatus MFnNumericAttribute::setDefault(double value)
+{
+    data()->defaultValue[0] = value;
+    return MS::kSuccess;
+}
+
+MObject MFnUnitAttribute::create(const MString& fullName, const MString&, const MAngle& defaultValue, MStatus* status)
+{
+    createAttribute(fullName, headless::AttributeData::kUnit);
+    data()->defaultValue[0] = defaultValue.asRadians();
+
+    if (status != nullptr) *status = MS::kSuccess;
+
+    return object_;
+}
+
+MStatus MFnUnitAttribute::setMin(const MAngle& value)
+{
+    data()->hasMin = true;
+    data()->min = value.asRadians();
+
+    return MS::kSuccess;
+}
+
+MStatus MFnUnitAttribute::setMax(const MAngle& value)
+{
+    data()->hasMax = true;
+    data()->max = value.asRadians();
+
+    return MS::kSuccess;
+}
+
+MStatus MFnUnitAttribute::setDefault(const MAngle& value)
+{
+    data()->defaultValue[0] = value.asRadians();
+    return MS::kSuccess;
+}
+
+MObject MFnEnumAttribute::create(const MString& fullName, const MString&, short defaultValue, MStatus* status)
+{
+    createAttribute(fullName, headless::AttributeData::kEnum);
+    data()->numericType = MFnNumericData::kShort;
+    data()->defaultValue[0] = defaultValue;
+
+    if (status != nullptr) *status = MS::kSuccess;
+
+    return object_;
+}
+
+MStatus MFnEnumAttribute::addField(const MString& name, short value)
+{
+    data()->fields.emplace_back(name.asChar(), value);
+    return MS::kSuccess;
+}
+
+MStatus MFnEnumAttribute::setDefault(short value)
+{
+    data()->defaultValue[0] = value;
+    return MS::kSuccess;
+}
+
+MObject MFnMatrixAttribute::create(const MString& fullName, const MString&, Type, MStatus* status)
+{
+    createAttribute(fullName, headless::AttributeData::kMatrix);
+    MMatrix::identity.get(reinterpret_cast<double4*>(data()->defaultValue));
+
+    if (status != nullptr) *status = MS::kSuccess;
+
+    return object_;
+}
+
+MStatus MFnMatrixAttribute::setDefault(const MMatrix& value)
+{
+    return value.get(reinterpret_cast<double4*>(data()->defaultValue));
+}
+
+MObject MFnTypedAttribute::create(const MString& fullName, const MString&, MFnData::Type type, const MObject& defaultValue, MStatus* status)
+{
+    createAttribute(fullName, headless::AttributeData::kTyped);
+    data()->dataType = type;
+    data()->defaultData = defaultValue.sharedData();
+
+    if (status != nullptr) *status = MS::kSuccess;
+
+    return object_;
+}
+
+MObject MFnTypedAttribute::create(const MString& fullName, const MString&, const MTypeId& typeId, const MObject& defaultValue, MStatus* status)
+{
+    createAttribute(fullName, headless::AttributeData::kTyped);
+    data()->dataType = MFnData::kPlugin;
+    data()->pluginTypeId = typeId.id();
+    data()->defaultData = defaultValue.sharedData();
+
+    if (status != nullptr) *status = MS::kSuccess;
+
+    return object_;
+}
+
+MObject MFnCompoundAttribute::create(const MString& fullName, const MString&, MStatus* status)
+{
+    createAttribute(fullName, headless::AttributeData::kCompound);
+
+    if (status != nullptr) *status = MS::kSuccess;
+
+    return object_;
+}
+
+MStatus MFnCompoundAttribute::addChild(const MObject& child)
+{
+    headless::AttributeData* childAttribute = child.attribute();
+    if (childAttribute == nullptr || childAttribute->parent != nullptr) return MS::kInvalidParameter;
+
+    childAttribute->parent = data();
+    childAttribute->childIndex = unsigned(data()->children.size());
+    data()->children.push_back(std::static_pointer_cast<headless::AttributeData>(child.sharedData()));
+
+    return MS::kSuccess;
+}
+
+unsigned MFnCompoundAttribute::numChildren() const
+{
+    return unsigned(data()->children.size());
+}
+
+
+// Nodes
+MStatus MPxNode::addAttribute(const MObject& attribute)
+{
+    if (currentNodeType == nullptr || attribute.isNull()) return MS::kFailure;
+
+    attribute.attribute()->index = int(currentNodeType->attributes.size());
+    currentNodeType->attributes.push_back(attribute);
+
+    return MS::kSuccess;
+}
+
+MStatus MPxNode::attributeAffects(const MObject& whenChanges, const MObject& isAffected)
+{
+    if (whenChanges.isNull() || isAffected.isNull()) return MS::kInvalidParameter;
+
+    whenChanges.attribute()->affects.push_back(isAffected.attribute());
+
+    return MS::kSuccess;
+}
+
+MString MFnDependencyNode::name() const
+{
+    const NodeObject* node = static_cast<const NodeObject*>(object_.data());
+    return node != nullptr ? MString(node->name) : MString();
+}
+
+MStatus MSyntax::addFlag(const char* shortName, const char* longName, MArgType argType)
+{
+    if (shortName == nullptr || longName == nullptr) return MS::kInvalidParameter;
+
+    flags_.push_back({flagName(shortName), flagName(longName), argType});
+
+    return MS::kSuccess;
+}
+
+MArgDatabase::MArgDatabase(const MSyntax& syntax, const MArgList& argList, MStatus* status)
+    : syntax_(syntax)
+{
+    MStatus result = MS::kSuccess;
+    for (unsigned i = 0u; i < argList.length(); ++i)
+    {
+        const std::string arg = flagName(argList.asString(i).asChar());
+        const auto it = std::find_if(syntax_.flags_.begin(), syntax_.flags_.end(), [&arg](const MSyntax::Flag& flag)
+        {
+            return arg == flag.shortName || arg == flag.longName;
+        });
+
+        if (it == syntax_.flags_.end())
+        {
+            result = MS::kInvalidParameter;
+            break;
+        }
+
+        std::string value;
+        if (it->argType != MSyntax::kNoArg)
+        {
+            if (i + 1u >= argList.length())
+            {
+                result = MS::kInvalidParameter;
+                break;
+            }
+
+            value = argList.asString(++i).asChar();
+        }
+
+        values_.emplace_back(it->shortName, value);
+    }
+
+    if (status != nullptr) *status = result;
+}
+
+const std::string* MArgDatabase::find(const char* flag) const
+{
+    const std::string name = flagName(flag);
+    for (const MSyntax::Flag& syntaxFlag : syntax_.flags_)
+    {
+        if (syntaxFlag.shortName != name && syntaxFlag.longName != name) continue;
+
+        for (const auto& value : values_)
+        {
+            if (value.first == syntaxFlag.shortName) return &value.second;
+        }
+    }
+
+    return nullptr;
+}
+
+bool MArgDatabase::isFlagSet(const char* flag, MStatus* status) const
+{
+    if (status != nullptr) *status = MS::kSuccess;
+    return find(flag) != nullptr;
+}
+
+MStatus MArgDatabase::getFlagArgument(const char* flag, unsigned, bool& result) const
+{
+    const std::string* value = find(flag);
+    if (value == nullptr) return MS::kFailure;
+
+    result = *value == "1" || *value == "true" || *value == "on";
+
+    return MS::kSuccess;
+}
+
+MStatus MArgDatabase::getFlagArgument(const char* flag, unsigned, int& result) const
+{
+    const std::string* value = find(flag);
+    if (value == nullptr) return MS::kFailure;
+
+    result = int(std::strtol(value->c_str(), nullptr, 10));
+
+    return MS::kSuccess;
+}
+
+MStatus MArgDatabase::getFlagArgument(const char* flag, unsigned, double& result) const
+{
+    const std::string* value = find(flag);
+    if (value == nullptr) return MS::kFailure;
+
+    result = std::strtod(value->c_str(), nullptr);
+
+    return MS::kSuccess;
+}
+
+MStatus MArgDatabase::getFlagArgument(const char* flag, unsigned, MString& result) const
+{
+    const std::string* value = find(flag);
+    if (value == nullptr) return MS::kFailure;
+
+    result = MString(*value);
+
+    return MS::kSuccess;
+}
+
+void MPxCommand::clearResult()
+{
+    commandResultValues().clear();
+}
+
+void MPxCommand::setResult(bool result)
+{
+    clearResult();
+    appendToResult(result ? "1" : "0");
+}
+
+void MPxCommand::setResult(int result)
+{
+    clearResult();
+    appendToResult(MString(std::to_string(result)));
+}
+
+void MPxCommand::setResult(double result)
+{
+    clearResult();
+    appendToResult(MString() + result);
+}
+
+void MPxCommand::setResult(const MString& result)
+{
+    clearResult();
+    appendToResult(result);
+}
+
+void MPxCommand::setResult(const MStringArray& result)
+{
+    commandResultValues() = result;
+}
+
+void MPxCommand::appendToResult(const MString& result)
+{
+    commandResultValues().append(result);
+}
+
+
+MPxNode* MFnDependencyNode::userNode() const
+{
+    const NodeObject* node = static_cast<const NodeObject*>(object_.data());
+    return node != nullptr ? node->node : nullptr;
+}
+
+MStatus MFnPlugin::registerNode(const MString& typeName,
+                                const MTypeId& typeId,
+                                MCreatorFunction creatorFunction,
+                                MInitializeFunction initFunction,
+                                MPxNode::Type,
+                                const MString*)
+{
+    std::vector<headless::NodeType>& types = registry();
+    for (const headless::NodeType& type : types)
+    {
+        if (type.typeId == typeId.id() || type.name == typeName.asChar()) return MS::kFailure;
+    }
+
+    headless::NodeType type;
+    type.name = typeName.asChar();
+    type.typeId = typeId.id();
+    type.creator = creatorFunction;
+
+    currentNodeType = &type;
+    const MStatus status = initFunction();
+    currentNodeType = nullptr;
+
+    if (status != MS::kSuccess) return status;
+
+    types.push_back(std::move(type));
+
+    return MS::kSuccess;
+}
+
+MStatus MFnPlugin::deregisterNode(const MTypeId& typeId)
+{
+    std::vector<headless::NodeType>& types = registry();
+    const auto it = std::find_if(types.begin(), types.end(), [&typeId](const headless::NodeType& type)
+    {
+        return type.typeId == typeId.id();
+    });
+
+    if (it == types.end()) return MS::kFailure;
+
+    types.erase(it);
+
+    return MS::kSuccess;
+}
+
+MStatus MFnPlugin::registerCommand(const MString& commandName,
+                                   MCreatorFunction creatorFunction,
+                                   MCreateSyntaxFunction createSyntaxFunction)
+{
+    std::vector<CommandType>& commands = commandRegistry();
+    for (const CommandType& other : commands)
+    {
+        if (other.name == commandName.asChar()) return MS::kFailure;
+    }
+
+    CommandType command;
+    command.name = commandName.asChar();
+    command.creator = creatorFunction;
+    command.createSyntax = createSyntaxFunction;
+    commands.push_back(command);
+
+    return MS::kSuccess;
+}
+
+MStatus MFnPlugin::deregisterCommand(const MString& commandName)
+{
+    std::vector<CommandType>& commands = commandRegistry();
+    const auto it = std::find_if(commands.begin(), commands.end(), [&commandName](const CommandType& command)
+    {
+        return command.name == commandName.asChar();
+    });
+
+    if (it == commands.end()) return MS::kFailure;
+
+    commands.erase(it);
+
+    return MS::kSuccess;
+}
+
+MStatus MFnPlugin::registerData(const MString& typeName, const MTypeId& typeId, MCreatorFunction creatorFunction, MPxData::Type)
+{
+    std::vector<DataType>& types = dataRegistry();
+    for (const DataType& other : types)
+    {
+        if (other.typeId == typeId || other.name == typeName.asChar()) return MS::kFailure;
+    }
+
+    DataType type;
+    type.name = typeName.asChar();
+    type.typeId = typeId;
+    type.creator = creatorFunction;
+    types.push_back(type);
+
+    return MS::kSuccess;
+}
+
+MStatus MFnPlugin::deregisterData(const MTypeId& typeId)
+{
+    std::vector<DataType>& types = dataRegistry();
+    const auto it = std::find_if(types.begin(), types.end(), [&typeId](const DataType& type)
+    {
+        return type.typeId == typeId;
+    });
+
+    if (it == types.end()) return MS::kFailure;
+
+    types.erase(it);
+
+    return MS::kSuccess;
+}
+
+MFnPluginData::MFnPluginData(const MObject& object, MStatus* status) : object_(object)
+{
+    if (status != nullptr) *status = data() != nullptr ? MS::kSuccess : MS::kInvalidParameter;
+}
+
+MObject MFnPluginData::create(const MTypeId& typeId, MStatus* status)
+{
+    const std::vector<DataType>& types = dataRegistry();
+    const auto it = std::find_if(types.begin(), types.end(), [&typeId](const DataType& type)
+    {
+        return type.typeId == typeId;
+    });
+
+    if (it == types.end())
+    {
+        if (status != nullptr) *status = MS::kInvalidParameter;
+        return MObject::kNullObj;
+    }
+
+    auto data = std::make_shared<headless::PluginData>();
+    data->data.reset(static_cast<MPxData*>(it->creator()));
+    object_ = MObject(data);
+
+    if (status != nullptr) *status = MS::kSuccess;
+
+    return object_;
+}
+
+MPxData* MFnPluginData::data(MStatus* status) const
+{
+    const auto pluginData = dynamic_cast<headless::PluginData*>(object_.data());
+    if (status != nullptr) *status = pluginData != nullptr ? MS::kSuccess : MS::kInvalidParameter;
+
+    return pluginData != nullptr ? pluginData->data.get() : nullptr;
+}
+
+MTypeId MFnPluginData::typeId(MStatus* status) const
+{
+    const MPxData* pluginData = data(status);
+
+    return pluginData != nullptr ? pluginData->typeId() : MTypeId();
+}
+
+MString MArgList::asString(unsigned index, MStatus* status) const
+{
+    if (status != nullptr) *status = index < values_.size() ? MS::kSuccess : MS::kInvalidParameter;
+
+    return index < values_.size() ? values_[index] : MString();
+}
+
+double MArgList::asDouble(unsigned index, MStatus* status) const
+{
+    if (status != nullptr) *status = index < values_.size() ? MS::kSuccess : MS::kInvalidParameter;
+
+    return index < values_.size() ? std::atof(values_[index].asChar()) : 0.0;
+}
+
+int MArgList::asInt(unsigned index, MStatus* status) const
+{
+    if (status != nullptr) *status = index < values_.size() ? MS::kSuccess : MS::kInvalidParameter;
+
+    return index < values_.size() ? std::atoi(values_[index].asChar()) : 0;
+}
+
+
+MTime MAnimControl::currentTime()
+{
+    return MTime(currentFrame);
+}
+
+MTime MDGContext::getTime(MStatus* status) const
+{
+    if (status != nullptr) *status = MS::kSuccess;
+
+    return MTime(currentFrame);
+}
+
+MStatus MMessage::removeCallback(MCallbackId id)
+{
+    std::vector<TimerCallback>& callbacks = timerCallbacks();
+    const auto it = std::find_if(callbacks.begin(), callbacks.end(), [id](const TimerCallback& callback)
+    {
+        return callback.id == id;
+    });
+
+    if (it == callbacks.end()) return MS::kFailure;
+
+    callbacks.erase(it);
+
+    return MS::kSuccess;
+}
+
+MCallbackId MTimerMessage::addTimerCallback(float, MElapsedTimeFunction func, void* clientData, MStatus* status)
+{
+    const MCallbackId id = nextCallbackId();
+
+    timerCallbacks().push_back({id, func, clientData});
+    if (status != nullptr) *status = MS::kSuccess;
+
+    return id;
+}
+
+MCallbackId MNodeMessage::addNameChangedCallback(MObject&, MNodeStringFunction, void*, MStatus* status)
+{
+    if (status != nullptr) *status = MS::kSuccess;
+
+    return nextCallbackId();
+}
+
+
+namespace headless
+{
+
+DataValue createValue(const AttributeData& attribute, bool isElement)
+{
+    DataValue out;
+    out.attribute = &attribute;
+    std::copy(attribute.defaultValue, attribute.defaultValue + 16, out.numeric);
+    out.object = MObject(attribute.defaultData);
+
+    if (attribute.array && !isElement)
+    {
+        out.array = std::make_shared<ArrayStorage>();
+        return out;
+    }
+
+    out.children.reserve(attribute.children.size());
+    for (const std::shared_ptr<AttributeData>& child : attribute.children)
+    {
+        out.children.push_back(createValue(*child));
+    }
+
+    return out;
+}
+
+const std::vector<NodeType>& nodeTypes()
+{
+    return registry();
+}
+
+NodeInstance::NodeInstance(const NodeType& type, const std::string& name)
+    : type_(type)
+    , dataBlock_(type.attributes)
+{
+    node_ = static_cast<MPxNode*>(type.creator());
+
+    auto object = std::make_shared<NodeObject>();
+    object->node = node_;
+    object->dataBlock = &dataBlock_;
+    object->name = name;
+
+    node_->object_ = MObject(object);
+    node_->name_ = MString(name);
+    node_->postConstructor();
+}
+
+NodeInstance::~NodeInstance()
+{
+    delete node_;
+}
+
+MStatus NodeInstance::compute(const MObject& attribute)
+{
+    return node_->compute(MPlug(node_->object_, attribute), dataBlock_);
+}
+
+MessageCounts& messageCounts()
+{
+    static MessageCounts counts;
+    return counts;
+}
+
+void setEchoMessages(bool state)
+{
+    echoMessages = state;
+}
+
+MStatus executeCommand(const MString& commandName, const MArgList& args)
+{
+    const std::vector<CommandType>& commands = commandRegistry();
+    const auto it = std::find_if(commands.begin(), commands.end(), [&commandName](const CommandType& command)
+    {
+        return command.name == commandName.asChar();
+    });
+
+    if (it == commands.end()) return MS::kNotFound;
+
+    MPxCommand* command = static_cast<MPxCommand*>(it->creator());
+    if (it->createSyntax != nullptr)
+    {
+        command->syntax_ = it->createSyntax();
+    }
+
+    MPxCommand::clearResult();
+    const MStatus status = command->doIt(args);
+    delete command;
+
+    return status;
+}
+
+const MStringArray& commandResult()
+{
+    return commandResultValues();
+}
+
+void idle()
+{
+    const std::vector<TimerCallback> callbacks = timerCallbacks();
+    for (const TimerCallback& callback : callbacks)
+    {
+        callback.function(0.0f, 0.0f, callback.clientData);
+    }
+}
+
+void setCurrentTime(double frame)
+{
+    currentFrame = frame;
+}
+
+void setProfilerRecording(bool state)
+{
+    profilerRecording = state;
+}
+
+std::vector<ProfilerEvent>& profilerEvents()
+{
+    static std::vector<ProfilerEvent> events;
+    return events;
+}
+
+const std::vector<std::string>& profilerCategories()
+{
+    return profilerCategoryNames();
+}
+
+}
@@ -0,0 +1,1493 @@
+// Copyright (c) 2018-2023 Serguei Kalentchouk et al. All rights reserved.
+// Use of this source code is governed by an MIT license that can be found in the LICENSE file.
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+// In-process stand-in for the subset of the Maya API used by the node headers
+// It implements the data access surface (attributes, plugs, data block and handles) on plain buffers
+// and the math types on top of the core library, so that the nodes can be compiled, evaluated
+// and profiled without a Maya installation. It is not a complete or exact emulation of Maya.
+
+typedef double double3[3];
+typedef double double4[4];
+
+class MArgList;
+class MArrayDataBuilder;
+class MDataBlock;
+class MEulerRotation;
+class MMatrix;
+class MObject;
+class MPoint;
+class MPxData;
+class MPxNode;
+class MQuaternion;
+class MStatus;
+class MString;
+class MTime;
+class MVector;
+
+namespace headless
+{
+struct AttributeData;
+struct DataValue;
+struct ObjectData;
+class NodeInstance;
+
+// Executes a command registered through MFnPlugin::registerCommand, the result is available from commandResult
+MStatus executeCommand(const MString& commandName, const MArgList& args);
+}
+
+
+// Status
+class MS
+{
+public:
+    enum MStatusCode
+    {
+        kSuccess = 0,
+        kFailure,
+        kInsufficientMemory,
+        kInvalidParameter,
+        kLicenseFailure,
+        kUnknownParameter,
+        kNotImplemented,
+        kNotFound,
+        kEndOfFile
+    };
+};
+
+class MStatus
+{
+public:
+    MStatus() = default;
+    MStatus(MS::MStatusCode code) : code_(code) {}
+
+    bool operator==(const MStatus& other) const { return code_ == other.code_; }
+    bool operator==(MS::MStatusCode code) const { return code_ == code; }
+    bool operator!=(const MStatus& other) const { return code_ != other.code_; }
+    bool operator!=(MS::MStatusCode code) const { return code_ != code; }
+    operator bool() const { return code_ == MS::kSuccess; }
+
+    MS::MStatusCode statusCode() const { return code_; }
+    void clear() { code_ = MS::kSuccess; }
+
+private:
+    MS::MStatusCode code_ = MS::kSuccess;
+};
+
+
+// String
+class MString
+{
+public:
+    MString() = default;
+    MString(const char* value) : value_(value != nullptr ? value : "") {}
+    MString(const std::string& value) : value_(value) {}
+
+    const char* asChar() const { return value_.c_str(); }
+    unsigned length() const { return unsigned(value_.size()); }
+
+    MString operator+(const MString& other) const { return MString(value_ + other.value_); }
+    MString operator+(const char* other) const { return MString(value_ + other); }
+    MString operator+(double other) const { return MString(value_ + toString(other)); }
+    MString operator+(int other) const { return MString(value_ + std::to_string(other)); }
+    MString operator+(unsigned other) const { return MString(value_ + std::to_string(other)); }
+
+    MString& operator+=(const MString& other) { value_ += other.value_; return *this; }
+    MString& operator+=(const char* other) { value_ += other; return *this; }
+    MString& operator+=(double other) { value_ += toString(other); return *this; }
+    MString& operator+=(int other) { value_ += std::to_string(other); return *this; }
+    MString& operator+=(unsigned other) { value_ += std::to_string(other); return *this; }
+
+    bool operator==(const MString& other) const { return value_ == other.value_; }
+    bool operator!=(const MString& other) const { return value_ != other.value_; }
+
+private:
+    static std::string toString(double value);
+
+    std::string value_;
+};
+
+
+class MGlobal
+{
+public:
+    static void displayInfo(const MString& message);
+    static void displayWarning(const MString& message);
+    static void displayError(const MString& message);
+};
+
+
+// Profiler, events are only recorded while headless::setProfilerRecording is enabled
+class MProfiler
+{
+public:
+    enum ProfilingColor
+    {
+        kColorA_L1, kColorA_L2, kColorA_L3,
+        kColorB_L1, kColorB_L2, kColorB_L3,
+        kColorC_L1, kColorC_L2, kColorC_L3,
+        kColorD_L1, kColorD_L2, kColorD_L3,
+        kColorE_L1, kColorE_L2, kColorE_L3,
+        kColorCount
+    };
+
+    static int addCategory(const char* categoryName, const char* categoryDescription = nullptr);
+    static void removeCategory(const char* categoryName);
+    static bool isRecordingActive();
+
+    static int eventBegin(int categoryId, ProfilingColor colorIndex, const char* eventName, const char* description = nullptr);
+    static void eventEnd(int eventId);
+};
+
+class MProfilingScope
+{
+public:
+    MProfilingScope(int categoryId, MProfiler::ProfilingColor colorIndex, const char* eventName, const char* description = nullptr)
+        : eventId_(MProfiler::eventBegin(categoryId, colorIndex, eventName, description)) {}
+    ~MProfilingScope() { MProfiler::eventEnd(eventId_); }
+
+    MProfilingScope(const MProfilingScope&) = delete;
+    MProfilingScope& operator=(const MProfilingScope&) = delete;
+
+private:
+    int eventId_;
+};
+
+
+class MTypeId
+{
+public:
+    MTypeId() = default;
+    MTypeId(unsigned id) : id_(id) {}
+
+    unsigned id() const { return id_; }
+    bool operator==(const MTypeId& other) const { return id_ == other.id_; }
+    bool operator!=(const MTypeId& other) const { return id_ != other.id_; }
+
+private:
+    unsigned id_ = 0u;
+};
+
+
+class MSpace
+{
+public:
+    enum Space
+    {
+        kInvalid = 0,
+        kTransform = 1,
+        kPreTransform = 2,
+        kPostTransform = 3,
+        kWorld = 4,
+        kObject = kPreTransform,
+        kLast = 5
+    };
+};
+
+
+// Math types
+class MAngle
+{
+public:
+    enum Unit
+    {
+        kInvalid,
+        kRadians,
+        kDegrees,
+        kAngMinutes,
+        kAngSeconds,
+        kLast
+    };
+
+    MAngle() = default;
+    MAngle(double value, Unit unit = kRadians) : radians_(unit == kDegrees ? value * kRadiansPerDegree : value) {}
+
+    double value() const { return radians_; }
+    double as(Unit unit) const { return unit == kDegrees ? asDegrees() : radians_; }
+    double asRadians() const { return radians_; }
+    double asDegrees() const { return radians_ / kRadiansPerDegree; }
+    Unit unit() const { return kRadians; }
+
+    static Unit internalUnit() { return kRadians; }
+    static Unit uiUnit() { return kDegrees; }
+
+private:
+    static constexpr double kRadiansPerDegree = 3.14159265358979323846 / 180.0;
+
+    double radians_ = 0.0;
+};
+
+
+class MVector
+{
+public:
+    MVector() = default;
+    MVector(double xx, double yy, double zz = 0.0) : x(xx), y(yy), z(zz) {}
+    MVector(const double3 value) : x(value[0]), y(value[1]), z(value[2]) {}
+    MVector(const MPoint& point);
+
+    double operator[](unsigned index) const { return index == 0 ? x : (index == 1 ? y : z); }
+    double& operator[](unsigned index) { return index == 0 ? x : (index == 1 ? y : z); }
+
+    MVector operator+(const MVector& other) const { return MVector(x + other.x, y + other.y, z + other.z); }
+    MVector operator-(const MVector& other) const { return MVector(x - other.x, y - other.y, z - other.z); }
+    MVector operator-() const { return MVector(-x, -y, -z); }
+    MVector operator*(double scale) const { return MVector(x * scale, y * scale, z * scale); }
+    MVector operator/(double scale) const { return MVector(x / scale, y / scale, z / scale); }
+    double operator*(const MVector& other) const { return x * other.x + y * other.y + z * other.z; }
+    MVector operator*(const MMatrix& matrix) const;
+    MVector operator^(const MVector& other) const;
+
+    MVector& operator+=(const MVector& other) { x += other.x; y += other.y; z += other.z; return *this; }
+    MVector& operator-=(const MVector& other) { x -= other.x; y -= other.y; z -= other.z; return *this; }
+    MVector& operator*=(double scale) { x *= scale; y *= scale; z *= scale; return *this; }
+    MVector& operator/=(double scale) { x /= scale; y /= scale; z /= scale; return *this; }
+
+    bool operator==(const MVector& other) const { return x == other.x && y == other.y && z == other.z; }
+    bool operator!=(const MVector& other) const { return !(*this == other); }
+
+    double length() const { return std::sqrt(x * x + y * y + z * z); }
+    MVector normal() const;
+    MStatus normalize();
+    double angle(const MVector& other) const;
+    bool isEquivalent(const MVector& other, double tolerance = 1.0e-10) const;
+    bool isParallel(const MVector& other, double tolerance = 1.0e-10) const;
+    MVector rotateBy(const MQuaternion& rotation) const;
+    MVector rotateBy(const MEulerRotation& rotation) const;
+    MStatus get(double3 out) const { out[0] = x; out[1] = y; out[2] = z; return MS::kSuccess; }
+
+    static const MVector zero;
+    static const MVector one;
+    static const MVector xAxis;
+    static const MVector yAxis;
+    static const MVector zAxis;
+    static const MVector xNegAxis;
+    static const MVector yNegAxis;
+    static const MVector zNegAxis;
+
+    double x = 0.0;
+    double y = 0.0;
+    double z = 0.0;
+};
+
+inline MVector operator*(double scale, const MVector& vector)
+{
+    return vector * scale;
+}
+
+
+class MPoint
+{
+public:
+    MPoint() = default;
+    MPoint(double xx, double yy, double zz = 0.0, double ww = 1.0) : x(xx), y(yy), z(zz), w(ww) {}
+    MPoint(const MVector& vector) : x(vector.x), y(vector.y), z(vector.z) {}
+
+    MPoint operator+(const MVector& other) const { return MPoint(x + other.x, y + other.y, z + other.z, w); }
+    MVector operator-(const MPoint& other) const { return MVector(x - other.x, y - other.y, z - other.z); }
+    MPoint operator*(const MMatrix& matrix) const;
+
+    bool operator==(const MPoint& other) const { return x == other.x && y == other.y && z == other.z && w == other.w; }
+
+    double distanceTo(const MPoint& other) const { return (*this - other).length(); }
+
+    static const MPoint origin;
+
+    double x = 0.0;
+    double y = 0.0;
+    double z = 0.0;
+    double w = 1.0;
+};
+
+inline MVector::MVector(const MPoint& point) : x(point.x), y(point.y), z(point.z) {}
+
+
+class MMatrix
+{
+public:
+    MMatrix();
+    MMatrix(const double4 value[4]);
+
+    const double* operator[](unsigned row) const { return matrix[row]; }
+    double* operator[](unsigned row) { return matrix[row]; }
+    double operator()(unsigned row, unsigned col) const { return matrix[row][col]; }
+    double& operator()(unsigned row, unsigned col) { return matrix[row][col]; }
+
+    MMatrix operator+(const MMatrix& other) const;
+    MMatrix operator-(const MMatrix& other) const;
+    MMatrix operator*(const MMatrix& other) const;
+    MMatrix operator*(double scale) const;
+    MMatrix& operator*=(const MMatrix& other) { return *this = *this * other; }
+
+    bool operator==(const MMatrix& other) const;
+    bool operator!=(const MMatrix& other) const { return !(*this == other); }
+
+    MStatus get(double4 out[4]) const;
+    MMatrix& setToIdentity();
+    MMatrix transpose() const;
+    MMatrix inverse() const;
+    double det4x4() const;
+    double det3x3() const;
+    bool isEquivalent(const MMatrix& other, double tolerance = 1.0e-10) const;
+
+    static const MMatrix identity;
+
+    double matrix[4][4];
+};
+
+
+class MEulerRotation
+{
+public:
+    enum RotationOrder
+    {
+        kXYZ,
+        kYZX,
+        kZXY,
+        kXZY,
+        kYXZ,
+        kZYX
+    };
+
+    MEulerRotation() = default;
+    MEulerRotation(double xx, double yy, double zz, RotationOrder ord = kXYZ) : x(xx), y(yy), z(zz), order(ord) {}
+    MEulerRotation(const MVector& vector, RotationOrder ord = kXYZ) : x(vector.x), y(vector.y), z(vector.z), order(ord) {}
+
+    MEulerRotation operator+(const MEulerRotation& other) const { return MEulerRotation(x + other.x, y + other.y, z + other.z, order); }
+    MEulerRotation operator-(const MEulerRotation& other) const { return MEulerRotation(x - other.x, y - other.y, z - other.z, order); }
+    MEulerRotation operator-() const { return MEulerRotation(-x, -y, -z, order); }
+    MEulerRotation operator*(double scale) const { return MEulerRotation(x * scale, y * scale, z * scale, order); }
+    MEulerRotation operator*(const MEulerRotation& other) const;
+    MEulerRotation operator*(const MQuaternion& other) const;
+
+    bool operator==(const MEulerRotation& other) const { return x == other.x && y == other.y && z == other.z && order == other.order; }
+    bool operator!=(const MEulerRotation& other) const { return !(*this == other); }
+
+    MQuaternion asQuaternion() const;
+    MMatrix asMatrix() const;
+    MVector asVector() const { return MVector(x, y, z); }
+    MEulerRotation inverse() const;
+    MEulerRotation reorder(RotationOrder ord) const;
+    MStatus reorderIt(RotationOrder ord);
+    bool isEquivalent(const MEulerRotation& other, double tolerance = 1.0e-10) const;
+
+    static MEulerRotation decompose(const MMatrix& matrix, RotationOrder ord);
+
+    static const MEulerRotation identity;
+
+    double x = 0.0;
+    double y = 0.0;
+    double z = 0.0;
+    RotationOrder order = kXYZ;
+};
+
+
+class MQuaternion
+{
+public:
+    MQuaternion() = default;
+    MQuaternion(double xx, double yy, double zz, double ww) : x(xx), y(yy), z(zz), w(ww) {}
+    MQuaternion(double angle, const MVector& axis);
+    MQuaternion(const MVector& from, const MVector& to);
+
+    MQuaternion operator+(const MQuaternion& other) const { return MQuaternion(x + other.x, y + other.y, z + other.z, w + other.w); }
+    MQuaternion operator-(const MQuaternion& other) const { return MQuaternion(x - other.x, y - other.y, z - other.z, w - other.w); }
+    MQuaternion operator-() const { return MQuaternion(-x, -y, -z, -w); }
+    MQuaternion operator*(const MQuaternion& other) const;
+    MQuaternion& operator*=(const MQuaternion& other) { return *this = *this * other; }
+
+    bool operator==(const MQuaternion& other) const { return x == other.x && y == other.y && z == other.z && w == other.w; }
+    bool operator!=(const MQuaternion& other) const { return !(*this == other); }
+
+    MMatrix asMatrix() const;
+    MEulerRotation asEulerRotation() const;
+    MQuaternion inverse() const;
+    MQuaternion conjugate() const { return MQuaternion(-x, -y, -z, w); }
+    MQuaternion normal() const;
+    MQuaternion& normalizeIt() { return *this = normal(); }
+    MQuaternion log() const;
+    MQuaternion exp() const;
+    bool isEquivalent(const MQuaternion& other, double tolerance = 1.0e-10) const;
+
+    static const MQuaternion identity;
+
+    double x = 0.0;
+    double y = 0.0;
+    double z = 0.0;
+    double w = 1.0;
+};
+
+inline MQuaternion operator*(double scale, const MQuaternion& quaternion)
+{
+    return MQuaternion(quaternion.x * scale, quaternion.y * scale, quaternion.z * scale, quaternion.w * scale);
+}
+
+MQuaternion slerp(const MQuaternion& p, const MQuaternion& q, double t, short spin = 0);
+
+
+class MTransformationMatrix
+{
+public:
+    enum RotationOrder
+    {
+        kInvalid,
+        kXYZ,
+        kYZX,
+        kZXY,
+        kXZY,
+        kYXZ,
+        kZYX,
+        kLast
+    };
+
+    MTransformationMatrix() = default;
+    MTransformationMatrix(const MMatrix& matrix);
+
+    MMatrix asMatrix() const;
+
+    MVector getTranslation(MSpace::Space) const { return translation_; }
+    MStatus setTranslation(const MVector& vector, MSpace::Space) { translation_ = vector; return MS::kSuccess; }
+
+    MQuaternion rotation() const { return rotation_; }
+    MEulerRotation eulerRotation() const;
+    RotationOrder rotationOrder() const { return rotationOrder_; }
+    MStatus getRotation(double3 rotation, RotationOrder& order) const;
+    MStatus setRotation(const double3 rotation, RotationOrder order);
+    MTransformationMatrix& rotateTo(const MQuaternion& rotation) { rotation_ = rotation; return *this; }
+    MTransformationMatrix& rotateTo(const MEulerRotation& rotation);
+
+    MStatus getScale(double3 scale, MSpace::Space space) const;
+    MStatus setScale(const double3 scale, MSpace::Space space);
+    MStatus getShear(double3 shear, MSpace::Space space) const;
+    MStatus setShear(const double3 shear, MSpace::Space space);
+
+private:
+    MVector scale_ = MVector(1.0, 1.0, 1.0);
+    MVector shear_;
+    MQuaternion rotation_;
+    RotationOrder rotationOrder_ = kXYZ;
+    MVector translation_;
+};
+
+
+// Dependency graph objects
+class MObject
+{
+public:
+    MObject() = default;
+    explicit MObject(std::shared_ptr<headless::ObjectData> data) : data_(std::move(data)) {}
+
+    bool isNull() const { return data_ == nullptr; }
+    bool operator==(const MObject& other) const { return data_ == other.data_; }
+    bool operator!=(const MObject& other) const { return data_ != other.data_; }
+
+    headless::ObjectData* data() const { return data_.get(); }
+    const std::shared_ptr<headless::ObjectData>& sharedData() const { return data_; }
+    headless::AttributeData* attribute() const;
+
+    static const MObject kNullObj;
+
+private:
+    std::shared_ptr<headless::ObjectData> data_;
+};
+
+// Handle that tells whether the object it was created from still exists
+class MObjectHandle
+{
+public:
+    MObjectHandle() = default;
+    MObjectHandle(const MObject& object) : data_(object.sharedData()), hashCode_(unsigned(size_t(object.data()))) {}
+
+    bool isValid() const { return !data_.expired(); }
+    bool isAlive() const { return isValid(); }
+    MObject object() const { return MObject(data_.lock()); }
+    unsigned hashCode() const { return hashCode_; }
+
+private:
+    std::weak_ptr<headless::ObjectData> data_;
+    unsigned hashCode_ = 0u;
+};
+
+
+class MFnData
+{
+public:
+    enum Type
+    {
+        kInvalid,
+        kNumeric,
+        kPlugin,
+        kPluginGeometry,
+        kString,
+        kMatrix,
+        kStringArray,
+        kDoubleArray,
+        kFloatArray,
+        kIntArray,
+        kPointArray,
+        kVectorArray,
+        kMatrixArray,
+        kComponentList,
+        kMesh,
+        kLattice,
+        kNurbsCurve,
+        kNurbsSurface,
+        kSphere,
+        kDynArrayAttrs,
+        kDynSweptGeometry,
+        kSubdSurface,
+        kNObject,
+        kNId,
+        kAny,
+        kLast
+    };
+};
+
+class MFnNumericData
+{
+public:
+    enum Type
+    {
+        kInvalid,
+        kBoolean,
+        kByte,
+        kChar,
+        kShort,
+        k2Short,
+        k3Short,
+        kLong,
+        kInt = kLong,
+        k2Long,
+        k2Int = k2Long,
+        k3Long,
+        k3Int = k3Long,
+        kInt64,
+        kFloat,
+        k2Float,
+        k3Float,
+        kDouble,
+        k2Double,
+        k3Double,
+        k4Double,
+        kAddr,
+        kLast
+    };
+};
+
+
+namespace headless
+{
+
+struct ObjectData : std::enable_shared_from_this<ObjectData>
+{
+    virtual ~ObjectData() = default;
+};
+
+// Attribute definition, shared by every instance of a node type
+struct AttributeData : ObjectData
+{
+    enum Kind
+    {
+        kNumeric,
+        kUnit,
+        kEnum,
+        kMatrix,
+        kTyped,
+        kCompound
+    };
+
+    std::string name;
+    Kind kind = kNumeric;
+    MFnNumericData::Type numericType = MFnNumericData::kDouble;
+    MFnData::Type dataType = MFnData::kInvalid;
+    unsigned pluginTypeId = 0u;
+    double defaultValue[16] = {};
+
+    bool keyable = false;
+    bool storable = true;
+    bool readable = true;
+    bool writable = true;
+    bool array = false;
+    bool usesArrayDataBuilder = false;
+    bool channelBox = false;
+    bool hidden = false;
+    bool hasMin = false;
+    bool hasMax = false;
+    double min = 0.0;
+    double max = 0.0;
+
+    std::shared_ptr<ObjectData> defaultData;
+    std::vector<std::pair<std::string, short>> fields;
+    std::vector<std::shared_ptr<AttributeData>> children;
+    AttributeData* parent = nullptr;
+    unsigned childIndex = 0u;
+    int index = -1;
+    std::vector<AttributeData*> affects;
+};
+
+// Geometry data objects are opaque, they are only passed through
+struct GeometryData : ObjectData
+{
+    MFnData::Type type = MFnData::kInvalid;
+};
+
+struct ArrayStorage;
+
+// Value of an attribute in a data block
+// Numeric values are stored in the first element, vectors in the first three and matrices use all sixteen
+struct DataValue
+{
+    const AttributeData* attribute = nullptr;
+    double numeric[16] = {};
+    MObject object;
+    std::vector<DataValue> children;
+    std::shared_ptr<ArrayStorage> array;
+    bool clean = false;
+};
+
+struct ArrayStorage
+{
+    std::vector<DataValue> elements;
+    std::vector<unsigned> indices;
+};
+
+// Creates the value of an attribute initialized to its default, array elements do not hold array storage
+DataValue createValue(const AttributeData& attribute, bool isElement = false);
+
+}
+
+
+class MPlug
+{
+public:
+    MPlug() = default;
+    MPlug(const MObject& node, const MObject& attribute) : node_(node), attribute_(attribute) {}
+
+    bool operator==(const MPlug& other) const { return attribute_ == other.attribute_ && node_ == other.node_ && logicalIndex_ == other.logicalIndex_; }
+    bool operator==(const MObject& attribute) const { return attribute_ == attribute; }
+    bool operator!=(const MPlug& other) const { return !(*this == other); }
+    bool operator!=(const MObject& attribute) const { return !(*this == attribute); }
+
+    bool isNull() const { return attribute_.isNull(); }
+    MObject node() const { return node_; }
+    MObject attribute() const { return attribute_; }
+    bool isChild() const;
+    bool isArray() const;
+    bool isCompound() const;
+    bool isElement() const { return logicalIndex_ >= 0; }
+    unsigned logicalIndex(MStatus* status = nullptr) const;
+    unsigned numElements(MStatus* status = nullptr) const;
+    MPlug elementByLogicalIndex(unsigned index, MStatus* status = nullptr) const;
+    MPlug elementByPhysicalIndex(unsigned index, MStatus* status = nullptr) const;
+    MPlug parent() const;
+    MString partialName() const;
+
+private:
+    MObject node_;
+    MObject attribute_;
+    int logicalIndex_ = -1;
+};
+
+
+class MDataHandle
+{
+public:
+    MDataHandle() = default;
+    explicit MDataHandle(headless::DataValue* value) : value_(value) {}
+
+    bool asBool() const { return value_->numeric[0] != 0.0; }
+    short asShort() const { return short(value_->numeric[0]); }
+    int asInt() const { return int(value_->numeric[0]); }
+    float asFloat() const { return float(value_->numeric[0]); }
+    double asDouble() const { return value_->numeric[0]; }
+    MAngle asAngle() const { return MAngle(value_->numeric[0]); }
+    MVector asVector() const;
+    double3& asDouble3() const;
+    const MMatrix& asMatrix() const { return *reinterpret_cast<const MMatrix*>(value_->numeric); }
+    MObject asMesh() const { return value_->object; }
+    MObject asNurbsCurve() const { return value_->object; }
+    MObject asNurbsSurface() const { return value_->object; }
+    MObject data() const { return value_->object; }
+    MPxData* asPluginData() const;
+
+    MDataHandle child(const MObject& attribute) const;
+
+    void set(bool value) { value_->numeric[0] = value ? 1.0 : 0.0; }
+    void set(short value) { value_->numeric[0] = value; }
+    void set(int value) { value_->numeric[0] = value; }
+    void set(float value) { value_->numeric[0] = value; }
+    void set(double value) { value_->numeric[0] = value; }
+    void set(const MAngle& value) { value_->numeric[0] = value.asRadians(); }
+    void set(const MVector& value);
+    void set3Double(double x, double y, double z) { set(MVector(x, y, z)); }
+    void set(const MMatrix& value);
+    void set(const MObject& value) { value_->object = value; }
+    void setMObject(const MObject& value) { value_->object = value; }
+
+    void setClean() { value_->clean = true; }
+
+    headless::DataValue* value() const { return value_; }
+
+private:
+    headless::DataValue* value_ = nullptr;
+};
+
+static_assert(sizeof(MMatrix) == sizeof(double) * 16, "MMatrix must be layout compatible with the data value storage");
+
+
+class MArrayDataBuilder
+{
+public:
+    MArrayDataBuilder() = default;
+    MArrayDataBuilder(MDataBlock* dataBlock, const MObject& attribute, unsigned numElements, MStatus* status = nullptr);
+    MArrayDataBuilder(const MObject& attribute, unsigned numElements, MStatus* status = nullptr);
+
+    MDataHandle addLast(MStatus* status = nullptr);
+    MDataHandle addElement(unsigned index, MStatus* status = nullptr);
+    MStatus removeElement(unsigned index);
+    MStatus growArray(unsigned amount);
+    MStatus setGrowSize(unsigned) { return MS::kSuccess; }
+    unsigned elementCount() const { return unsigned(storage_->elements.size()); }
+
+    const std::shared_ptr<headless::ArrayStorage>& storage() const { return storage_; }
+
+private:
+    friend class MArrayDataHandle;
+
+    const headless::AttributeData* attribute_ = nullptr;
+    std::shared_ptr<headless::ArrayStorage> storage_;
+};
+
+
+class MArrayDataHandle
+{
+public:
+    MArrayDataHandle() = default;
+    explicit MArrayDataHandle(headless::DataValue* value) : value_(value) {}
+
+    unsigned elementCount() const { return unsigned(value_->array->elements.size()); }
+    unsigned elementIndex(MStatus* status = nullptr) const;
+    MDataHandle inputValue(MStatus* status = nullptr) const;
+    MDataHandle outputValue(MStatus* status = nullptr) const;
+
+    MStatus next();
+    MStatus jumpToElement(unsigned index);
+    MStatus jumpToArrayElement(unsigned position);
+
+    MArrayDataBuilder builder(MStatus* status = nullptr) const;
+    MStatus set(const MArrayDataBuilder& builder);
+
+    void setClean() { value_->clean = true; }
+    void setAllClean();
+
+private:
+    headless::DataValue* value_ = nullptr;
+    unsigned position_ = 0u;
+};
+
+
+// Evaluation context, the headless data block always evaluates in the normal context
+class MDGContext
+{
+public:
+    bool isNormal() const { return true; }
+    MTime getTime(MStatus* status = nullptr) const;
+
+    static MDGContext fsNormal;
+};
+
+
+class MDataBlock
+{
+public:
+    MDataBlock() = default;
+    explicit MDataBlock(const std::vector<MObject>& attributes);
+
+    MDataHandle inputValue(const MObject& attribute, MStatus* = nullptr) { return MDataHandle(find(attribute.attribute())); }
+    MDataHandle inputValue(const MPlug& plug, MStatus* status = nullptr);
+    MDataHandle outputValue(const MObject& attribute, MStatus* = nullptr) { return MDataHandle(find(attribute.attribute())); }
+    MDataHandle outputValue(const MPlug& plug, MStatus* status = nullptr) { return outputValue(plug.attribute(), status); }
+    MArrayDataHandle inputArrayValue(const MObject& attribute, MStatus* = nullptr) { return MArrayDataHandle(find(attribute.attribute())); }
+    MArrayDataHandle outputArrayValue(const MObject& attribute, MStatus* = nullptr) { return MArrayDataHandle(find(attribute.attribute())); }
+
+    MStatus setClean(const MObject& attribute);
+    MStatus setClean(const MPlug& plug) { return setClean(plug.attribute()); }
+
+    MDGContext& context(MStatus* = nullptr) { return MDGContext::fsNormal; }
+
+    headless::DataValue* find(const headless::AttributeData* attribute);
+
+private:
+    std::vector<headless::DataValue> values_;
+};
+
+
+// Attribute function sets
+class MFnAttribute
+{
+public:
+    MFnAttribute() = default;
+    MFnAttribute(const MObject& object) : object_(object) {}
+
+    MStatus setObject(const MObject& object) { object_ = object; return MS::kSuccess; }
+    MObject object() const { return object_; }
+    MString name() const;
+
+    MStatus setKeyable(bool state);
+    MStatus setStorable(bool state);
+    MStatus setReadable(bool state);
+    MStatus setWritable(bool state);
+    MStatus setArray(bool state);
+    MStatus setUsesArrayDataBuilder(bool state);
+    MStatus setChannelBox(bool state);
+    MStatus setHidden(bool state);
+    MStatus setConnectable(bool) { return MS::kSuccess; }
+    MStatus setCached(bool) { return MS::kSuccess; }
+    MStatus setIndexMatters(bool) { return MS::kSuccess; }
+    MStatus setAffectsAppearance(bool) { return MS::kSuccess; }
+
+    bool isKeyable() const;
+    bool isWritable() const;
+    bool isArray() const;
+
+protected:
+    headless::AttributeData* data() const { return object_.attribute(); }
+    MObject createAttribute(const MString& fullName, headless::AttributeData::Kind kind);
+
+    MObject object_;
+};
+
+class MFnNumericAttribute : public MFnAttribute
+{
+public:
+    MFnNumericAttribute() = default;
+    MFnNumericAttribute(const MObject& object) : MFnAttribute(object) {}
+
+    MObject create(const MString& fullName, const MString& briefName, MFnNumericData::Type type, double defaultValue = 0.0, MStatus* status = nullptr);
+    MObject create(const MString& fullName, const MString& briefName, const MObject& child1, const MObject& child2, const MObject& child3, MStatus* status = nullptr);
+
+    MStatus setMin(double value);
+    MStatus setMax(double value);
+    MStatus setDefault(double value);
+};
+
+class MFnUnitAttribute : public MFnAttribute
+{
+public:
+    MFnUnitAttribute() = default;
+    MFnUnitAttribute(const MObject& object) : MFnAttribute(object) {}
+
+    MObject create(const MString& fullName, const MString& briefName, const MAngle& defaultValue, MStatus* status = nullptr);
+
+    MStatus setMin(const MAngle& value);
+    MStatus setMax(const MAngle& value);
+    MStatus setDefault(const MAngle& value);
+};
+
+class MFnEnumAttribute : public MFnAttribute
+{
+public:
+    MFnEnumAttribute() = default;
+    MFnEnumAttribute(const MObject& object) : MFnAttribute(object) {}
+
+    MObject create(const MString& fullName, const MString& briefName, short defaultValue = 0, MStatus* status = nullptr);
+    MStatus addField(const MString& name, short value);
+    MStatus setDefault(short value);
+};
+
+class MFnMatrixAttribute : public MFnAttribute
+{
+public:
+    enum Type
+    {
+        kFloat,
+        kDouble
+    };
+
+    MFnMatrixAttribute() = default;
+    MFnMatrixAttribute(const MObject& object) : MFnAttribute(object) {}
+
+    MObject create(const MString& fullName, const MString& briefName, Type type = kDouble, MStatus* status = nullptr);
+    MStatus setDefault(const MMatrix& value);
+};
+
+class MFnTypedAttribute : public MFnAttribute
+{
+public:
+    MFnTypedAttribute() = default;
+    MFnTypedAttribute(const MObject& object) : MFnAttribute(object) {}
+
+    MObject create(const MString& fullName, const MString& briefName, MFnData::Type type, const MObject& defaultValue = MObject::kNullObj, MStatus* status = nullptr);
+    MObject create(const MString& fullName, const MString& briefName, const MTypeId& typeId, const MObject& defaultValue = MObject::kNullObj, MStatus* status = nullptr);
+};
+
+class MFnCompoundAttribute : public MFnAttribute
+{
+public:
+    MFnCompoundAttribute() = default;
+    MFnCompoundAttribute(const MObject& object) : MFnAttribute(object) {}
+
+    MObject create(const MString& fullName, const MString& briefName, MStatus* status = nullptr);
+    MStatus addChild(const MObject& child);
+    unsigned numChildren() const;
+};
+
+
+// Nodes
+class MPlugArray
+{
+public:
+    MPlugArray() = default;
+
+    unsigned length() const { return unsigned(values_.size()); }
+    MStatus append(const MPlug& value) { values_.push_back(value); return MS::kSuccess; }
+    void clear() { values_.clear(); }
+
+    const MPlug& operator[](unsigned index) const { return values_[index]; }
+
+private:
+    std::vector<MPlug> values_;
+};
+
+
+// Node of the evaluation graph, the headless nodes are only evaluated through compute
+// The dirty plugs are given by the caller to stand in for the evaluation manager
+class MEvaluationNodeIterator
+{
+public:
+    MEvaluationNodeIterator() = default;
+    explicit MEvaluationNodeIterator(const std::vector<MPlug>& plugs) : plugs_(&plugs) {}
+
+    bool isDone() const { return plugs_ == nullptr || position_ >= plugs_->size(); }
+    void next() { ++position_; }
+    void reset() { position_ = 0u; }
+    MPlug plug() const { return (*plugs_)[position_]; }
+
+private:
+    const std::vector<MPlug>* plugs_ = nullptr;
+    size_t position_ = 0u;
+};
+
+class MEvaluationNode
+{
+public:
+    MEvaluationNode() = default;
+    explicit MEvaluationNode(const std::vector<MPlug>& dirtyPlugs) : dirtyPlugs_(dirtyPlugs) {}
+
+    MEvaluationNodeIterator iterator(MStatus* = nullptr) const { return MEvaluationNodeIterator(dirtyPlugs_); }
+    bool dirtyPlugExists(const MObject& attribute, MStatus* = nullptr) const;
+
+private:
+    std::vector<MPlug> dirtyPlugs_;
+};
+
+
+class MPxNode
+{
+public:
+    enum Type
+    {
+        kDependNode,
+        kLast
+    };
+
+    enum class SchedulingType
+    {
+        kParallel,
+        kSerial,
+        kGloballySerial,
+        kUntrusted
+    };
+
+    MPxNode() = default;
+    virtual ~MPxNode() = default;
+
+    virtual void postConstructor() {}
+    virtual MStatus compute(const MPlug&, MDataBlock&) { return MS::kUnknownParameter; }
+    virtual MPlug passThroughToOne(const MPlug&) const { return MPlug(); }
+    virtual MStatus setDependentsDirty(const MPlug&, MPlugArray&) { return MS::kSuccess; }
+    virtual MStatus preEvaluation(const MDGContext&, const MEvaluationNode&) { return MS::kSuccess; }
+    virtual SchedulingType schedulingType() const { return SchedulingType::kSerial; }
+
+    MObject thisMObject() const { return object_; }
+    MString name() const { return name_; }
+
+    static MStatus addAttribute(const MObject& attribute);
+    static MStatus attributeAffects(const MObject& whenChanges, const MObject& isAffected);
+
+private:
+    friend class headless::NodeInstance;
+
+    MObject object_;
+    MString name_;
+};
+
+class MFnDependencyNode
+{
+public:
+    MFnDependencyNode() = default;
+    MFnDependencyNode(const MObject& object) : object_(object) {}
+
+    MString name() const;
+    MPxNode* userNode() const;
+
+private:
+    MObject object_;
+};
+
+
+class MStringArray
+{
+public:
+    MStringArray() = default;
+
+    unsigned length() const { return unsigned(values_.size()); }
+    MStatus append(const MString& value) { values_.push_back(value); return MS::kSuccess; }
+    void clear() { values_.clear(); }
+
+    const MString& operator[](unsigned index) const { return values_[index]; }
+    MString& operator[](unsigned index) { return values_[index]; }
+
+private:
+    std::vector<MString> values_;
+};
+
+
+// Typed array data
+namespace headless
+{
+
+// Arrays returned by the array data function sets reference the values of the data object, other arrays own theirs
+template <typename TType>
+class TypedArray
+{
+public:
+    TypedArray() : values_(std::make_shared<std::vector<TType>>()) {}
+    TypedArray(const TType* values, unsigned count) : values_(std::make_shared<std::vector<TType>>(values, values + count)) {}
+    explicit TypedArray(std::shared_ptr<std::vector<TType>> values) : values_(std::move(values)) {}
+    TypedArray(const TypedArray& other) : values_(std::make_shared<std::vector<TType>>(*other.values_)) {}
+    TypedArray(TypedArray&& other) = default;
+
+    TypedArray& operator=(const TypedArray& other) { *values_ = *other.values_; return *this; }
+    TypedArray& operator=(TypedArray&& other) = default;
+
+    unsigned length() const { return unsigned(values_->size()); }
+    MStatus setLength(unsigned length) { values_->resize(length); return MS::kSuccess; }
+    MStatus append(const TType& value) { values_->push_back(value); return MS::kSuccess; }
+    MStatus clear() { values_->clear(); return MS::kSuccess; }
+    MStatus get(TType* out) const { std::copy(values_->begin(), values_->end(), out); return MS::kSuccess; }
+
+    const TType& operator[](unsigned index) const { return (*values_)[index]; }
+    TType& operator[](unsigned index) { return (*values_)[index]; }
+
+    const std::shared_ptr<std::vector<TType>>& values() const { return values_; }
+
+private:
+    std::shared_ptr<std::vector<TType>> values_;
+};
+
+template <typename TType>
+struct ArrayData : ObjectData
+{
+    MFnData::Type type = MFnData::kInvalid;
+    std::shared_ptr<std::vector<TType>> values = std::make_shared<std::vector<TType>>();
+};
+
+template <typename TArray, typename TType, MFnData::Type TDataType>
+class FnArrayData
+{
+public:
+    FnArrayData() = default;
+    explicit FnArrayData(const MObject& object, MStatus* status = nullptr) : object_(object)
+    {
+        if (status != nullptr) *status = data() != nullptr ? MS::kSuccess : MS::kInvalidParameter;
+    }
+
+    MObject create(MStatus* status = nullptr) { return create(TArray(), status); }
+    MObject create(const TArray& values, MStatus* status = nullptr)
+    {
+        auto data = std::make_shared<ArrayData<TType>>();
+        data->type = TDataType;
+        *data->values = *values.values();
+        object_ = MObject(data);
+
+        if (status != nullptr) *status = MS::kSuccess;
+
+        return object_;
+    }
+
+    unsigned length() const { return data() != nullptr ? unsigned(data()->values->size()) : 0u; }
+
+    TArray array(MStatus* status = nullptr) const
+    {
+        if (status != nullptr) *status = data() != nullptr ? MS::kSuccess : MS::kFailure;
+
+        return data() != nullptr ? TArray(data()->values) : TArray();
+    }
+
+    MStatus set(const TArray& values)
+    {
+        if (data() == nullptr) return MS::kFailure;
+
+        *data()->values = *values.values();
+        return MS::kSuccess;
+    }
+
+    MObject object() const { return object_; }
+
+private:
+    ArrayData<TType>* data() const { return dynamic_cast<ArrayData<TType>*>(object_.data()); }
+
+    MObject object_;
+};
+
+}
+
+class MDoubleArray : public headless::TypedArray<double>
+{
+public:
+    using TypedArray::TypedArray;
+};
+
+class MVectorArray : public headless::TypedArray<MVector>
+{
+public:
+    using TypedArray::TypedArray;
+};
+
+class MMatrixArray : public headless::TypedArray<MMatrix>
+{
+public:
+    using TypedArray::TypedArray;
+};
+
+class MFnDoubleArrayData : public headless::FnArrayData<MDoubleArray, double, MFnData::kDoubleArray>
+{
+public:
+    using FnArrayData::FnArrayData;
+};
+
+class MFnVectorArrayData : public headless::FnArrayData<MVectorArray, MVector, MFnData::kVectorArray>
+{
+public:
+    using FnArrayData::FnArrayData;
+};
+
+class MFnMatrixArrayData : public headless::FnArrayData<MMatrixArray, MMatrix, MFnData::kMatrixArray>
+{
+public:
+    using FnArrayData::FnArrayData;
+};
+
+
+// Plugin data, types are registered through MFnPlugin::registerData
+class MPxData
+{
+public:
+    enum Type
+    {
+        kData,
+        kGeometryData,
+        kLast
+    };
+
+    MPxData() = default;
+    virtual ~MPxData() = default;
+
+    virtual MStatus readASCII(const MArgList&, unsigned&) { return MS::kFailure; }
+    virtual MStatus readBinary(std::istream&, unsigned) { return MS::kFailure; }
+    virtual MStatus writeASCII(std::ostream&) { return MS::kFailure; }
+    virtual MStatus writeBinary(std::ostream&) { return MS::kFailure; }
+
+    virtual void copy(const MPxData& src) = 0;
+    virtual MTypeId typeId() const = 0;
+    virtual MString name() const = 0;
+};
+
+namespace headless
+{
+
+struct PluginData : ObjectData
+{
+    std::unique_ptr<MPxData> data;
+};
+
+}
+
+class MFnPluginData
+{
+public:
+    MFnPluginData() = default;
+    explicit MFnPluginData(const MObject& object, MStatus* status = nullptr);
+
+    MObject create(const MTypeId& typeId, MStatus* status = nullptr);
+    MPxData* data(MStatus* status = nullptr) const;
+    MTypeId typeId(MStatus* status = nullptr) const;
+    MObject object() const { return object_; }
+
+private:
+    MObject object_;
+};
+
+
+// Commands
+class MArgList
+{
+public:
+    MArgList() = default;
+
+    unsigned length() const { return unsigned(values_.size()); }
+    MString asString(unsigned index, MStatus* status = nullptr) const;
+    double asDouble(unsigned index, MStatus* status = nullptr) const;
+    int asInt(unsigned index, MStatus* status = nullptr) const;
+    MStatus addArg(const MString& value) { values_.push_back(value); return MS::kSuccess; }
+
+private:
+    std::vector<MString> values_;
+};
+
+class MSyntax
+{
+public:
+    enum MArgType
+    {
+        kInvalidArgType,
+        kNoArg,
+        kBoolean,
+        kLong,
+        kUnsigned,
+        kDouble,
+        kString,
+        kUnsignedIntType = kUnsigned,
+        kLastArgType
+    };
+
+    MStatus addFlag(const char* shortName, const char* longName, MArgType argType = kNoArg);
+    MStatus enableQuery(bool = true) { return MS::kSuccess; }
+    MStatus enableEdit(bool = true) { return MS::kSuccess; }
+
+private:
+    friend class MArgDatabase;
+
+    struct Flag
+    {
+        std::string shortName;
+        std::string longName;
+        MArgType argType;
+    };
+
+    std::vector<Flag> flags_;
+};
+
+class MArgDatabase
+{
+public:
+    MArgDatabase(const MSyntax& syntax, const MArgList& argList, MStatus* status = nullptr);
+
+    bool isFlagSet(const char* flag, MStatus* status = nullptr) const;
+    MStatus getFlagArgument(const char* flag, unsigned index, bool& result) const;
+    MStatus getFlagArgument(const char* flag, unsigned index, int& result) const;
+    MStatus getFlagArgument(const char* flag, unsigned index, double& result) const;
+    MStatus getFlagArgument(const char* flag, unsigned index, MString& result) const;
+
+private:
+    const std::string* find(const char* flag) const;
+
+    MSyntax syntax_;
+    std::vector<std::pair<std::string, std::string>> values_;
+};
+
+class MPxCommand
+{
+public:
+    MPxCommand() = default;
+    virtual ~MPxCommand() = default;
+
+    virtual MStatus doIt(const MArgList& args) = 0;
+    virtual MStatus undoIt() { return MS::kSuccess; }
+    virtual MStatus redoIt() { return MS::kSuccess; }
+    virtual bool isUndoable() const { return false; }
+
+    MSyntax syntax() const { return syntax_; }
+
+    static void clearResult();
+    static void setResult(bool result);
+    static void setResult(int result);
+    static void setResult(double result);
+    static void setResult(const MString& result);
+    static void setResult(const MStringArray& result);
+    static void appendToResult(const MString& result);
+
+private:
+    friend MStatus headless::executeCommand(const MString&, const MArgList&);
+
+    MSyntax syntax_;
+};
+
+
+typedef void* (*MCreatorFunction)();
+typedef MStatus (*MInitializeFunction)();
+typedef MSyntax (*MCreateSyntaxFunction)();
+
+class MFnPlugin
+{
+public:
+    MFnPlugin() = default;
+    MFnPlugin(const MObject&, const char* = "Unknown", const char* = "Unknown", const char* = "Any", MStatus* = nullptr) {}
+
+    MStatus registerNode(const MString& typeName,
+                         const MTypeId& typeId,
+                         MCreatorFunction creatorFunction,
+                         MInitializeFunction initFunction,
+                         MPxNode::Type type = MPxNode::kDependNode,
+                         const MString* classification = nullptr);
+    MStatus deregisterNode(const MTypeId& typeId);
+    MStatus registerCommand(const MString& commandName,
+                            MCreatorFunction creatorFunction,
+                            MCreateSyntaxFunction createSyntaxFunction = nullptr);
+    MStatus deregisterCommand(const MString& commandName);
+    MStatus registerData(const MString& typeName,
+                         const MTypeId& typeId,
+                         MCreatorFunction creatorFunction,
+                         MPxData::Type type = MPxData::kData);
+    MStatus deregisterData(const MTypeId& typeId);
+};
+
+
+// Time, the current time is set with headless::setCurrentTime
+class MTime
+{
+public:
+    enum Unit
+    {
+        kInvalid,
+        kHours,
+        kMinutes,
+        kSeconds,
+        kMilliseconds,
+        kFilm = 6,
+        kLast
+    };
+
+    MTime() = default;
+    MTime(double value, Unit unit = kFilm) : value_(value), unit_(unit) {}
+
+    double value() const { return value_; }
+    Unit unit() const { return unit_; }
+
+private:
+    double value_ = 0.0;
+    Unit unit_ = kFilm;
+};
+
+class MAnimControl
+{
+public:
+    static MTime currentTime();
+};
+
+
+// Messages, timer callbacks run when headless::idle is called and nodes are never renamed
+typedef size_t MCallbackId;
+
+class MMessage
+{
+public:
+    typedef void (*MElapsedTimeFunction)(float elapsedTime, float lastTime, void* clientData);
+
+    static MStatus removeCallback(MCallbackId id);
+};
+
+class MTimerMessage : public MMessage
+{
+public:
+    static MCallbackId addTimerCallback(float period, MElapsedTimeFunction func, void* clientData = nullptr, MStatus* status = nullptr);
+};
+
+class MNodeMessage : public MMessage
+{
+public:
+    typedef void (*MNodeStringFunction)(MObject& node, const MString& str, void* clientData);
+
+    static MCallbackId addNameChangedCallback(MObject& node, MNodeStringFunction func, void* clientData = nullptr, MStatus* status = nullptr);
+};
+
+
+namespace headless
+{
+
+// Node type registered through MFnPlugin::registerNode
+struct NodeType
+{
+    std::string name;
+    unsigned typeId = 0u;
+    MCreatorFunction creator = nullptr;
+    std::vector<MObject> attributes;
+};
+
+// Registered node types in registration order
+const std::vector<NodeType>& nodeTypes();
+
+// Node instance, owns the user node and its data block
+class NodeInstance
+{
+public:
+    NodeInstance(const NodeType& type, const std::string& name);
+    ~NodeInstance();
+
+    NodeInstance(const NodeInstance&) = delete;
+    NodeInstance& operator=(const NodeInstance&) = delete;
+
+    const NodeType& type() const { return type_; }
+    MPxNode* node() const { return node_; }
+    MDataBlock& dataBlock() { return dataBlock_; }
+
+    MStatus compute(const MObject& attribute);
+
+private:
+    const NodeType& type_;
+    MPxNode* node_ = nullptr;
+    MDataBlock dataBlock_;
+};
+
+// Number of messages sent through MGlobal, the messages themselves are discarded unless echo is enabled
+struct MessageCounts
+{
+    unsigned info = 0u;
+    unsigned warning = 0u;
+    unsigned error = 0u;
+};
+
+MessageCounts& messageCounts();
+void setEchoMessages(bool state);
+
+// Result set by the last command, every value is converted to a string
+const MStringArray& commandResult();
+
+// Profiler event recorded through MProfiler::eventBegin while recording is enabled
+struct ProfilerEvent
+{
+    int category = -1;
+    std::string name;
+    bool closed = false;
+};
+
+// Runs the registered timer callbacks, the stand-in for the Maya idle loop
+void idle();
+
+void setCurrentTime(double frame);
+
+void setProfilerRecording(bool state);
+std::vector<ProfilerEvent>& profilerEvents();
+const std::vector<std::string>& profilerCategories();
+
+}
@@ -0,0 +1,212 @@
+// Copyright (c) 2018-2023 Serguei Kalentchouk et al. All rights reserved.
+// Use of this source code is governed by an MIT license that can be found in the LICENSE file.
+#include "Inputs.h"
+
+#include <cstdint>
+
+namespace headless
+{
+
+namespace
+{
+
+const double kPi = 3.14159265358979323846;
+
+class Random
+{
+public:
+    explicit Random(uint64_t seed) : state_(seed * 0x9e3779b97f4a7c15ull + 1u) {}
+    
+    double uniform(double low, double high)
+    {
+        state_ ^= state_ << 13;
+        state_ ^= state_ >> 7;
+        state_ ^= state_ << 17;
+        
+        return low + (high - low) * double(state_ >> 11) / double(uint64_t(1) << 53);
+    }
+
+private:
+    uint64_t state_;
+};
+
+MMatrix randomMatrix(Random& random)
+{
+    MTransformationMatrix xform;
+    
+    const double3 rotation = {random.uniform(-kPi, kPi), random.uniform(-kPi, kPi), random.uniform(-kPi, kPi)};
+    xform.setRotation(rotation, MTransformationMatrix::kXYZ);
+    
+    const double3 scale = {random.uniform(0.5, 2.0), random.uniform(0.5, 2.0), random.uniform(0.5, 2.0)};
+    xform.setScale(scale, MSpace::kTransform);
+    
+    xform.setTranslation(MVector(random.uniform(-10.0, 10.0), random.uniform(-10.0, 10.0), random.uniform(-10.0, 10.0)),
+                         MSpace::kTransform);
+    
+    return xform.asMatrix();
+}
+
+void setValue(DataValue& value, Random& random)
+{
+    const AttributeData& attribute = *value.attribute;
+    
+    switch (attribute.kind)
+    {
+        case AttributeData::kNumeric:
+        {
+            const double low = attribute.hasMin ? attribute.min : -2.0;
+            const double high = attribute.hasMax ? attribute.max : 2.0;
+            
+            if (attribute.numericType == MFnNumericData::kBoolean)
+            {
+                value.numeric[0] = random.uniform(0.0, 1.0) < 0.5 ? 0.0 : 1.0;
+            }
+            else if (attribute.numericType == MFnNumericData::kInt || attribute.numericType == MFnNumericData::kShort)
+            {
+                // Avoid zero so that the integer division nodes always compute
+                value.numeric[0] = double(int(random.uniform(1.0, 5.0)));
+            }
+            else
+            {
+                value.numeric[0] = random.uniform(low, high);
+            }
+        }
+        break;
+        case AttributeData::kUnit:
+        {
+            const double low = attribute.hasMin ? attribute.min : -kPi;
+            const double high = attribute.hasMax ? attribute.max : kPi;
+            value.numeric[0] = random.uniform(low, high);
+        }
+        break;
+        case AttributeData::kEnum:
+        break;
+        case AttributeData::kMatrix:
+            MDataHandle(&value).set(randomMatrix(random));
+        break;
+        case AttributeData::kTyped:
+        {
+            auto data = std::make_shared<GeometryData>();
+            data->type = attribute.dataType;
+            value.object = MObject(data);
+        }
+        break;
+        case AttributeData::kCompound:
+        {
+            for (DataValue& child : value.children)
+            {
+                setValue(child, random);
+            }
+            
+            // Compounds with four children hold quaternions, keep them normalized
+            if (value.children.size() == 4u)
+            {
+                double length = 0.0;
+                for (const DataValue& child : value.children)
+                {
+                    length += child.numeric[0] * child.numeric[0];
+                }
+                
+                length = std::sqrt(length);
+                for (DataValue& child : value.children)
+                {
+                    child.numeric[0] /= length;
+                }
+            }
+        }
+        break;
+    }
+}
+
+// Typed array data inputs hold the requested number of elements in a single data object
+bool setArrayDataValue(DataValue& value, Random& random, unsigned elements)
+{
+    switch (value.attribute->dataType)
+    {
+        case MFnData::kDoubleArray:
+        {
+            MDoubleArray values;
+            for (unsigned index = 0u; index < elements; ++index)
+            {
+                values.append(random.uniform(0.0, 2.0));
+            }
+            
+            value.object = MFnDoubleArrayData().create(values);
+        }
+        return true;
+        case MFnData::kVectorArray:
+        {
+            MVectorArray values;
+            for (unsigned index = 0u; index < elements; ++index)
+            {
+                values.append(MVector(random.uniform(-2.0, 2.0), random.uniform(-2.0, 2.0), random.uniform(-2.0, 2.0)));
+            }
+            
+            value.object = MFnVectorArrayData().create(values);
+        }
+        return true;
+        case MFnData::kMatrixArray:
+        {
+            MMatrixArray values;
+            for (unsigned index = 0u; index < elements; ++index)
+            {
+                values.append(randomMatrix(random));
+            }
+            
+            value.object = MFnMatrixArrayData().create(values);
+        }
+        return true;
+        case MFnData::kPlugin:
+        {
+            // The layout of plugin data is only known to the plugin, the inputs are left empty
+            value.object = MFnPluginData().create(MTypeId(value.attribute->pluginTypeId));
+        }
+        return true;
+        default:
+        return false;
+    }
+}
+
+}
+
+void setInputs(NodeInstance& instance, unsigned elements, unsigned variant)
+{
+    Random random(uint64_t(instance.type().typeId) | uint64_t(variant) << 32);
+    
+    for (const MObject& object : instance.type().attributes)
+    {
+        const AttributeData& attribute = *object.attribute();
+        if (!attribute.writable) continue;
+        
+        DataValue& value = *instance.dataBlock().find(&attribute);
+        if (!attribute.array)
+        {
+            if (!setArrayDataValue(value, random, elements)) setValue(value, random);
+            continue;
+        }
+        
+        MArrayDataBuilder builder(&instance.dataBlock(), object, elements);
+        for (unsigned index = 0u; index < elements; ++index)
+        {
+            setValue(*builder.addLast().value(), random);
+        }
+        
+        MArrayDataHandle(&value).set(builder);
+    }
+}
+
+std::vector<MObject> outputAttributes(const NodeType& type)
+{
+    std::vector<MObject> out;
+    for (const MObject& attribute : type.attributes)
+    {
+        if (!attribute.attribute()->writable)
+        {
+            out.push_back(attribute);
+        }
+    }
+    
+    return out;
+}
+
+}
@@ -0,0 +1,19 @@
+// Copyright (c) 2018-2023 Serguei Kalentchouk et al. All rights reserved.
+// Use of this source code is governed by an MIT license that can be found in the LICENSE file.
+#pragma once
+
+#include <vector>
+
+#include "HeadlessMaya.h"
+
+namespace headless
+{
+
+// Fills every writable attribute of the node with deterministic pseudo random values
+// Array attributes are filled with the given number of elements, each variant gives another set of values
+void setInputs(NodeInstance& instance, unsigned elements, unsigned variant = 0u);
+
+// Top level attributes of the node type that are not writable
+std::vector<MObject> outputAttributes(const NodeType& type);
+
+}
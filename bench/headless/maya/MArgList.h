@@ -0,0 +1,5 @@
+// Copyright (c) 2018-2023 Serguei Kalentchouk et al. All rights reserved.
+// Use of this source code is governed by an MIT license that can be found in the LICENSE file.
+#pragma once
+
+#include "../HeadlessMaya.h"
@@ -0,0 +1,101 @@
+# Copyright (c) 2018-2023 Serguei Kalentchouk et al. All rights reserved.
+# Use of this source code is governed by an MIT license that can be found in the LICENSE file.
+"""Debug Log Decoder
+
+Reads the binary files written by DebugLog nodes set to log to file, see mathNodesDebugLog -file.
+The module has no Maya dependency and can be run offline:
+
+    python debug_log.py trace.bin
+"""
+import collections
+import struct
+import sys
+
+Record = collections.namedtuple('Record', ['node', 'frame', 'type', 'value'])
+
+DoubleType = 0
+IntType = 1
+AngleType = 2
+VectorType = 3
+RotationType = 4
+QuaternionType = 5
+MatrixType = 6
+
+_magic = b'MMNDLOG\0'
+_version = 1
+_value_counts = {DoubleType: 1, AngleType: 1, VectorType: 3, RotationType: 3, QuaternionType: 4, MatrixType: 16}
+
+
+class DecodingError(Exception):
+    """Decoding exception raised for malformed debug log files"""
+    pass
+
+
+def _read(stream, fmt):
+    size = struct.calcsize(fmt)
+    data = stream.read(size)
+    if len(data) != size:
+        raise DecodingError('Unexpected end of file')
+
+    return struct.unpack(fmt, data)
+
+
+def read_records(stream):
+    """Read debug log records
+
+    Args:
+        stream (file): Binary stream positioned at the start of a debug log file
+
+    Returns:
+        generator: Yields a Record for every logged value, scalar values are returned as is and
+        compound values as tuples, angles are in radians
+    """
+    if stream.read(len(_magic)) != _magic:
+        raise DecodingError('Not a debug log file')
+
+    version, = _read(stream, '<I')
+    if version != _version:
+        raise DecodingError('Unsupported debug log version {0}'.format(version))
+
+    names = {}
+    while True:
+        kind = stream.read(1)
+        if not kind:
+            return
+
+        kind = ord(kind)
+        if kind == 0:
+            node_id, length = _read(stream, '<IH')
+            names[node_id] = stream.read(length).decode('utf-8')
+        elif kind == 1:
+            node_id, frame, value_type = _read(stream, '<IdB')
+            if value_type == IntType:
+                value, = _read(stream, '<i')
+            elif value_type in _value_counts:
+                value = _read(stream, '<{0}d'.format(_value_counts[value_type]))
+                if len(value) == 1:
+                    value = value[0]
+            else:
+                raise DecodingError('Unknown value type {0}'.format(value_type))
+
+            yield Record(names.get(node_id, str(node_id)), frame, value_type, value)
+        else:
+            raise DecodingError('Unknown record kind {0}'.format(kind))
+
+
+def read_file(path):
+    """Read all records of a debug log file
+
+    Args:
+        path (str): Debug log file path
+
+    Returns:
+        list: Returns the list of records in file order
+    """
+    with open(path, 'rb') as stream:
+        return list(read_records(stream))
+
+
+if __name__ == '__main__':
+    for record in read_file(sys.argv[1]):
+        print('{0} {1:g}: {2}'.format(record.node, record.frame, record.value))
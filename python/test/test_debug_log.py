@@ -0,0 +1,24 @@
+# Copyright (c) 2018-2023 Serguei Kalentchouk et al. All rights reserved.
+# Use of this source code is governed by an MIT license that can be found in the LICENSE file.
+import io
+import struct
+import unittest
+
+import maya_math_nodes.debug_log as debug_log
+
+
+class TestDebugLog(unittest.TestCase):
+    def test_read_records(self):
+        data = b'MMNDLOG\0' + struct.pack('<I', 1)
+        data += struct.pack('<BIH', 0, 0, 9) + b'debugLog1'
+        data += struct.pack('<BIdB', 1, 0, 1.0, debug_log.IntType) + struct.pack('<i', 3)
+        data += struct.pack('<BIdB', 1, 0, 2.0, debug_log.VectorType) + struct.pack('<3d', 1.0, 2.0, 3.0)
+        
+        records = list(debug_log.read_records(io.BytesIO(data)))
+        self.assertEqual(len(records), 2)
+        self.assertEqual(records[0], debug_log.Record('debugLog1', 1.0, debug_log.IntType, 3))
+        self.assertEqual(records[1].value, (1.0, 2.0, 3.0))
+    
+    def test_invalid_file(self):
+        with self.assertRaises(debug_log.DecodingError):
+            list(debug_log.read_records(io.BytesIO(b'invalid')))
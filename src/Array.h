@@ -3,407 +3,966 @@
 #pragma once
 
 #include <algorithm>
-#include <numeric>
+#include <atomic>
+#include <cstring>
+#include <utility>
+#include <vector>
 
+#include <maya/MEvaluationNode.h>
+#include <maya/MPlugArray.h>
+
+#include "core/Array.h"
+#include "core/Interpolate.h"
+#include "core/Rotation.h"
+#include "Core.h"
 #include "Utils.h"
 
+// Scratch storage owned by the array nodes, kept between evaluations so the kernels do not allocate
 template<typename TType>
-inline TType sum(const std::vector<TType>& values)
+struct ArrayScratch
 {
-    if (values.empty()) return DefaultValue<TType>();
-    
-    return std::accumulate(values.begin(), values.end(), DefaultValue<TType>(),
-                           [](const TType& a, const TType& b){ return a + b; });
-}
+    std::vector<decltype(toCore(std::declval<TType>()))> values;
+};
 
-template<typename TInType, typename TOutType>
-inline TOutType average(const std::vector<TInType>& values)
+// Matrices are kept with their average terms so that unchanged matrices are not decomposed again
+template<>
+struct ArrayScratch<MMatrix>
 {
-    if (values.empty()) return DefaultValue<TOutType>();
-    
-    TInType sum = std::accumulate(values.begin(), values.end(), DefaultValue<TInType>(),
-                                  [](const TInType& a, const TInType& b){ return a + b; });
-    return TOutType(sum / int(values.size()));
+    std::vector<MMatrix> matrices;
+    std::vector<core::Transform> terms;
+};
+
+// Unweighted average term of a matrix, the log of its scale and rotation along with its shear and translation
+inline core::Transform averageTerm(const MMatrix& value)
+{
+    return core::averageTerm(core::decompose(toCore(value)), 1.0);
 }
 
-template<typename TInType, typename TOutType>
-inline TOutType average(const std::vector<TInType>& values, const std::vector<double>& weights)
+// Updates the average terms of the matrices that are not bit-identical to the previous evaluation
+template<typename TArray>
+inline void updateAverageTerms(const TArray& values, size_t count, ArrayScratch<MMatrix>& scratch)
 {
-    if (values.empty() || weights.empty()) return DefaultValue<TOutType>();
+    const size_t cached = std::min(count, scratch.matrices.size());
     
-    const double weightSum = std::accumulate(weights.begin(), weights.end(), 0.0);
-    if (almostEquals(weightSum, 0.0)) return DefaultValue<TOutType>();
+    scratch.matrices.resize(count);
+    scratch.terms.resize(count);
     
-    auto sum = DefaultValue<TInType>();
-    for (unsigned i = 0u; i < values.size(); ++i)
+    for (size_t index = 0u; index < count; ++index)
+    {
+        const MMatrix& value = values[unsigned(index)];
+        if (index < cached && std::memcmp(&scratch.matrices[index], &value, sizeof(MMatrix)) == 0) continue;
+        
+        scratch.matrices[index] = value;
+        scratch.terms[index] = averageTerm(value);
+    }
+}
+
+inline MMatrix averageFromTerms(const ArrayScratch<MMatrix>& scratch)
+{
+    const core::Transform total = core::sum(scratch.terms.data(), scratch.terms.size());
+    return toMaya(core::averageFromTerms(total, double(scratch.terms.size())));
+}
+
+inline MMatrix averageFromTerms(const ArrayScratch<MMatrix>& scratch, const double* weights)
+{
+    core::Transform total = core::Transform();
+    for (size_t index = 0u; index < scratch.terms.size(); ++index)
     {
-        sum = sum + values[i] * weights[i];
+        total = total + scratch.terms[index] * weights[index];
     }
     
-    return TOutType(sum / weightSum);
+    return toMaya(core::averageFromTerms(total, core::sum(weights, scratch.terms.size())));
+}
+
+// Map kernels write into the node owned output buffer
+inline void normalize(const std::vector<double>& values, std::vector<double>& out)
+{
+    out.resize(values.size());
+    core::normalize(values.data(), values.size(), out.data());
+}
+
+inline void clamp(const std::vector<double>& values, std::vector<double>& out)
+{
+    out.resize(values.size());
+    core::clamp(values.data(), values.size(), out.data());
+}
+
+inline void normalizeWeights(const std::vector<double>& values, std::vector<double>& out)
+{
+    out.resize(values.size());
+    core::normalizeWeights(values.data(), values.size(), out.data());
+}
+
+template<typename TType>
+TType min_array_element(const std::vector<TType>& values, ArrayScratch<TType>&)
+{
+    return core::minElement(values.data(), values.size());
 }
 
 template<>
-inline double average(const std::vector<int>& values)
+MAngle min_array_element(const std::vector<MAngle>& values, ArrayScratch<MAngle>& scratch)
 {
-    if (values.empty()) return 0.0;
-    
-    const int sum = std::accumulate(values.begin(), values.end(), 0);
-    return double(sum) / values.size();
+    toCore(values, scratch.values);
+    return MAngle(core::minElement(scratch.values.data(), scratch.values.size()));
+}
+
+template<typename TType>
+TType max_array_element(const std::vector<TType>& values, ArrayScratch<TType>&)
+{
+    return core::maxElement(values.data(), values.size());
 }
 
 template<>
-inline double average(const std::vector<int>& values, const std::vector<double>& weights)
+MAngle max_array_element(const std::vector<MAngle>& values, ArrayScratch<MAngle>& scratch)
 {
-    if (values.empty() || weights.empty()) return 0.0;
-    
-    const double weightSum = std::accumulate(weights.begin(), weights.end(), 0.0);
-    if (almostEquals(weightSum, 0.0)) return 0.0;
+    toCore(values, scratch.values);
+    return MAngle(core::maxElement(scratch.values.data(), scratch.values.size()));
+}
+
+
+// Reductions that can be updated one element at a time
+// Each element maps to a term, the output is computed from the sum of the terms and the sum of the weights
+// The unit term of an element does not depend on its weight, it is kept per element and reused while the
+// value of the element does not change
+template<typename TInType, typename TOutType>
+struct SumReduction
+{
+    typedef decltype(toCore(std::declval<TInType>())) Term;
     
-    double sum = 0.0;
-    for (unsigned i = 0u; i < values.size(); ++i)
-    {
-        sum = sum + values[i] * weights[i];
-    }
+    static Term unitTerm(const TInType& value) { return toCore(value); }
+    static Term term(const Term& unitTerm, double) { return unitTerm; }
+    static TOutType result(const Term& total, double);
+};
+
+template<>
+inline double SumReduction<double, double>::result(const double& total, double) { return total; }
+
+template<>
+inline int SumReduction<int, int>::result(const int& total, double) { return total; }
+
+template<>
+inline MAngle SumReduction<MAngle, MAngle>::result(const double& total, double) { return MAngle(total); }
+
+template<>
+inline MVector SumReduction<MVector, MVector>::result(const core::Vector& total, double) { return toMaya(total); }
+
+template<typename TInType, typename TOutType>
+struct AverageReduction
+{
+    typedef decltype(core::averageTerm(toCore(std::declval<TInType>()), 1.0)) Term;
     
-    return sum / weightSum;
+    static Term unitTerm(const TInType& value) { return core::averageTerm(toCore(value), 1.0); }
+    static Term term(const Term& unitTerm, double weight) { return unitTerm * weight; }
+    static TOutType result(const Term& total, double totalWeight);
+};
+
+template<>
+inline double AverageReduction<double, double>::result(const double& total, double totalWeight)
+{
+    return core::averageFromTerms(total, totalWeight);
+}
+
+template<>
+inline double AverageReduction<int, double>::result(const double& total, double totalWeight)
+{
+    return core::averageFromTerms(total, totalWeight);
+}
+
+template<>
+inline MAngle AverageReduction<MAngle, MAngle>::result(const double& total, double totalWeight)
+{
+    return MAngle(core::averageFromTerms(total, totalWeight));
+}
+
+template<>
+inline MVector AverageReduction<MVector, MVector>::result(const core::Vector& total, double totalWeight)
+{
+    return toMaya(core::averageFromTerms(total, totalWeight));
+}
+
+template<>
+inline MEulerRotation AverageReduction<MEulerRotation, MEulerRotation>::result(const core::Quaternion& total,
+                                                                              double totalWeight)
+{
+    return toMaya(core::toEulerRotation(core::averageFromTerms(total, totalWeight)));
+}
+
+template<>
+inline MQuaternion AverageReduction<MQuaternion, MQuaternion>::result(const core::Quaternion& total, double totalWeight)
+{
+    return toMaya(core::averageFromTerms(total, totalWeight));
 }
 
 template<>
-inline MEulerRotation average(const std::vector<MEulerRotation>& values)
+struct AverageReduction<MMatrix, MMatrix>
 {
-    if (values.empty()) return MEulerRotation::identity;
+    typedef core::Transform Term;
     
-    MQuaternion sum;
-    for (const auto& rotation : values)
+    static Term unitTerm(const MMatrix& value) { return averageTerm(value); }
+    static Term term(const Term& unitTerm, double weight) { return unitTerm * weight; }
+    static MMatrix result(const Term& total, double totalWeight) { return toMaya(core::averageFromTerms(total, totalWeight)); }
+};
+
+// Totals of a reduction computed from scratch, used by evaluations that must not touch the incremental totals
+template<typename TInType, typename TReduction>
+class ReductionAccumulator
+{
+public:
+    typedef typename TReduction::Term Term;
+    
+    void add(unsigned, const TInType& value, double weight)
     {
-        sum = sum + rotation.asQuaternion().log();
+        terms_.push_back(TReduction::term(TReduction::unitTerm(value), weight));
+        weights_.push_back(weight);
     }
     
-    const auto count = values.size();
-    const MQuaternion average(sum.x / count, sum.y / count, sum.z / count, sum.w / count);
+    auto result() const -> decltype(TReduction::result(std::declval<Term>(), 0.0))
+    {
+        return TReduction::result(core::sum(terms_.data(), terms_.size()), core::sum(weights_.data(), weights_.size()));
+    }
+
+private:
+    std::vector<Term> terms_;
+    std::vector<double> weights_;
+};
+
+// Array element that a dirtied plug belongs to, children of an element belong to that element
+inline MPlug elementPlug(const MPlug& plug)
+{
+    MPlug out = plug;
+    while (!out.isElement() && out.isChild())
+    {
+        out = out.parent();
+    }
     
-    return average.exp().asEulerRotation();
+    return out;
 }
 
-template<>
-inline MEulerRotation average(const std::vector<MEulerRotation>& values, const std::vector<double>& weights)
+// Running totals of a reduction over the elements of an array attribute
+// Terms are kept per logical index so that a dirty element replaces its own term without touching the others.
+// The totals are rebuilt from all elements when the dirty elements are unknown, when the number of elements
+// changes and every kRebuildInterval updates to limit floating point drift. The unit term of an element is
+// reused whenever its value is bit-identical to the one it was computed from.
+// Each replacement rounds the totals once more than a fresh total would, so the incremental result drifts from
+// the reduction from scratch by at most kRebuildInterval roundings of the largest total. The first evaluation after
+// an evaluation in another context rebuilds the totals, so that both contexts agree on the same values.
+// When no element was marked dirty since the last evaluation the elements are compared with the ones the totals
+// were computed from, the result is reused as is only when they are all bit-identical.
+template<typename TInType, typename TReduction>
+class IncrementalReduction
 {
-    if (values.empty() || weights.empty()) return MEulerRotation::identity;
+public:
+    typedef typename TReduction::Term Term;
     
-    const double weightSum = std::accumulate(weights.begin(), weights.end(), 0.0);
-    if (almostEquals(weightSum, 0.0)) return MEulerRotation::identity;
+    static constexpr unsigned kRebuildInterval = 256u;
     
-    MQuaternion sum;
-    for (unsigned i = 0u; i < values.size(); ++i)
+    // Marks the element of the array attribute that the plug belongs to, the whole array when the plug is the array
+    void setDirty(const MPlug& plug, const MObject& attribute)
     {
-        sum = sum + values[i].asQuaternion().log() * weights[i];
+        const MPlug element = elementPlug(plug);
+        if (element != attribute) return;
+        
+        if (element.isElement())
+        {
+            setDirty(element.logicalIndex());
+        }
+        else
+        {
+            setAllDirty();
+        }
     }
     
-    const MQuaternion average(sum.x / weightSum, sum.y / weightSum, sum.z / weightSum, sum.w / weightSum);
+    void setDirty(unsigned index)
+    {
+        if (dirty_.size() < indices_.size())
+        {
+            dirty_.push_back(index);
+        }
+        else
+        {
+            setAllDirty();
+        }
+    }
     
-    return average.exp().asEulerRotation();
-}
-
-template<>
-inline MQuaternion average(const std::vector<MQuaternion>& values)
-{
-    if (values.empty()) return MQuaternion::identity;
+    void setAllDirty()
+    {
+        rebuild_ = true;
+        dirty_.clear();
+    }
     
-    MQuaternion sum;
-    for (const auto& rotation : values)
+    // Called by the evaluations in other contexts, which may run concurrently with the normal one
+    void invalidate()
     {
-        sum = sum + rotation.log();
+        stale_.store(true, std::memory_order_relaxed);
     }
     
-    const auto count = values.size();
-    const MQuaternion average(sum.x / count, sum.y / count, sum.z / count, sum.w / count);
+    bool noneDirty(unsigned count) const
+    {
+        return !rebuild_ && !stale_.load(std::memory_order_relaxed) && dirty_.empty() && count == indices_.size();
+    }
     
-    return average.exp();
-}
-
-template<>
-inline MQuaternion average(const std::vector<MQuaternion>& values, const std::vector<double>& weights)
-{
-    if (values.empty() || weights.empty()) return MQuaternion::identity;
+    // Whether the element at the position is the one the totals were computed from
+    bool matches(unsigned position, unsigned index, const TInType& value, double weight) const
+    {
+        return indices_[position] == index && std::memcmp(&values_[position], &value, sizeof(TInType)) == 0 &&
+               std::memcmp(&weights_[position], &weight, sizeof(double)) == 0;
+    }
     
-    const double weightSum = std::accumulate(weights.begin(), weights.end(), 0.0);
-    if (almostEquals(weightSum, 0.0)) return MQuaternion::identity;
+    bool needsRebuild(unsigned count) const
+    {
+        return rebuild_ || stale_.load(std::memory_order_relaxed) || updates_ >= kRebuildInterval ||
+               count != indices_.size();
+    }
     
-    MQuaternion sum;
-    for (unsigned i = 0u; i < values.size(); ++i)
+    const std::vector<unsigned>& dirtyIndices() const { return dirty_; }
+    
+    void beginRebuild()
     {
-        sum = sum + values[i].log() * weights[i];
+        stale_.store(false, std::memory_order_relaxed);
+        
+        std::swap(indices_, previousIndices_);
+        std::swap(values_, previousValues_);
+        std::swap(unitTerms_, previousUnitTerms_);
+        
+        indices_.clear();
+        values_.clear();
+        unitTerms_.clear();
+        weights_.clear();
+        terms_.clear();
     }
     
-    const MQuaternion average(sum.x / weightSum, sum.y / weightSum, sum.z / weightSum, sum.w / weightSum);
+    void add(unsigned index, const TInType& value, double weight)
+    {
+        const size_t position = indices_.size();
+        const bool reuse = position < previousIndices_.size() && previousIndices_[position] == index &&
+                           std::memcmp(&previousValues_[position], &value, sizeof(TInType)) == 0;
+        
+        indices_.push_back(index);
+        values_.push_back(value);
+        unitTerms_.push_back(reuse ? previousUnitTerms_[position] : TReduction::unitTerm(value));
+        weights_.push_back(weight);
+        terms_.push_back(TReduction::term(unitTerms_.back(), weight));
+    }
     
-    return average.exp();
-}
-
-// Alternative matrix to quaternion conversion to overcome some numerical instability
-// observed with the output from MTransformationMatrix.rotation()
-inline MQuaternion MatrixToQuaternion(const MMatrix& matrix)
-{
-    // w, x, y, z
-    double out[4];
+    // The totals are computed from the contiguous terms with the same kernels as the typed array nodes
+    void endRebuild()
+    {
+        total_ = core::sum(terms_.data(), terms_.size());
+        totalWeight_ = core::sum(weights_.data(), weights_.size());
+        
+        rebuild_ = false;
+        updates_ = 0u;
+        dirty_.clear();
+    }
     
-    double in[4][4];
-    matrix.get(in);
+    // Returns false when the element is not part of the totals, in which case the totals must be rebuilt
+    bool replace(unsigned index, const TInType& value, double weight)
+    {
+        const auto it = std::lower_bound(indices_.begin(), indices_.end(), index);
+        if (it == indices_.end() || *it != index) return false;
+        
+        const size_t position = size_t(it - indices_.begin());
+        if (std::memcmp(&values_[position], &value, sizeof(TInType)) != 0)
+        {
+            values_[position] = value;
+            unitTerms_[position] = TReduction::unitTerm(value);
+        }
+        
+        const Term term = TReduction::term(unitTerms_[position], weight);
+        
+        total_ = total_ - terms_[position] + term;
+        totalWeight_ += weight - weights_[position];
+        
+        weights_[position] = weight;
+        terms_[position] = term;
+        
+        return true;
+    }
+    
+    void endUpdate()
+    {
+        ++updates_;
+        dirty_.clear();
+    }
     
-    out[0] = 0.5 * std::sqrt(std::max(0.0, 1.0 + in[0][0] + in[1][1] + in[2][2]));
-    out[1] = 0.5 * std::sqrt(std::max(0.0, 1.0 + in[0][0] - in[1][1] - in[2][2]));
-    out[2] = 0.5 * std::sqrt(std::max(0.0, 1.0 - in[0][0] + in[1][1] - in[2][2]));
-    out[3] = 0.5 * std::sqrt(std::max(0.0, 1.0 - in[0][0] - in[1][1] + in[2][2]));
+    auto result() const -> decltype(TReduction::result(std::declval<Term>(), 0.0))
+    {
+        return TReduction::result(total_, totalWeight_);
+    }
+
+private:
+    std::vector<unsigned> indices_;
+    std::vector<TInType> values_;
+    std::vector<Term> unitTerms_;
+    std::vector<double> weights_;
+    std::vector<Term> terms_;
     
-    out[1] = copysign(out[1], in[2][1] - in[1][2]);
-    out[2] = copysign(out[2], in[0][2] - in[2][0]);
-    out[3] = copysign(out[3], in[1][0] - in[0][1]);
+    // Elements of the previous rebuild, swapped with the current ones so that no buffer is reallocated
+    std::vector<unsigned> previousIndices_;
+    std::vector<TInType> previousValues_;
+    std::vector<Term> previousUnitTerms_;
     
-    return MQuaternion(out[1], out[2], out[3], out[0]).normal().conjugate();
-}
+    std::vector<unsigned> dirty_;
+    Term total_ = Term();
+    double totalWeight_ = 0.0;
+    unsigned updates_ = 0u;
+    bool rebuild_ = true;
+    std::atomic<bool> stale_{false};
+};
 
-// Note: this algorithm does not consider negative scaling
-template<>
-inline MMatrix average(const std::vector<MMatrix>& values)
+
+template<typename TInAttrType, typename TOutAttrType, typename TClass, const char* TTypeName,
+    TOutAttrType (*TFuncPtr)(const std::vector<TInAttrType>&, ArrayScratch<TInAttrType>&)>
+class ArrayOpNode : public BaseNode<TClass, TTypeName>
 {
-    if (values.empty()) return MMatrix::identity;
+public:
+    static MStatus initialize()
+    {
+        createAttribute(inputAttr_, "input", DefaultValue<TInAttrType>(), true, true);
+        createAttribute(outputAttr_, "output", DefaultValue<TOutAttrType>(), false);
+        
+        MPxNode::addAttribute(inputAttr_);
+        MPxNode::addAttribute(outputAttr_);
+        
+        MPxNode::attributeAffects(inputAttr_, outputAttr_);
+        
+        return MS::kSuccess;
+    }
+    
+    MStatus compute(const MPlug& plug, MDataBlock& dataBlock) override
+    {
+        if (plug == outputAttr_ || (plug.isChild() && plug.parent() == outputAttr_))
+        {
+            getAttribute(dataBlock, inputAttr_, values_);
+            
+            setAttribute(dataBlock, outputAttr_, TFuncPtr(values_, scratch_));
+            
+            return MS::kSuccess;
+        }
+        
+        return MS::kUnknownParameter;
+    }
 
-    MQuaternion rotation;
-    MVector position, scale, shear;
+private:
+    static Attribute inputAttr_;
+    static Attribute outputAttr_;
     
-    for (const auto& matrix : values) {
-        const MTransformationMatrix xform(matrix);
+    // Buffers reused between evaluations
+    std::vector<TInAttrType> values_;
+    ArrayScratch<TInAttrType> scratch_;
+};
+
+template<typename TInAttrType, typename TOutAttrType, typename TClass, const char* TTypeName,
+    TOutAttrType (*TFuncPtr)(const std::vector<TInAttrType>&, ArrayScratch<TInAttrType>&)>
+Attribute ArrayOpNode<TInAttrType, TOutAttrType, TClass, TTypeName, TFuncPtr>::inputAttr_;
+
+template<typename TInAttrType, typename TOutAttrType, typename TClass, const char* TTypeName,
+    TOutAttrType (*TFuncPtr)(const std::vector<TInAttrType>&, ArrayScratch<TInAttrType>&)>
+Attribute ArrayOpNode<TInAttrType, TOutAttrType, TClass, TTypeName, TFuncPtr>::outputAttr_;
+
+
+#define ARRAY_OP_NODE(InAttrType, OutAttrType, NodeName, FuncPtr) \
+    TEMPLATE_PARAMETER_LINKAGE char name##NodeName[] = #NodeName; \
+    class NodeName : public ArrayOpNode<InAttrType, OutAttrType, NodeName, name##NodeName, FuncPtr> {};
+
+ARRAY_OP_NODE(double, double, MaxElement, &max_array_element);
+ARRAY_OP_NODE(int, int, MaxIntElement, &max_array_element);
+ARRAY_OP_NODE(MAngle, MAngle, MaxAngleElement, &max_array_element);
+ARRAY_OP_NODE(double, double, MinElement, &min_array_element);
+ARRAY_OP_NODE(int, int, MinIntElement, &min_array_element);
+ARRAY_OP_NODE(MAngle, MAngle, MinAngleElement, &min_array_element);
+
+
+template<typename TInAttrType, typename TOutAttrType, typename TClass, const char* TTypeName, typename TReduction>
+class ArrayReduceNode : public BaseNode<TClass, TTypeName>
+{
+public:
+    static MStatus initialize()
+    {
+        createAttribute(inputAttr_, "input", DefaultValue<TInAttrType>(), true, true);
+        createAttribute(outputAttr_, "output", DefaultValue<TOutAttrType>(), false);
         
-        double3 scaleData = {1.0, 1.0, 1.0};
-        double3 shearData = {0.0, 0.0, 0.0};
+        MPxNode::addAttribute(inputAttr_);
+        MPxNode::addAttribute(outputAttr_);
         
-        xform.getScale(scaleData, MSpace::kObject);
-        xform.getShear(shearData, MSpace::kObject);
+        MPxNode::attributeAffects(inputAttr_, outputAttr_);
+        
+        return MS::kSuccess;
+    }
+    
+    MStatus setDependentsDirty(const MPlug& plug, MPlugArray&) override
+    {
+        reduction_.setDirty(plug, inputAttr_);
+        
+        return MS::kSuccess;
+    }
+    
+    // The evaluation manager does not call setDependentsDirty while animating, the dirty plugs are listed by the
+    // evaluation node instead. Other contexts do not use the incremental totals so their dirty plugs are ignored.
+    MStatus preEvaluation(const MDGContext& context, const MEvaluationNode& evaluationNode) override
+    {
+        if (!context.isNormal()) return MS::kSuccess;
         
-        if (scaleData[0] != 0.0)
+        for (MEvaluationNodeIterator it = evaluationNode.iterator(); !it.isDone(); it.next())
         {
-            scaleData[0] = std::log(std::abs(scaleData[0]));
+            reduction_.setDirty(it.plug(), inputAttr_);
         }
         
-        if (scaleData[1] != 0.0)
+        return MS::kSuccess;
+    }
+    
+    // The incremental totals hold the values of the normal context, other contexts are reduced from scratch
+    MStatus compute(const MPlug& plug, MDataBlock& dataBlock) override
+    {
+        if (plug == outputAttr_ || (plug.isChild() && plug.parent() == outputAttr_))
         {
-            scaleData[1] = std::log(std::abs(scaleData[1]));
+            MArrayDataHandle arrayHandle = dataBlock.inputArrayValue(inputAttr_);
+            if (!dataBlock.context().isNormal())
+            {
+                ReductionAccumulator<TInAttrType, TReduction> accumulator;
+                accumulate(arrayHandle, accumulator);
+                reduction_.invalidate();
+                
+                setAttribute(dataBlock, outputAttr_, accumulator.result());
+                
+                return MS::kSuccess;
+            }
+            
+            if (!update(arrayHandle))
+            {
+                rebuild(arrayHandle);
+            }
+            
+            setAttribute(dataBlock, outputAttr_, reduction_.result());
+            
+            return MS::kSuccess;
         }
         
-        if (scaleData[2] != 0.0)
+        return MS::kUnknownParameter;
+    }
+
+private:
+    bool update(MArrayDataHandle& arrayHandle)
+    {
+        if (reduction_.noneDirty(arrayHandle.elementCount())) return unchanged(arrayHandle);
+        if (reduction_.needsRebuild(arrayHandle.elementCount())) return false;
+        
+        for (const unsigned index : reduction_.dirtyIndices())
         {
-            scaleData[2] = std::log(std::abs(scaleData[2]));
+            if (!arrayHandle.jumpToElement(index)) return false;
+            
+            MDataHandle handle = arrayHandle.inputValue();
+            if (!reduction_.replace(index, getValue<TInAttrType>(handle, inputAttr_), 1.0)) return false;
         }
         
-        scale += MVector(scaleData);
-        shear += MVector(shearData);
+        reduction_.endUpdate();
         
-        rotation = rotation + MatrixToQuaternion(matrix).log();
-        position += xform.getTranslation(MSpace::kWorld);
+        return true;
     }
-
-    const auto count = values.size();
-    const MVector scaleAverage = scale / count;
-    const MVector shearAverage = shear / count;
     
-    double3 scaleData = {1.0, 1.0, 1.0};
-    double3 shearData = {0.0, 0.0, 0.0};
-    
-    scaleAverage.get(scaleData);
-    shearAverage.get(shearData);
+    // An input can change without the node being told which element changed, so the elements are compared
+    bool unchanged(MArrayDataHandle& arrayHandle) const
+    {
+        for (unsigned position = 0u; position < arrayHandle.elementCount(); ++position)
+        {
+            arrayHandle.jumpToArrayElement(position);
+            
+            MDataHandle handle = arrayHandle.inputValue();
+            const auto value = getValue<TInAttrType>(handle, inputAttr_);
+            if (!reduction_.matches(position, arrayHandle.elementIndex(), value, 1.0)) return false;
+        }
+        
+        return true;
+    }
     
-    scaleData[0] = std::exp(scaleData[0]);
-    scaleData[1] = std::exp(scaleData[1]);
-    scaleData[2] = std::exp(scaleData[2]);
+    void rebuild(MArrayDataHandle& arrayHandle)
+    {
+        reduction_.beginRebuild();
+        accumulate(arrayHandle, reduction_);
+        reduction_.endRebuild();
+    }
     
-    const MVector positionAverage = position / count;
-    const auto rotationAverage = MQuaternion(rotation.x / count,
-                                             rotation.y / count,
-                                             rotation.z / count,
-                                             rotation.w / count).exp();
+    template<typename TAccumulator>
+    static void accumulate(MArrayDataHandle& arrayHandle, TAccumulator& accumulator)
+    {
+        for (unsigned position = 0u; position < arrayHandle.elementCount(); ++position)
+        {
+            arrayHandle.jumpToArrayElement(position);
+            
+            MDataHandle handle = arrayHandle.inputValue();
+            accumulator.add(arrayHandle.elementIndex(), getValue<TInAttrType>(handle, inputAttr_), 1.0);
+        }
+    }
     
-    MTransformationMatrix xform;
-    xform.setScale(scaleData, MSpace::kObject);
-    xform.setShear(shearData, MSpace::kObject);
-    xform.setRotationQuaternion(rotationAverage.x, rotationAverage.y, rotationAverage.z, rotationAverage.w);
-    xform.setTranslation(positionAverage, MSpace::kWorld);
+    static Attribute inputAttr_;
+    static Attribute outputAttr_;
     
-    return xform.asMatrix();
-}
+    IncrementalReduction<TInAttrType, TReduction> reduction_;
+};
 
-template<>
-inline MMatrix average(const std::vector<MMatrix>& values, const std::vector<double>& weights)
+template<typename TInAttrType, typename TOutAttrType, typename TClass, const char* TTypeName, typename TReduction>
+Attribute ArrayReduceNode<TInAttrType, TOutAttrType, TClass, TTypeName, TReduction>::inputAttr_;
+
+template<typename TInAttrType, typename TOutAttrType, typename TClass, const char* TTypeName, typename TReduction>
+Attribute ArrayReduceNode<TInAttrType, TOutAttrType, TClass, TTypeName, TReduction>::outputAttr_;
+
+
+#define ARRAY_REDUCE_NODE(InAttrType, OutAttrType, NodeName, Reduction) \
+    TEMPLATE_PARAMETER_LINKAGE char name##NodeName[] = #NodeName; \
+    class NodeName : public ArrayReduceNode<InAttrType, OutAttrType, NodeName, name##NodeName, \
+                                            Reduction<InAttrType, OutAttrType>> {};
+
+ARRAY_REDUCE_NODE(double, double, Average, AverageReduction);
+ARRAY_REDUCE_NODE(int, double, AverageInt, AverageReduction);
+ARRAY_REDUCE_NODE(MAngle, MAngle, AverageAngle, AverageReduction);
+ARRAY_REDUCE_NODE(MVector, MVector, AverageVector, AverageReduction);
+ARRAY_REDUCE_NODE(MEulerRotation, MEulerRotation, AverageRotation, AverageReduction);
+ARRAY_REDUCE_NODE(MMatrix, MMatrix, AverageMatrix, AverageReduction);
+ARRAY_REDUCE_NODE(MQuaternion, MQuaternion, AverageQuaternion, AverageReduction);
+
+ARRAY_REDUCE_NODE(double, double, Sum, SumReduction);
+ARRAY_REDUCE_NODE(int, int, SumInt, SumReduction);
+ARRAY_REDUCE_NODE(MAngle, MAngle, SumAngle, SumReduction);
+ARRAY_REDUCE_NODE(MVector, MVector, SumVector, SumReduction);
+
+
+template<typename TInAttrType, typename TOutAttrType, typename TClass, const char* TTypeName, typename TReduction>
+class ArrayWeightedReduceNode : public BaseNode<TClass, TTypeName>
 {
-    if (values.empty() || weights.empty()) return MMatrix::identity;
-    
-    const double weightSum = std::accumulate(weights.begin(), weights.end(), 0.0);
-    if (almostEquals(weightSum, 0.0)) return MMatrix::identity;
-    
-    MQuaternion rotation;
-    MVector position, scale, shear;
-    
-    for (unsigned i = 0u; i < values.size(); ++i) {
-        const MTransformationMatrix xform(values[i]);
+public:
+    static MStatus initialize()
+    {
+        createAttribute(valueAttr_, "value", DefaultValue<TInAttrType>(), true);
+        createAttribute(weightAttr_, "weight", 1.0, true);
+        createCompoundAttribute(inputAttr_, {valueAttr_, weightAttr_}, "input", true, true);
+        createAttribute(outputAttr_, "output", DefaultValue<TOutAttrType>(), false);
+        
+        MPxNode::addAttribute(inputAttr_);
+        MPxNode::addAttribute(outputAttr_);
         
-        double3 scaleData = {1.0, 1.0, 1.0};
-        double3 shearData = {0.0, 0.0, 0.0};
+        MPxNode::attributeAffects(valueAttr_, outputAttr_);
+        MPxNode::attributeAffects(weightAttr_, outputAttr_);
+        MPxNode::attributeAffects(inputAttr_, outputAttr_);
         
-        xform.getScale(scaleData, MSpace::kObject);
-        xform.getShear(shearData, MSpace::kObject);
+        return MS::kSuccess;
+    }
+    
+    MStatus setDependentsDirty(const MPlug& plug, MPlugArray&) override
+    {
+        reduction_.setDirty(plug, inputAttr_);
         
-        if (scaleData[0] != 0.0)
+        return MS::kSuccess;
+    }
+    
+    // The evaluation manager does not call setDependentsDirty while animating, the dirty plugs are listed by the
+    // evaluation node instead. Other contexts do not use the incremental totals so their dirty plugs are ignored.
+    MStatus preEvaluation(const MDGContext& context, const MEvaluationNode& evaluationNode) override
+    {
+        if (!context.isNormal()) return MS::kSuccess;
+        
+        for (MEvaluationNodeIterator it = evaluationNode.iterator(); !it.isDone(); it.next())
         {
-            scaleData[0] = std::log(std::abs(scaleData[0])) * weights[i];
+            reduction_.setDirty(it.plug(), inputAttr_);
         }
         
-        if (scaleData[1] != 0.0)
+        return MS::kSuccess;
+    }
+    
+    // The incremental totals hold the values of the normal context, other contexts are reduced from scratch
+    MStatus compute(const MPlug& plug, MDataBlock& dataBlock) override
+    {
+        if (plug == outputAttr_ || (plug.isChild() && plug.parent() == outputAttr_))
         {
-            scaleData[1] = std::log(std::abs(scaleData[1])) * weights[i];
+            MArrayDataHandle arrayHandle = dataBlock.inputArrayValue(inputAttr_);
+            if (!dataBlock.context().isNormal())
+            {
+                ReductionAccumulator<TInAttrType, TReduction> accumulator;
+                accumulate(arrayHandle, accumulator);
+                reduction_.invalidate();
+                
+                setAttribute(dataBlock, outputAttr_, accumulator.result());
+                
+                return MS::kSuccess;
+            }
+            
+            if (!update(arrayHandle))
+            {
+                rebuild(arrayHandle);
+            }
+            
+            setAttribute(dataBlock, outputAttr_, reduction_.result());
+            
+            return MS::kSuccess;
         }
         
-        if (scaleData[2] != 0.0)
+        return MS::kUnknownParameter;
+    }
+
+private:
+    bool update(MArrayDataHandle& arrayHandle)
+    {
+        if (reduction_.noneDirty(arrayHandle.elementCount())) return unchanged(arrayHandle);
+        if (reduction_.needsRebuild(arrayHandle.elementCount())) return false;
+        
+        for (const unsigned index : reduction_.dirtyIndices())
         {
-            scaleData[2] = std::log(std::abs(scaleData[2])) * weights[i];
+            if (!arrayHandle.jumpToElement(index)) return false;
+            
+            MDataHandle handle = arrayHandle.inputValue();
+            MDataHandle valueHandle = handle.child(valueAttr_);
+            
+            const auto value = getValue<TInAttrType>(valueHandle, valueAttr_);
+            if (!reduction_.replace(index, value, handle.child(weightAttr_).asDouble())) return false;
         }
         
-        scale += MVector(scaleData);
-        shear += MVector(shearData);
+        reduction_.endUpdate();
         
-        rotation = rotation + MatrixToQuaternion(values[i]).log() * weights[i];
-        position += xform.getTranslation(MSpace::kWorld) * weights[i];
+        return true;
     }
     
-    const MVector scaleAverage = scale / weightSum;
-    const MVector shearAverage = shear / weightSum;
-    
-    double3 scaleData = {1.0, 1.0, 1.0};
-    double3 shearData = {0.0, 0.0, 0.0};
-    
-    scaleAverage.get(scaleData);
-    shearAverage.get(shearData);
+    // An input can change without the node being told which element changed, so the elements are compared
+    bool unchanged(MArrayDataHandle& arrayHandle) const
+    {
+        for (unsigned position = 0u; position < arrayHandle.elementCount(); ++position)
+        {
+            arrayHandle.jumpToArrayElement(position);
+            
+            MDataHandle handle = arrayHandle.inputValue();
+            MDataHandle valueHandle = handle.child(valueAttr_);
+            
+            const auto value = getValue<TInAttrType>(valueHandle, valueAttr_);
+            if (!reduction_.matches(position, arrayHandle.elementIndex(), value, handle.child(weightAttr_).asDouble()))
+            {
+                return false;
+            }
+        }
+        
+        return true;
+    }
     
-    scaleData[0] = std::exp(scaleData[0]);
-    scaleData[1] = std::exp(scaleData[1]);
-    scaleData[2] = std::exp(scaleData[2]);
+    void rebuild(MArrayDataHandle& arrayHandle)
+    {
+        reduction_.beginRebuild();
+        accumulate(arrayHandle, reduction_);
+        reduction_.endRebuild();
+    }
     
-    const MVector positionAverage = position / weightSum;
-    const auto rotationAverage = MQuaternion(rotation.x / weightSum,
-                                             rotation.y / weightSum,
-                                             rotation.z / weightSum,
-                                             rotation.w / weightSum).exp();
+    template<typename TAccumulator>
+    static void accumulate(MArrayDataHandle& arrayHandle, TAccumulator& accumulator)
+    {
+        for (unsigned position = 0u; position < arrayHandle.elementCount(); ++position)
+        {
+            arrayHandle.jumpToArrayElement(position);
+            
+            MDataHandle handle = arrayHandle.inputValue();
+            MDataHandle valueHandle = handle.child(valueAttr_);
+            
+            const auto value = getValue<TInAttrType>(valueHandle, valueAttr_);
+            accumulator.add(arrayHandle.elementIndex(), value, handle.child(weightAttr_).asDouble());
+        }
+    }
     
-    MTransformationMatrix xform;
-    xform.setScale(scaleData, MSpace::kObject);
-    xform.setShear(shearData, MSpace::kObject);
-    xform.setRotationQuaternion(rotationAverage.x, rotationAverage.y, rotationAverage.z, rotationAverage.w);
-    xform.setTranslation(positionAverage, MSpace::kWorld);
+    static Attribute inputAttr_;
+    static Attribute valueAttr_;
+    static Attribute weightAttr_;
+    static Attribute outputAttr_;
     
-    return xform.asMatrix();
-}
+    IncrementalReduction<TInAttrType, TReduction> reduction_;
+};
+
+template<typename TInAttrType, typename TOutAttrType, typename TClass, const char* TTypeName, typename TReduction>
+Attribute ArrayWeightedReduceNode<TInAttrType, TOutAttrType, TClass, TTypeName, TReduction>::inputAttr_;
+
+template<typename TInAttrType, typename TOutAttrType, typename TClass, const char* TTypeName, typename TReduction>
+Attribute ArrayWeightedReduceNode<TInAttrType, TOutAttrType, TClass, TTypeName, TReduction>::valueAttr_;
+
+template<typename TInAttrType, typename TOutAttrType, typename TClass, const char* TTypeName, typename TReduction>
+Attribute ArrayWeightedReduceNode<TInAttrType, TOutAttrType, TClass, TTypeName, TReduction>::weightAttr_;
+
+template<typename TInAttrType, typename TOutAttrType, typename TClass, const char* TTypeName, typename TReduction>
+Attribute ArrayWeightedReduceNode<TInAttrType, TOutAttrType, TClass, TTypeName, TReduction>::outputAttr_;
+
+
+#define ARRAY_WEIGHTED_REDUCE_NODE(InAttrType, OutAttrType, NodeName, Reduction) \
+    TEMPLATE_PARAMETER_LINKAGE char name##NodeName[] = #NodeName; \
+    class NodeName : public ArrayWeightedReduceNode<InAttrType, OutAttrType, NodeName, name##NodeName, \
+                                                    Reduction<InAttrType, OutAttrType>> {};
+
+ARRAY_WEIGHTED_REDUCE_NODE(double, double, WeightedAverage, AverageReduction);
+ARRAY_WEIGHTED_REDUCE_NODE(int, double, WeightedAverageInt, AverageReduction);
+ARRAY_WEIGHTED_REDUCE_NODE(MAngle, MAngle, WeightedAverageAngle, AverageReduction);
+ARRAY_WEIGHTED_REDUCE_NODE(MVector, MVector, WeightedAverageVector, AverageReduction);
+ARRAY_WEIGHTED_REDUCE_NODE(MMatrix, MMatrix, WeightedAverageMatrix, AverageReduction);
+ARRAY_WEIGHTED_REDUCE_NODE(MEulerRotation, MEulerRotation, WeightedAverageRotation, AverageReduction);
+ARRAY_WEIGHTED_REDUCE_NODE(MQuaternion, MQuaternion, WeightedAverageQuaternion, AverageReduction);
 
-inline std::vector<double> normalize(const std::vector<double>& values)
+
+template<typename TAttrType, typename TClass, const char* TTypeName,
+    void (*TFuncPtr)(const std::vector<TAttrType>&, std::vector<TAttrType>&)>
+class ArrayMapOpNode : public BaseNode<TClass, TTypeName>
 {
-    std::vector<double> out;
-    if (values.empty()) return out;
-    
-    const double s = sum(values);
-    if (almostEquals(s, 0.0)) return values;
+public:
+    static MStatus initialize()
+    {
+        createAttribute(inputAttr_, "input", DefaultValue<TAttrType>(), true, true);
+        createAttribute(outputAttr_, "output", DefaultValue<TAttrType>(), false, true);
+        
+        MPxNode::addAttribute(inputAttr_);
+        MPxNode::addAttribute(outputAttr_);
+        
+        MPxNode::attributeAffects(inputAttr_, outputAttr_);
+        
+        return MS::kSuccess;
+    }
     
-    out.reserve(values.size());
-    for (const auto& value : values)
+    MStatus compute(const MPlug& plug, MDataBlock& dataBlock) override
     {
-        out.push_back(value / s);
+        if (plug == outputAttr_ || (plug.isChild() && plug.parent() == outputAttr_))
+        {
+            getAttribute(dataBlock, inputAttr_, values_);
+            
+            TFuncPtr(values_, output_);
+            setAttribute(dataBlock, outputAttr_, output_);
+            
+            return MS::kSuccess;
+        }
+        
+        return MS::kUnknownParameter;
     }
+
+private:
+    static Attribute inputAttr_;
+    static Attribute outputAttr_;
     
-    return out;
+    // Buffers reused between evaluations
+    std::vector<TAttrType> values_;
+    std::vector<TAttrType> output_;
+};
+
+template<typename TAttrType, typename TClass, const char* TTypeName,
+    void (*TFuncPtr)(const std::vector<TAttrType>&, std::vector<TAttrType>&)>
+Attribute ArrayMapOpNode<TAttrType, TClass, TTypeName, TFuncPtr>::inputAttr_;
+
+template<typename TAttrType, typename TClass, const char* TTypeName,
+    void (*TFuncPtr)(const std::vector<TAttrType>&, std::vector<TAttrType>&)>
+Attribute ArrayMapOpNode<TAttrType, TClass, TTypeName, TFuncPtr>::outputAttr_;
+
+#define ARRAY_MAP_OP_NODE(AttrType, NodeName, FuncPtr) \
+    TEMPLATE_PARAMETER_LINKAGE char name##NodeName[] = #NodeName; \
+    class NodeName : public ArrayMapOpNode<AttrType, NodeName, name##NodeName, FuncPtr> {};
+
+ARRAY_MAP_OP_NODE(double, NormalizeArray, &normalize);
+ARRAY_MAP_OP_NODE(double, NormalizeWeightsArray, &normalizeWeights);
+
+
+// Typed array data kernels, double arrays are passed to the core kernels in place
+// while vector and matrix arrays are converted into the node owned scratch buffers
+inline const double* arrayData(MDoubleArray& values)
+{
+    return values.length() != 0u ? &values[0] : nullptr;
 }
 
-inline std::vector<double> clamp(const std::vector<double>& values)
+inline void toCore(const MVectorArray& values, std::vector<core::Vector>& out)
 {
-    std::vector<double> out;
-    if (values.empty()) return out;
-    
-    out.reserve(values.size());
-    for (const auto& value : values)
+    out.resize(values.length());
+    for (unsigned index = 0u; index < values.length(); ++index)
     {
-        out.push_back(std::max(0.0, std::min(value, 1.0)));
+        out[index] = toCore(values[index]);
     }
-    
-    return out;
 }
 
-inline std::vector<double> normalizeWeights(const std::vector<double>& values)
+// Weights are read in place unless the weight array is shorter than the values
+inline const double* arrayDataWeights(MDoubleArray& weights, size_t count, std::vector<double>& buffer)
 {
-    std::vector<double> out = clamp(values);
-    if (out.empty()) return out;
+    if (weights.length() >= count) return arrayData(weights);
     
-    const double s = sum(out);
-    if (s < 1.0) return out;
+    buffer.assign(count, 1.0);
+    if (weights.length() != 0u) weights.get(buffer.data());
     
-    for (auto& item : out)
-    {
-        item /= s;
-    }
-    
-    return out;
+    return buffer.data();
 }
 
 template<typename TType>
-TType min_array_element(const std::vector<TType>& values)
+inline TType average_data(typename ArrayDataTraits<TType>::Array& values, ArrayScratch<TType>& scratch);
+
+template<typename TType>
+inline TType average_data(typename ArrayDataTraits<TType>::Array& values, const double* weights, ArrayScratch<TType>& scratch);
+
+template<>
+inline double average_data(MDoubleArray& values, ArrayScratch<double>&)
 {
-    if (values.empty()) return DefaultValue<TType>();
-    return *std::min_element(values.begin(), values.end());
+    return core::average(arrayData(values), values.length());
 }
 
 template<>
-MAngle min_array_element(const std::vector<MAngle>& values)
+inline double average_data(MDoubleArray& values, const double* weights, ArrayScratch<double>&)
 {
-    if (values.empty()) return MAngle();
-    
-    std::vector<double> angleValues;
-    angleValues.reserve(values.size());
-    
-    for (const auto& value : values)
-    {
-        angleValues.push_back(value.asRadians());
-    }
-    
-    return MAngle(*std::min_element(angleValues.begin(), angleValues.end()));
+    return core::average(arrayData(values), weights, values.length());
+}
+
+template<>
+inline MVector average_data(MVectorArray& values, ArrayScratch<MVector>& scratch)
+{
+    toCore(values, scratch.values);
+    return toMaya(core::average(scratch.values.data(), scratch.values.size()));
+}
+
+template<>
+inline MVector average_data(MVectorArray& values, const double* weights, ArrayScratch<MVector>& scratch)
+{
+    toCore(values, scratch.values);
+    return toMaya(core::average(scratch.values.data(), weights, scratch.values.size()));
+}
+
+template<>
+inline MMatrix average_data(MMatrixArray& values, ArrayScratch<MMatrix>& scratch)
+{
+    updateAverageTerms(values, values.length(), scratch);
+    return averageFromTerms(scratch);
+}
+
+template<>
+inline MMatrix average_data(MMatrixArray& values, const double* weights, ArrayScratch<MMatrix>& scratch)
+{
+    updateAverageTerms(values, values.length(), scratch);
+    return averageFromTerms(scratch, weights);
 }
 
 template<typename TType>
-TType max_array_element(const std::vector<TType>& values)
+inline TType sum_data(typename ArrayDataTraits<TType>::Array& values, ArrayScratch<TType>& scratch);
+
+template<>
+inline double sum_data(MDoubleArray& values, ArrayScratch<double>&)
 {
-    if (values.empty()) return DefaultValue<TType>();
-    return *std::max_element(values.begin(), values.end());
+    return core::sum(arrayData(values), values.length());
 }
 
 template<>
-MAngle max_array_element(const std::vector<MAngle>& values)
+inline MVector sum_data(MVectorArray& values, ArrayScratch<MVector>& scratch)
 {
-    if (values.empty()) return MAngle();
-    
-    std::vector<double> angleValues;
-    angleValues.reserve(values.size());
-    
-    for (const auto& value : values)
-    {
-        angleValues.push_back(value.asRadians());
-    }
-    
-    return MAngle(*std::max_element(angleValues.begin(), angleValues.end()));
+    toCore(values, scratch.values);
+    return toMaya(core::sum(scratch.values.data(), scratch.values.size()));
+}
+
+inline double min_data_element(MDoubleArray& values, ArrayScratch<double>&)
+{
+    return core::minElement(arrayData(values), values.length());
+}
+
+inline double max_data_element(MDoubleArray& values, ArrayScratch<double>&)
+{
+    return core::maxElement(arrayData(values), values.length());
 }
 
 
 template<typename TInAttrType, typename TOutAttrType, typename TClass, const char* TTypeName,
-    TOutAttrType (*TFuncPtr)(const std::vector<TInAttrType>&)>
-class ArrayOpNode : public BaseNode<TClass, TTypeName>
+    TOutAttrType (*TFuncPtr)(typename ArrayDataTraits<TInAttrType>::Array&, ArrayScratch<TInAttrType>&)>
+class ArrayDataOpNode : public BaseNode<TClass, TTypeName>
 {
 public:
     static MStatus initialize()
     {
-        createAttribute(inputAttr_, "input", DefaultValue<TInAttrType>(), true, true);
+        createAttribute(inputAttr_, "input", ArrayDataType<TInAttrType>());
         createAttribute(outputAttr_, "output", DefaultValue<TOutAttrType>(), false);
         
         MPxNode::addAttribute(inputAttr_);
@@ -418,9 +977,9 @@ public:
     {
         if (plug == outputAttr_ || (plug.isChild() && plug.parent() == outputAttr_))
         {
-            const auto inputValue = getAttribute<std::vector<TInAttrType>>(dataBlock, inputAttr_);
+            typename ArrayDataTraits<TInAttrType>::Array values = getArrayDataAttribute<TInAttrType>(dataBlock, inputAttr_);
             
-            setAttribute(dataBlock, outputAttr_, TFuncPtr(inputValue));
+            setAttribute(dataBlock, outputAttr_, TFuncPtr(values, scratch_));
             
             return MS::kSuccess;
         }
@@ -431,60 +990,52 @@ public:
 private:
     static Attribute inputAttr_;
     static Attribute outputAttr_;
+    
+    // Buffers reused between evaluations
+    ArrayScratch<TInAttrType> scratch_;
 };
 
 template<typename TInAttrType, typename TOutAttrType, typename TClass, const char* TTypeName,
-    TOutAttrType (*TFuncPtr)(const std::vector<TInAttrType>&)>
-Attribute ArrayOpNode<TInAttrType, TOutAttrType, TClass, TTypeName, TFuncPtr>::inputAttr_;
+    TOutAttrType (*TFuncPtr)(typename ArrayDataTraits<TInAttrType>::Array&, ArrayScratch<TInAttrType>&)>
+Attribute ArrayDataOpNode<TInAttrType, TOutAttrType, TClass, TTypeName, TFuncPtr>::inputAttr_;
 
 template<typename TInAttrType, typename TOutAttrType, typename TClass, const char* TTypeName,
-    TOutAttrType (*TFuncPtr)(const std::vector<TInAttrType>&)>
-Attribute ArrayOpNode<TInAttrType, TOutAttrType, TClass, TTypeName, TFuncPtr>::outputAttr_;
+    TOutAttrType (*TFuncPtr)(typename ArrayDataTraits<TInAttrType>::Array&, ArrayScratch<TInAttrType>&)>
+Attribute ArrayDataOpNode<TInAttrType, TOutAttrType, TClass, TTypeName, TFuncPtr>::outputAttr_;
 
-
-#define ARRAY_OP_NODE(InAttrType, OutAttrType, NodeName, FuncPtr) \
+#define ARRAY_DATA_OP_NODE(InAttrType, OutAttrType, NodeName, FuncPtr) \
     TEMPLATE_PARAMETER_LINKAGE char name##NodeName[] = #NodeName; \
-    class NodeName : public ArrayOpNode<InAttrType, OutAttrType, NodeName, name##NodeName, FuncPtr> {};
+    class NodeName : public ArrayDataOpNode<InAttrType, OutAttrType, NodeName, name##NodeName, FuncPtr> {};
 
-ARRAY_OP_NODE(double, double, Average, &average);
-ARRAY_OP_NODE(int, double, AverageInt, &average);
-ARRAY_OP_NODE(MAngle, MAngle, AverageAngle, &average);
-ARRAY_OP_NODE(MVector, MVector, AverageVector, &average);
-ARRAY_OP_NODE(MEulerRotation, MEulerRotation, AverageRotation, &average);
-ARRAY_OP_NODE(MMatrix, MMatrix, AverageMatrix, &average);
-ARRAY_OP_NODE(MQuaternion, MQuaternion, AverageQuaternion, &average);
+ARRAY_DATA_OP_NODE(double, double, AverageDoubleArrayData, &average_data<double>);
+ARRAY_DATA_OP_NODE(MVector, MVector, AverageVectorArrayData, &average_data<MVector>);
+ARRAY_DATA_OP_NODE(MMatrix, MMatrix, AverageMatrixArrayData, &average_data<MMatrix>);
 
-ARRAY_OP_NODE(double, double, Sum, &sum);
-ARRAY_OP_NODE(int, int, SumInt, &sum);
-ARRAY_OP_NODE(MAngle, MAngle, SumAngle, &sum);
-ARRAY_OP_NODE(MVector, MVector, SumVector, &sum);
+ARRAY_DATA_OP_NODE(double, double, SumDoubleArrayData, &sum_data<double>);
+ARRAY_DATA_OP_NODE(MVector, MVector, SumVectorArrayData, &sum_data<MVector>);
 
-ARRAY_OP_NODE(double, double, MaxElement, &max_array_element);
-ARRAY_OP_NODE(int, int, MaxIntElement, &max_array_element);
-ARRAY_OP_NODE(MAngle, MAngle, MaxAngleElement, &max_array_element);
-ARRAY_OP_NODE(double, double, MinElement, &min_array_element);
-ARRAY_OP_NODE(int, int, MinIntElement, &min_array_element);
-ARRAY_OP_NODE(MAngle, MAngle, MinAngleElement, &min_array_element);
+ARRAY_DATA_OP_NODE(double, double, MaxElementDoubleArrayData, &max_data_element);
+ARRAY_DATA_OP_NODE(double, double, MinElementDoubleArrayData, &min_data_element);
 
 
+// Weights are given as a double array, missing weights default to one like the weight of the array node inputs
 template<typename TInAttrType, typename TOutAttrType, typename TClass, const char* TTypeName,
-    TOutAttrType (*TFuncPtr)(const std::vector<TInAttrType>&, const std::vector<double>&)>
-class ArrayWeightedOpNode : public BaseNode<TClass, TTypeName>
+    TOutAttrType (*TFuncPtr)(typename ArrayDataTraits<TInAttrType>::Array&, const double*, ArrayScratch<TInAttrType>&)>
+class ArrayDataWeightedOpNode : public BaseNode<TClass, TTypeName>
 {
 public:
     static MStatus initialize()
     {
-        createAttribute(valueAttr_, "value", DefaultValue<TInAttrType>(), true);
-        createAttribute(weightAttr_, "weight", 1.0, true);
-        createCompoundAttribute(inputAttr_, {valueAttr_, weightAttr_}, "input", true, true);
+        createAttribute(inputAttr_, "input", ArrayDataType<TInAttrType>());
+        createAttribute(weightAttr_, "weight", MFnData::kDoubleArray);
         createAttribute(outputAttr_, "output", DefaultValue<TOutAttrType>(), false);
         
         MPxNode::addAttribute(inputAttr_);
+        MPxNode::addAttribute(weightAttr_);
         MPxNode::addAttribute(outputAttr_);
         
-        MPxNode::attributeAffects(valueAttr_, outputAttr_);
-        MPxNode::attributeAffects(weightAttr_, outputAttr_);
         MPxNode::attributeAffects(inputAttr_, outputAttr_);
+        MPxNode::attributeAffects(weightAttr_, outputAttr_);
         
         return MS::kSuccess;
     }
@@ -493,10 +1044,11 @@ public:
     {
         if (plug == outputAttr_ || (plug.isChild() && plug.parent() == outputAttr_))
         {
-            const auto values = getAttribute<std::vector<TInAttrType>>(dataBlock, inputAttr_, valueAttr_);
-            const auto weights = getAttribute<std::vector<double>>(dataBlock, inputAttr_, weightAttr_);
+            typename ArrayDataTraits<TInAttrType>::Array values = getArrayDataAttribute<TInAttrType>(dataBlock, inputAttr_);
+            MDoubleArray weights = getArrayDataAttribute<double>(dataBlock, weightAttr_);
             
-            setAttribute(dataBlock, outputAttr_, TFuncPtr(values, weights));
+            const double* weightData = arrayDataWeights(weights, values.length(), weights_);
+            setAttribute(dataBlock, outputAttr_, TFuncPtr(values, weightData, scratch_));
             
             return MS::kSuccess;
         }
@@ -506,50 +1058,43 @@ public:
 
 private:
     static Attribute inputAttr_;
-    static Attribute valueAttr_;
     static Attribute weightAttr_;
     static Attribute outputAttr_;
+    
+    // Buffers reused between evaluations, the weights are only copied when some are missing
+    std::vector<double> weights_;
+    ArrayScratch<TInAttrType> scratch_;
 };
 
 template<typename TInAttrType, typename TOutAttrType, typename TClass, const char* TTypeName,
-    TOutAttrType (*TFuncPtr)(const std::vector<TInAttrType>&, const std::vector<double>&)>
-Attribute ArrayWeightedOpNode<TInAttrType, TOutAttrType, TClass, TTypeName, TFuncPtr>::inputAttr_;
+    TOutAttrType (*TFuncPtr)(typename ArrayDataTraits<TInAttrType>::Array&, const double*, ArrayScratch<TInAttrType>&)>
+Attribute ArrayDataWeightedOpNode<TInAttrType, TOutAttrType, TClass, TTypeName, TFuncPtr>::inputAttr_;
 
 template<typename TInAttrType, typename TOutAttrType, typename TClass, const char* TTypeName,
-    TOutAttrType (*TFuncPtr)(const std::vector<TInAttrType>&, const std::vector<double>&)>
-Attribute ArrayWeightedOpNode<TInAttrType, TOutAttrType, TClass, TTypeName, TFuncPtr>::valueAttr_;
+    TOutAttrType (*TFuncPtr)(typename ArrayDataTraits<TInAttrType>::Array&, const double*, ArrayScratch<TInAttrType>&)>
+Attribute ArrayDataWeightedOpNode<TInAttrType, TOutAttrType, TClass, TTypeName, TFuncPtr>::weightAttr_;
 
 template<typename TInAttrType, typename TOutAttrType, typename TClass, const char* TTypeName,
-    TOutAttrType (*TFuncPtr)(const std::vector<TInAttrType>&, const std::vector<double>&)>
-Attribute ArrayWeightedOpNode<TInAttrType, TOutAttrType, TClass, TTypeName, TFuncPtr>::weightAttr_;
-
-template<typename TInAttrType, typename TOutAttrType, typename TClass, const char* TTypeName,
-    TOutAttrType (*TFuncPtr)(const std::vector<TInAttrType>&, const std::vector<double>&)>
-Attribute ArrayWeightedOpNode<TInAttrType, TOutAttrType, TClass, TTypeName, TFuncPtr>::outputAttr_;
-
+    TOutAttrType (*TFuncPtr)(typename ArrayDataTraits<TInAttrType>::Array&, const double*, ArrayScratch<TInAttrType>&)>
+Attribute ArrayDataWeightedOpNode<TInAttrType, TOutAttrType, TClass, TTypeName, TFuncPtr>::outputAttr_;
 
-#define ARRAY_WEIGHTED_OP_NODE(InAttrType, OutAttrType, NodeName, FuncPtr) \
+#define ARRAY_DATA_WEIGHTED_OP_NODE(InAttrType, OutAttrType, NodeName, FuncPtr) \
     TEMPLATE_PARAMETER_LINKAGE char name##NodeName[] = #NodeName; \
-    class NodeName : public ArrayWeightedOpNode<InAttrType, OutAttrType, NodeName, name##NodeName, FuncPtr> {};
+    class NodeName : public ArrayDataWeightedOpNode<InAttrType, OutAttrType, NodeName, name##NodeName, FuncPtr> {};
 
-ARRAY_WEIGHTED_OP_NODE(double, double, WeightedAverage, &average);
-ARRAY_WEIGHTED_OP_NODE(int, double, WeightedAverageInt, &average);
-ARRAY_WEIGHTED_OP_NODE(MAngle, MAngle, WeightedAverageAngle, &average);
-ARRAY_WEIGHTED_OP_NODE(MVector, MVector, WeightedAverageVector, &average);
-ARRAY_WEIGHTED_OP_NODE(MMatrix, MMatrix, WeightedAverageMatrix, &average);
-ARRAY_WEIGHTED_OP_NODE(MEulerRotation, MEulerRotation, WeightedAverageRotation, &average);
-ARRAY_WEIGHTED_OP_NODE(MQuaternion, MQuaternion, WeightedAverageQuaternion, &average);
+ARRAY_DATA_WEIGHTED_OP_NODE(double, double, WeightedAverageDoubleArrayData, &average_data<double>);
+ARRAY_DATA_WEIGHTED_OP_NODE(MVector, MVector, WeightedAverageVectorArrayData, &average_data<MVector>);
+ARRAY_DATA_WEIGHTED_OP_NODE(MMatrix, MMatrix, WeightedAverageMatrixArrayData, &average_data<MMatrix>);
 
 
-template<typename TAttrType, typename TClass, const char* TTypeName,
-    std::vector<TAttrType> (*TFuncPtr)(const std::vector<TAttrType>&)>
-class ArrayMapOpNode : public BaseNode<TClass, TTypeName>
+template<typename TClass, const char* TTypeName, void (*TFuncPtr)(const double*, size_t, double*)>
+class ArrayDataMapOpNode : public BaseNode<TClass, TTypeName>
 {
 public:
     static MStatus initialize()
     {
-        createAttribute(inputAttr_, "input", DefaultValue<TAttrType>(), true, true);
-        createAttribute(outputAttr_, "output", DefaultValue<TAttrType>(), false, true);
+        createAttribute(inputAttr_, "input", MFnData::kDoubleArray);
+        createAttribute(outputAttr_, "output", MFnData::kDoubleArray, false);
         
         MPxNode::addAttribute(inputAttr_);
         MPxNode::addAttribute(outputAttr_);
@@ -561,11 +1106,14 @@ public:
     
     MStatus compute(const MPlug& plug, MDataBlock& dataBlock) override
     {
-        if (plug == outputAttr_ || (plug.isChild() && plug.parent() == outputAttr_))
+        if (plug == outputAttr_)
         {
-            const auto inputValue = getAttribute<std::vector<TAttrType>>(dataBlock, inputAttr_);
+            MDoubleArray values = getArrayDataAttribute<double>(dataBlock, inputAttr_);
+            
+            output_.setLength(values.length());
+            if (values.length() != 0u) TFuncPtr(&values[0], values.length(), &output_[0]);
             
-            setAttribute(dataBlock, outputAttr_, TFuncPtr(inputValue));
+            setArrayDataAttribute(dataBlock, outputAttr_, output_);
             
             return MS::kSuccess;
         }
@@ -576,19 +1124,20 @@ public:
 private:
     static Attribute inputAttr_;
     static Attribute outputAttr_;
+    
+    // Buffer reused between evaluations
+    MDoubleArray output_;
 };
 
-template<typename TAttrType, typename TClass, const char* TTypeName,
-    std::vector<TAttrType> (*TFuncPtr)(const std::vector<TAttrType>&)>
-Attribute ArrayMapOpNode<TAttrType, TClass, TTypeName, TFuncPtr>::inputAttr_;
+template<typename TClass, const char* TTypeName, void (*TFuncPtr)(const double*, size_t, double*)>
+Attribute ArrayDataMapOpNode<TClass, TTypeName, TFuncPtr>::inputAttr_;
 
-template<typename TAttrType, typename TClass, const char* TTypeName,
-    std::vector<TAttrType> (*TFuncPtr)(const std::vector<TAttrType>&)>
-Attribute ArrayMapOpNode<TAttrType, TClass, TTypeName, TFuncPtr>::outputAttr_;
+template<typename TClass, const char* TTypeName, void (*TFuncPtr)(const double*, size_t, double*)>
+Attribute ArrayDataMapOpNode<TClass, TTypeName, TFuncPtr>::outputAttr_;
 
-#define ARRAY_MAP_OP_NODE(AttrType, NodeName, FuncPtr) \
+#define ARRAY_DATA_MAP_OP_NODE(NodeName, FuncPtr) \
     TEMPLATE_PARAMETER_LINKAGE char name##NodeName[] = #NodeName; \
-    class NodeName : public ArrayMapOpNode<AttrType, NodeName, name##NodeName, FuncPtr> {};
+    class NodeName : public ArrayDataMapOpNode<NodeName, name##NodeName, FuncPtr> {};
 
-ARRAY_MAP_OP_NODE(double, NormalizeArray, &normalize);
-ARRAY_MAP_OP_NODE(double, NormalizeWeightsArray, &normalizeWeights);
+ARRAY_DATA_MAP_OP_NODE(NormalizeDoubleArrayData, &core::normalize);
+ARRAY_DATA_MAP_OP_NODE(NormalizeWeightsDoubleArrayData, &core::normalizeWeights);
@@ -0,0 +1,755 @@
+// Copyright (c) 2018-2023 Serguei Kalentchouk et al. All rights reserved.
+// Use of this source code is governed by an MIT license that can be found in the LICENSE file.
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <limits>
+#include <memory>
+#include <ostream>
+#include <vector>
+
+#include <maya/MArgList.h>
+#include <maya/MFnPluginData.h>
+#include <maya/MPxData.h>
+
+#include "Array.h"
+#include "Utils.h"
+
+// Packed math array, a contiguous buffer of doubles shared between the nodes of an array pipeline
+// Copies share the buffer, it is only duplicated when a node writes to a buffer that is still referenced elsewhere
+class PackedArrayData : public MPxData
+{
+public:
+    enum ElementType
+    {
+        kDouble = 0,
+        kVector,
+        kRotation,
+        kQuaternion,
+        kMatrix
+    };
+    
+    static void registerData(class MFnPlugin& pluginFn, int typeId)
+    {
+        id() = typeId;
+        pluginFn.registerData(typeName(), typeId, creator);
+    }
+    
+    static void deregisterData(class MFnPlugin& pluginFn)
+    {
+        pluginFn.deregisterData(id());
+    }
+    
+    static void* creator()
+    {
+        return new PackedArrayData();
+    }
+    
+    static MTypeId& id()
+    {
+        static MTypeId typeId;
+        return typeId;
+    }
+    
+    static const char* typeName()
+    {
+        return NODE_NAME_PREFIX "PackedArray";
+    }
+    
+    // Number of doubles per element, rotations are stored in XYZ order and quaternions as XYZW
+    static unsigned stride(ElementType type)
+    {
+        static const unsigned strides[] = {1u, 3u, 3u, 4u, 16u};
+        return strides[type];
+    }
+    
+    ElementType elementType() const { return elementType_; }
+    unsigned length() const { return length_; }
+    const double* data() const { return buffer_ ? buffer_->data() : nullptr; }
+    
+    // Returns a buffer sized for the given elements, the current one is reused unless other data still shares it
+    double* allocate(ElementType type, unsigned length)
+    {
+        if (!buffer_ || buffer_.use_count() != 1)
+        {
+            buffer_ = std::make_shared<std::vector<double>>();
+        }
+        
+        elementType_ = type;
+        length_ = length;
+        buffer_->resize(length * stride(type));
+        
+        return buffer_->data();
+    }
+    
+    void copy(const MPxData& src) override
+    {
+        const PackedArrayData& other = static_cast<const PackedArrayData&>(src);
+        
+        buffer_ = other.buffer_;
+        elementType_ = other.elementType_;
+        length_ = other.length_;
+    }
+    
+    MTypeId typeId() const override
+    {
+        return id();
+    }
+    
+    MString name() const override
+    {
+        return typeName();
+    }
+    
+    MStatus readASCII(const MArgList& argList, unsigned& endOfTheLastParsedElement) override
+    {
+        if (argList.length() < endOfTheLastParsedElement + 2u) return MS::kFailure;
+        
+        const int type = argList.asInt(endOfTheLastParsedElement++);
+        const int length = argList.asInt(endOfTheLastParsedElement++);
+        if (type < kDouble || type > kMatrix || length < 0) return MS::kFailure;
+        
+        const uint64_t count = uint64_t(length) * stride(ElementType(type));
+        if (argList.length() < endOfTheLastParsedElement + count) return MS::kFailure;
+        
+        double* values = allocate(ElementType(type), unsigned(length));
+        for (unsigned index = 0u; index < count; ++index)
+        {
+            values[index] = argList.asDouble(endOfTheLastParsedElement++);
+        }
+        
+        return MS::kSuccess;
+    }
+    
+    MStatus writeASCII(std::ostream& out) override
+    {
+        // Values are written with enough digits to read back the exact same doubles
+        const std::streamsize precision = out.precision(std::numeric_limits<double>::max_digits10);
+        out << int(elementType_) << " " << length_;
+        
+        const double* values = data();
+        for (unsigned index = 0u; index < length_ * stride(elementType_); ++index)
+        {
+            out << " " << values[index];
+        }
+        
+        out.precision(precision);
+        
+        return out.fail() ? MS::kFailure : MS::kSuccess;
+    }
+    
+    // Binary layout is a byte order mark, the element type and the length as 32 bit integers followed by the raw
+    // doubles, all in the byte order of the machine that wrote them. Data written with the other byte order is
+    // swapped when read. The data is left unchanged when the read fails.
+    MStatus readBinary(std::istream& in, unsigned length) override
+    {
+        uint32_t header[3] = {0u, 0u, 0u};
+        in.read(reinterpret_cast<char*>(header), sizeof(header));
+        if (in.fail()) return MS::kFailure;
+        
+        const bool swapped = header[0] == byteSwap(kByteOrderMark);
+        if (!swapped && header[0] != kByteOrderMark) return MS::kFailure;
+        
+        const uint32_t typeValue = swapped ? byteSwap(header[1]) : header[1];
+        const uint32_t elementCount = swapped ? byteSwap(header[2]) : header[2];
+        if (typeValue > kMatrix) return MS::kFailure;
+        
+        const ElementType type = ElementType(typeValue);
+        const uint64_t count = uint64_t(elementCount) * stride(type);
+        if (count > kMaxValues) return MS::kFailure;
+        if (length != 0u && sizeof(header) + sizeof(double) * count != length) return MS::kFailure;
+        
+        auto buffer = std::make_shared<std::vector<double>>(size_t(count));
+        in.read(reinterpret_cast<char*>(buffer->data()), std::streamsize(sizeof(double) * count));
+        if (in.fail()) return MS::kFailure;
+        
+        if (swapped)
+        {
+            for (double& value : *buffer)
+            {
+                uint64_t bits;
+                std::memcpy(&bits, &value, sizeof(bits));
+                bits = byteSwap(bits);
+                std::memcpy(&value, &bits, sizeof(bits));
+            }
+        }
+        
+        buffer_ = std::move(buffer);
+        elementType_ = type;
+        length_ = elementCount;
+        
+        return MS::kSuccess;
+    }
+    
+    MStatus writeBinary(std::ostream& out) override
+    {
+        const uint32_t header[3] = {kByteOrderMark, uint32_t(elementType_), length_};
+        out.write(reinterpret_cast<const char*>(header), sizeof(header));
+        
+        if (length_ != 0u)
+        {
+            out.write(reinterpret_cast<const char*>(data()), sizeof(double) * length_ * stride(elementType_));
+        }
+        
+        return out.fail() ? MS::kFailure : MS::kSuccess;
+    }
+
+private:
+    static constexpr uint32_t kByteOrderMark = 0x01020304u;
+    // Upper bound on the number of doubles read from a file, 2 GB
+    static constexpr uint64_t kMaxValues = uint64_t(1u) << 28;
+    
+    static uint32_t byteSwap(uint32_t value)
+    {
+        return (value >> 24) | ((value >> 8) & 0xff00u) | ((value << 8) & 0xff0000u) | (value << 24);
+    }
+    
+    static uint64_t byteSwap(uint64_t value)
+    {
+        return (uint64_t(byteSwap(uint32_t(value))) << 32) | byteSwap(uint32_t(value >> 32));
+    }
+    
+    std::shared_ptr<std::vector<double>> buffer_;
+    ElementType elementType_ = kDouble;
+    unsigned length_ = 0u;
+};
+
+
+template <typename TType>
+inline PackedArrayData::ElementType PackedElementType();
+
+template <>
+inline PackedArrayData::ElementType PackedElementType<double>()
+{
+    return PackedArrayData::kDouble;
+}
+
+template <>
+inline PackedArrayData::ElementType PackedElementType<MVector>()
+{
+    return PackedArrayData::kVector;
+}
+
+template <>
+inline PackedArrayData::ElementType PackedElementType<MEulerRotation>()
+{
+    return PackedArrayData::kRotation;
+}
+
+template <>
+inline PackedArrayData::ElementType PackedElementType<MQuaternion>()
+{
+    return PackedArrayData::kQuaternion;
+}
+
+template <>
+inline PackedArrayData::ElementType PackedElementType<MMatrix>()
+{
+    return PackedArrayData::kMatrix;
+}
+
+inline void packValue(double value, double* out)
+{
+    out[0] = value;
+}
+
+inline void packValue(const MVector& value, double* out)
+{
+    out[0] = value.x;
+    out[1] = value.y;
+    out[2] = value.z;
+}
+
+inline void packValue(const MEulerRotation& value, double* out)
+{
+    out[0] = value.x;
+    out[1] = value.y;
+    out[2] = value.z;
+}
+
+inline void packValue(const MQuaternion& value, double* out)
+{
+    out[0] = value.x;
+    out[1] = value.y;
+    out[2] = value.z;
+    out[3] = value.w;
+}
+
+inline void packValue(const MMatrix& value, double* out)
+{
+    for (unsigned row = 0u; row < 4u; ++row)
+    {
+        for (unsigned col = 0u; col < 4u; ++col)
+        {
+            out[row * 4u + col] = value(row, col);
+        }
+    }
+}
+
+inline void unpackValue(const double* values, double& out)
+{
+    out = values[0];
+}
+
+inline void unpackValue(const double* values, MVector& out)
+{
+    out = MVector(values[0], values[1], values[2]);
+}
+
+inline void unpackValue(const double* values, MEulerRotation& out)
+{
+    out = MEulerRotation(values[0], values[1], values[2]);
+}
+
+inline void unpackValue(const double* values, MQuaternion& out)
+{
+    out = MQuaternion(values[0], values[1], values[2], values[3]);
+}
+
+inline void unpackValue(const double* values, MMatrix& out)
+{
+    for (unsigned row = 0u; row < 4u; ++row)
+    {
+        for (unsigned col = 0u; col < 4u; ++col)
+        {
+            out(row, col) = values[row * 4u + col];
+        }
+    }
+}
+
+inline void createAttribute(Attribute& attr, const char* name, const MTypeId& dataType, bool isInput = true)
+{
+    // Unconnected inputs read as an empty packed array
+    MFnPluginData dataFn;
+    const MObject defaultValue = dataFn.create(dataType);
+    
+    MFnTypedAttribute attrFn;
+    attr.attr = attrFn.create(name, name, dataType, defaultValue);
+    attrFn.setKeyable(isInput);
+    attrFn.setStorable(isInput);
+    attrFn.setWritable(isInput);
+}
+
+// Returns the packed array connected to the input, the buffer is shared with the upstream node
+inline const PackedArrayData* getPackedAttribute(MDataBlock& dataBlock, const Attribute& attribute)
+{
+    ProfilingStage stage(ProfilingStage::kRead);
+    
+    MDataHandle handle = dataBlock.inputValue(attribute);
+    return static_cast<const PackedArrayData*>(handle.asPluginData());
+}
+
+// Reads a packed array of the given element type into a caller owned buffer, other element types read as empty
+template <typename TType>
+inline void getPackedAttribute(MDataBlock& dataBlock, const Attribute& attribute, std::vector<TType>& out)
+{
+    const PackedArrayData* data = getPackedAttribute(dataBlock, attribute);
+    if (data == nullptr || data->elementType() != PackedElementType<TType>())
+    {
+        out.clear();
+        return;
+    }
+    
+    const unsigned stride = PackedArrayData::stride(data->elementType());
+    
+    out.resize(data->length());
+    for (unsigned index = 0u; index < data->length(); ++index)
+    {
+        unpackValue(data->data() + index * stride, out[index]);
+    }
+}
+
+// Returns the packed array held by the output so that its buffer can be written in place
+inline PackedArrayData* getPackedOutput(MDataHandle& handle)
+{
+    PackedArrayData* data = static_cast<PackedArrayData*>(handle.asPluginData());
+    if (data == nullptr)
+    {
+        MFnPluginData dataFn;
+        handle.set(dataFn.create(PackedArrayData::id()));
+        data = static_cast<PackedArrayData*>(handle.asPluginData());
+    }
+    
+    return data;
+}
+
+
+template<typename TAttrType, typename TClass, const char* TTypeName>
+class PackArrayNode : public BaseNode<TClass, TTypeName>
+{
+public:
+    static MStatus initialize()
+    {
+        createAttribute(inputAttr_, "input", DefaultValue<TAttrType>(), true, true);
+        createAttribute(outputAttr_, "output", PackedArrayData::id(), false);
+        
+        MPxNode::addAttribute(inputAttr_);
+        MPxNode::addAttribute(outputAttr_);
+        
+        MPxNode::attributeAffects(inputAttr_, outputAttr_);
+        
+        return MS::kSuccess;
+    }
+    
+    MStatus compute(const MPlug& plug, MDataBlock& dataBlock) override
+    {
+        if (plug == outputAttr_)
+        {
+            ArrayView<TAttrType> inputValue(dataBlock, inputAttr_);
+            
+            ProfilingStage stage(ProfilingStage::kWrite);
+            
+            MDataHandle handle = dataBlock.outputValue(outputAttr_);
+            PackedArrayData* data = getPackedOutput(handle);
+            
+            const PackedArrayData::ElementType type = PackedElementType<TAttrType>();
+            double* values = data->allocate(type, inputValue.size());
+            for (const TAttrType& value : inputValue)
+            {
+                packValue(value, values);
+                values += PackedArrayData::stride(type);
+            }
+            
+            handle.setClean();
+            
+            return MS::kSuccess;
+        }
+        
+        return MS::kUnknownParameter;
+    }
+
+private:
+    static Attribute inputAttr_;
+    static Attribute outputAttr_;
+};
+
+template<typename TAttrType, typename TClass, const char* TTypeName>
+Attribute PackArrayNode<TAttrType, TClass, TTypeName>::inputAttr_;
+
+template<typename TAttrType, typename TClass, const char* TTypeName>
+Attribute PackArrayNode<TAttrType, TClass, TTypeName>::outputAttr_;
+
+#define PACK_ARRAY_NODE(AttrType, NodeName) \
+    TEMPLATE_PARAMETER_LINKAGE char name##NodeName[] = #NodeName; \
+    class NodeName : public PackArrayNode<AttrType, NodeName, name##NodeName> {};
+
+PACK_ARRAY_NODE(double, PackArray);
+PACK_ARRAY_NODE(MVector, PackVectorArray);
+PACK_ARRAY_NODE(MEulerRotation, PackRotationArray);
+PACK_ARRAY_NODE(MQuaternion, PackQuaternionArray);
+PACK_ARRAY_NODE(MMatrix, PackMatrixArray);
+
+
+template<typename TAttrType, typename TClass, const char* TTypeName>
+class UnpackArrayNode : public BaseNode<TClass, TTypeName>
+{
+public:
+    static MStatus initialize()
+    {
+        createAttribute(inputAttr_, "input", PackedArrayData::id());
+        createAttribute(outputAttr_, "output", DefaultValue<TAttrType>(), false, true);
+        
+        MPxNode::addAttribute(inputAttr_);
+        MPxNode::addAttribute(outputAttr_);
+        
+        MPxNode::attributeAffects(inputAttr_, outputAttr_);
+        
+        return MS::kSuccess;
+    }
+    
+    MStatus compute(const MPlug& plug, MDataBlock& dataBlock) override
+    {
+        if (plug == outputAttr_ || (plug.isChild() && plug.parent() == outputAttr_))
+        {
+            getPackedAttribute(dataBlock, inputAttr_, values_);
+            
+            setAttribute(dataBlock, outputAttr_, values_);
+            
+            return MS::kSuccess;
+        }
+        
+        return MS::kUnknownParameter;
+    }
+
+private:
+    static Attribute inputAttr_;
+    static Attribute outputAttr_;
+    
+    // Buffer reused between evaluations
+    std::vector<TAttrType> values_;
+};
+
+template<typename TAttrType, typename TClass, const char* TTypeName>
+Attribute UnpackArrayNode<TAttrType, TClass, TTypeName>::inputAttr_;
+
+template<typename TAttrType, typename TClass, const char* TTypeName>
+Attribute UnpackArrayNode<TAttrType, TClass, TTypeName>::outputAttr_;
+
+#define UNPACK_ARRAY_NODE(AttrType, NodeName) \
+    TEMPLATE_PARAMETER_LINKAGE char name##NodeName[] = #NodeName; \
+    class NodeName : public UnpackArrayNode<AttrType, NodeName, name##NodeName> {};
+
+UNPACK_ARRAY_NODE(double, UnpackArray);
+UNPACK_ARRAY_NODE(MVector, UnpackVectorArray);
+UNPACK_ARRAY_NODE(MEulerRotation, UnpackRotationArray);
+UNPACK_ARRAY_NODE(MQuaternion, UnpackQuaternionArray);
+UNPACK_ARRAY_NODE(MMatrix, UnpackMatrixArray);
+
+
+static_assert(sizeof(core::Vector) == sizeof(double) * 3u, "Packed vectors must be layout compatible with core::Vector");
+static_assert(sizeof(core::Quaternion) == sizeof(double) * 4u, "Packed quaternions must be layout compatible with core::Quaternion");
+static_assert(sizeof(core::Matrix) == sizeof(double) * 16u, "Packed matrices must be layout compatible with core::Matrix");
+
+// Averages of packed arrays, the kernels read the upstream buffer in place
+template<typename TType>
+inline TType average_packed(const double* values, size_t count, ArrayScratch<TType>& scratch);
+
+template<>
+inline double average_packed(const double* values, size_t count, ArrayScratch<double>&)
+{
+    return core::average(values, count);
+}
+
+template<>
+inline MVector average_packed(const double* values, size_t count, ArrayScratch<MVector>&)
+{
+    return toMaya(core::average(reinterpret_cast<const core::Vector*>(values), count));
+}
+
+template<>
+inline MQuaternion average_packed(const double* values, size_t count, ArrayScratch<MQuaternion>&)
+{
+    return toMaya(core::average(reinterpret_cast<const core::Quaternion*>(values), count));
+}
+
+// Packed rotations do not store their order, they are always XYZ
+template<>
+inline MEulerRotation average_packed(const double* values, size_t count, ArrayScratch<MEulerRotation>&)
+{
+    core::Quaternion total = core::Quaternion();
+    for (size_t index = 0u; index < count; ++index, values += 3u)
+    {
+        total = total + core::averageTerm(core::EulerRotation{values[0], values[1], values[2], core::kXYZ}, 1.0);
+    }
+    
+    return toMaya(core::toEulerRotation(core::averageFromTerms(total, double(count))));
+}
+
+// Packed matrices read as Maya matrices so that they share the average terms of the typed matrix arrays
+struct PackedMatrices
+{
+    const core::Matrix* matrices;
+    
+    MMatrix operator[](unsigned index) const { return toMaya(matrices[index]); }
+};
+
+template<>
+inline MMatrix average_packed(const double* values, size_t count, ArrayScratch<MMatrix>& scratch)
+{
+    updateAverageTerms(PackedMatrices{reinterpret_cast<const core::Matrix*>(values)}, count, scratch);
+    return averageFromTerms(scratch);
+}
+
+
+template<typename TInAttrType, typename TOutAttrType, typename TClass, const char* TTypeName,
+    TOutAttrType (*TFuncPtr)(const double*, size_t, ArrayScratch<TInAttrType>&)>
+class PackedArrayOpNode : public BaseNode<TClass, TTypeName>
+{
+public:
+    static MStatus initialize()
+    {
+        createAttribute(inputAttr_, "input", PackedArrayData::id());
+        createAttribute(outputAttr_, "output", DefaultValue<TOutAttrType>(), false);
+        
+        MPxNode::addAttribute(inputAttr_);
+        MPxNode::addAttribute(outputAttr_);
+        
+        MPxNode::attributeAffects(inputAttr_, outputAttr_);
+        
+        return MS::kSuccess;
+    }
+    
+    // Other element types read as an empty array
+    MStatus compute(const MPlug& plug, MDataBlock& dataBlock) override
+    {
+        if (plug == outputAttr_ || (plug.isChild() && plug.parent() == outputAttr_))
+        {
+            const PackedArrayData* input = getPackedAttribute(dataBlock, inputAttr_);
+            const bool isValid = input != nullptr && input->elementType() == PackedElementType<TInAttrType>();
+            
+            setAttribute(dataBlock, outputAttr_, TFuncPtr(isValid ? input->data() : nullptr, isValid ? input->length() : 0u,
+                                                          scratch_));
+            
+            return MS::kSuccess;
+        }
+        
+        return MS::kUnknownParameter;
+    }
+
+private:
+    static Attribute inputAttr_;
+    static Attribute outputAttr_;
+    
+    ArrayScratch<TInAttrType> scratch_;
+};
+
+template<typename TInAttrType, typename TOutAttrType, typename TClass, const char* TTypeName,
+    TOutAttrType (*TFuncPtr)(const double*, size_t, ArrayScratch<TInAttrType>&)>
+Attribute PackedArrayOpNode<TInAttrType, TOutAttrType, TClass, TTypeName, TFuncPtr>::inputAttr_;
+
+template<typename TInAttrType, typename TOutAttrType, typename TClass, const char* TTypeName,
+    TOutAttrType (*TFuncPtr)(const double*, size_t, ArrayScratch<TInAttrType>&)>
+Attribute PackedArrayOpNode<TInAttrType, TOutAttrType, TClass, TTypeName, TFuncPtr>::outputAttr_;
+
+#define PACKED_ARRAY_OP_NODE(InAttrType, OutAttrType, NodeName, FuncPtr) \
+    TEMPLATE_PARAMETER_LINKAGE char name##NodeName[] = #NodeName; \
+    class NodeName : public PackedArrayOpNode<InAttrType, OutAttrType, NodeName, name##NodeName, FuncPtr> {};
+
+PACKED_ARRAY_OP_NODE(double, double, AveragePackedArray, &average_packed<double>);
+PACKED_ARRAY_OP_NODE(MVector, MVector, AveragePackedVectorArray, &average_packed<MVector>);
+PACKED_ARRAY_OP_NODE(MEulerRotation, MEulerRotation, AveragePackedRotationArray, &average_packed<MEulerRotation>);
+PACKED_ARRAY_OP_NODE(MQuaternion, MQuaternion, AveragePackedQuaternionArray, &average_packed<MQuaternion>);
+PACKED_ARRAY_OP_NODE(MMatrix, MMatrix, AveragePackedMatrixArray, &average_packed<MMatrix>);
+
+
+// Map kernels read the upstream buffer directly and write into the output buffer
+template<typename TClass, const char* TTypeName, void (*TFuncPtr)(const double*, size_t, double*)>
+class PackedArrayMapOpNode : public BaseNode<TClass, TTypeName>
+{
+public:
+    static MStatus initialize()
+    {
+        createAttribute(inputAttr_, "input", PackedArrayData::id());
+        createAttribute(outputAttr_, "output", PackedArrayData::id(), false);
+        
+        MPxNode::addAttribute(inputAttr_);
+        MPxNode::addAttribute(outputAttr_);
+        
+        MPxNode::attributeAffects(inputAttr_, outputAttr_);
+        
+        return MS::kSuccess;
+    }
+    
+    MStatus compute(const MPlug& plug, MDataBlock& dataBlock) override
+    {
+        if (plug == outputAttr_)
+        {
+            const PackedArrayData* input = getPackedAttribute(dataBlock, inputAttr_);
+            const bool isValid = input != nullptr && input->elementType() == PackedArrayData::kDouble;
+            const unsigned length = isValid ? input->length() : 0u;
+            
+            ProfilingStage stage(ProfilingStage::kWrite);
+            
+            MDataHandle handle = dataBlock.outputValue(outputAttr_);
+            PackedArrayData* output = getPackedOutput(handle);
+            
+            double* values = output->allocate(PackedArrayData::kDouble, length);
+            if (length != 0u) TFuncPtr(input->data(), length, values);
+            
+            handle.setClean();
+            
+            return MS::kSuccess;
+        }
+        
+        return MS::kUnknownParameter;
+    }
+
+private:
+    static Attribute inputAttr_;
+    static Attribute outputAttr_;
+};
+
+template<typename TClass, const char* TTypeName, void (*TFuncPtr)(const double*, size_t, double*)>
+Attribute PackedArrayMapOpNode<TClass, TTypeName, TFuncPtr>::inputAttr_;
+
+template<typename TClass, const char* TTypeName, void (*TFuncPtr)(const double*, size_t, double*)>
+Attribute PackedArrayMapOpNode<TClass, TTypeName, TFuncPtr>::outputAttr_;
+
+#define PACKED_ARRAY_MAP_OP_NODE(NodeName, FuncPtr) \
+    TEMPLATE_PARAMETER_LINKAGE char name##NodeName[] = #NodeName; \
+    class NodeName : public PackedArrayMapOpNode<NodeName, name##NodeName, FuncPtr> {};
+
+PACKED_ARRAY_MAP_OP_NODE(NormalizePackedArray, &core::normalize);
+PACKED_ARRAY_MAP_OP_NODE(NormalizeWeightsPackedArray, &core::normalizeWeights);
+
+
+template<typename TClass, const char* TTypeName>
+class SelectPackedArrayNode : public BaseNode<TClass, TTypeName>
+{
+public:
+    static MStatus initialize()
+    {
+        createAttribute(input1Attr_, "input1", PackedArrayData::id());
+        createAttribute(input2Attr_, "input2", PackedArrayData::id());
+        createAttribute(condition_, "condition", false);
+        createAttribute(outputAttr_, "output", PackedArrayData::id(), false);
+        
+        MPxNode::addAttribute(input1Attr_);
+        MPxNode::addAttribute(input2Attr_);
+        MPxNode::addAttribute(condition_);
+        MPxNode::addAttribute(outputAttr_);
+        
+        MPxNode::attributeAffects(input1Attr_, outputAttr_);
+        MPxNode::attributeAffects(input2Attr_, outputAttr_);
+        MPxNode::attributeAffects(condition_, outputAttr_);
+        
+        return MS::kSuccess;
+    }
+    
+    MStatus compute(const MPlug& plug, MDataBlock& dataBlock) override
+    {
+        if (plug == outputAttr_)
+        {
+            const auto conditionValue = getAttribute<bool>(dataBlock, condition_);
+            
+            // The selected array is shared with the output, its buffer is not copied
+            const PackedArrayData* input = getPackedAttribute(dataBlock, conditionValue ? input2Attr_ : input1Attr_);
+            
+            ProfilingStage stage(ProfilingStage::kWrite);
+            
+            MDataHandle handle = dataBlock.outputValue(outputAttr_);
+            PackedArrayData* output = getPackedOutput(handle);
+            
+            if (input != nullptr)
+            {
+                output->copy(*input);
+            }
+            else
+            {
+                output->allocate(PackedArrayData::kDouble, 0u);
+            }
+            
+            handle.setClean();
+            
+            return MS::kSuccess;
+        }
+        
+        return MS::kUnknownParameter;
+    }
+
+private:
+    static Attribute input1Attr_;
+    static Attribute input2Attr_;
+    static Attribute condition_;
+    static Attribute outputAttr_;
+};
+
+template<typename TClass, const char* TTypeName>
+Attribute SelectPackedArrayNode<TClass, TTypeName>::input1Attr_;
+
+template<typename TClass, const char* TTypeName>
+Attribute SelectPackedArrayNode<TClass, TTypeName>::input2Attr_;
+
+template<typename TClass, const char* TTypeName>
+Attribute SelectPackedArrayNode<TClass, TTypeName>::condition_;
+
+template<typename TClass, const char* TTypeName>
+Attribute SelectPackedArrayNode<TClass, TTypeName>::outputAttr_;
+
+#define SELECT_PACKED_ARRAY_NODE(NodeName) \
+    TEMPLATE_PARAMETER_LINKAGE char name##NodeName[] = #NodeName; \
+    class NodeName : public SelectPackedArrayNode<NodeName, name##NodeName> {};
+
+SELECT_PACKED_ARRAY_NODE(SelectPackedArray);
@@ -5,6 +5,7 @@
 #include <algorithm>
 #include <cmath>
 
+#include "core/Interpolate.h"
 #include "MinMax.h"
 #include "Utils.h"
 
@@ -92,24 +93,21 @@ inline TType remapValue(const TType& value,
                         const TType& low2,
                         const TType& high2)
 {
-    const auto divisor = (high1 - low1);
-    if (almostEquals(divisor, TType(0.0))) return TType(0);
-    
-    return low2 + (high2 - low2) * ((value - low1) / divisor);
+    return core::remapValue(value, low1, high1, low2, high2);
 }
 
 template <>
-inline int remapValue(const int& value,
-                      const int& low1,
-                      const int& high1,
-                      const int& low2,
-                      const int& high2)
+inline MAngle remapValue(const MAngle& value,
+                         const MAngle& low1,
+                         const MAngle& high1,
+                         const MAngle& low2,
+                         const MAngle& high2)
 {
-    const float divisor = float(high1 - low1);
-    if (almostEquals(divisor, 0.0f)) return 0;
-    
-    const float result = low2 + (high2 - low2) * ((value - low1) / divisor);
-    return result > 0.0f ? int(result + 0.5f) : int(result - 0.5f);
+    return MAngle(core::remapValue(value.asRadians(),
+                                   low1.asRadians(),
+                                   high1.asRadians(),
+                                   low2.asRadians(),
+                                   high2.asRadians()));
 }
 
 
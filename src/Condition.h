@@ -147,11 +147,11 @@ public:
     {
         if (plug == outputAttr_ || (plug.isChild() && plug.parent() == outputAttr_))
         {
-            const auto input1Value = getAttribute<TAttrType>(dataBlock, input1Attr_);
-            const auto input2Value = getAttribute<TAttrType>(dataBlock, input2Attr_);
+            // The condition is read first so that only the selected input is pulled from upstream
             const auto conditionValue = getAttribute<bool>(dataBlock, condition_);
+            const auto inputValue = getAttribute<TAttrType>(dataBlock, conditionValue ? input2Attr_ : input1Attr_);
 
-            setAttribute(dataBlock, outputAttr_, conditionValue ? input2Value : input1Value);
+            setAttribute(dataBlock, outputAttr_, inputValue);
 
             return MS::kSuccess;
         }
@@ -218,11 +218,17 @@ public:
     {
         if (plug == outputAttr_ || (plug.isChild() && plug.parent() == outputAttr_))
         {
-            const auto input1Value = getAttribute<std::vector<TAttrType>>(dataBlock, input1Attr_);
-            const auto input2Value = getAttribute<std::vector<TAttrType>>(dataBlock, input2Attr_);
             const auto conditionValue = getAttribute<bool>(dataBlock, condition_);
+            const Attribute& inputAttr = conditionValue ? input2Attr_ : input1Attr_;
             
-            setAttribute(dataBlock, outputAttr_, conditionValue ? input2Value : input1Value);
+            // The output is the selected input compacted to contiguous logical indices, a single requested output
+            // element only pulls the input element it comes from, otherwise the selected input is copied whole
+            const MPlug elementPlug = plug.isChild() ? plug.parent() : plug;
+            if (!elementPlug.isElement() ||
+                !copyArrayElement<TAttrType>(dataBlock, outputAttr_, inputAttr, this->thisMObject(), elementPlug.logicalIndex()))
+            {
+                copyArrayAttribute<TAttrType>(dataBlock, outputAttr_, inputAttr);
+            }
             
             return MS::kSuccess;
         }
@@ -304,9 +310,19 @@ public:
         if (plug == outputAttr_ || (plug.isChild() && plug.parent() == outputAttr_))
         {
             const auto input1Value = getAttribute<TAttrType>(dataBlock, input1Attr_);
-            const auto input2Value = getAttribute<TAttrType>(dataBlock, input2Attr_);
             
-            setAttribute(dataBlock, outputAttr_, TFuncPtr(input1Value, input2Value));
+            // Logical operations only look at the truth of input2, when both truth values give the same result
+            // the output is decided by input1 alone and input2 is not pulled from upstream
+            const bool result = TFuncPtr(input1Value, TAttrType(false));
+            if (result == TFuncPtr(input1Value, TAttrType(true)))
+            {
+                setAttribute(dataBlock, outputAttr_, result);
+            }
+            else
+            {
+                const auto input2Value = getAttribute<TAttrType>(dataBlock, input2Attr_);
+                setAttribute(dataBlock, outputAttr_, TFuncPtr(input1Value, input2Value));
+            }
             
             return MS::kSuccess;
         }
@@ -377,11 +393,11 @@ public:
     {
         if (plug == outputAttr_ || (plug.isChild() && plug.parent() == outputAttr_))
         {
-            const auto input1Value = getAttribute(dataBlock, input1Attr_, TGeomType);
-            const auto input2Value = getAttribute(dataBlock, input2Attr_, TGeomType);
+            // The condition is read first so that only the selected input is pulled from upstream
             const auto conditionValue = getAttribute<bool>(dataBlock, condition_);
+            const auto inputValue = getAttribute(dataBlock, conditionValue ? input2Attr_ : input1Attr_, TGeomType);
             
-            setAttribute(dataBlock, outputAttr_, conditionValue ? input2Value : input1Value);
+            setAttribute(dataBlock, outputAttr_, inputValue);
             
             return MS::kSuccess;
         }
@@ -404,3 +420,8 @@ SELECT_GEOM_NODE_ATTRIBUTE::outputAttr_;
 SELECT_GEOM_NODE(SelectCurve, MFnData::kNurbsCurve);
 SELECT_GEOM_NODE(SelectMesh, MFnData::kMesh);
 SELECT_GEOM_NODE(SelectSurface, MFnData::kNurbsSurface);
+
+// Typed array data is passed through as is, the selected data object is shared with the output
+SELECT_GEOM_NODE(SelectDoubleArrayData, MFnData::kDoubleArray);
+SELECT_GEOM_NODE(SelectVectorArrayData, MFnData::kVectorArray);
+SELECT_GEOM_NODE(SelectMatrixArrayData, MFnData::kMatrixArray);
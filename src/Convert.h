@@ -5,6 +5,7 @@
 #include <maya/MFnEnumAttribute.h>
 #include <maya/MTransformationMatrix.h>
 
+#include "core/Interpolate.h"
 #include "Utils.h"
 
 template <typename TInType, typename TOutType>
@@ -19,9 +20,7 @@ inline MEulerRotation getRotation(const MMatrix& source, MEulerRotation::Rotatio
 template <>
 inline MQuaternion getRotation(const MMatrix& source, MEulerRotation::RotationOrder)
 {
-    MTransformationMatrix xform(source);
-    
-    return xform.rotation();
+    return toMaya(core::decompose(toCore(source)).rotation);
 }
 
 template <>
@@ -123,12 +122,7 @@ inline MVector getTranslationFromMatrix(const MMatrix& matrix)
 
 inline MVector getScaleFromMatrix(const MMatrix& matrix)
 {
-    MTransformationMatrix xform(matrix);
-    
-    double3 scale {1.0, 1.0, 1.0};
-    xform.getScale(scale, MSpace::kTransform);
-    
-    return MVector(scale);
+    return toMaya(core::decompose(toCore(matrix)).scale);
 }
 
 template<typename TClass, const char* TTypeName, typename TOpFuncPtrType, TOpFuncPtrType TOpFucPtr>
@@ -213,21 +207,15 @@ public:
         if (plug == outputAttr_ || (plug.isChild() && plug.parent() == outputAttr_))
         {
             const auto translationValue = getAttribute<MVector>(dataBlock, translationAttr_);
-            auto rotationValue = getAttribute<MEulerRotation>(dataBlock, rotationAttr_);
+            const auto rotationValue = getAttribute<MEulerRotation>(dataBlock, rotationAttr_);
             const auto scaleValue = getAttribute<MVector>(dataBlock, scaleAttr_);
-            const auto rotationOrder = getAttribute<MTransformationMatrix::RotationOrder>(dataBlock, rotationOrderAttr_);
-            
-            MTransformationMatrix xform;
-            xform.setTranslation(translationValue, MSpace::kTransform);
-            
-            double3 rotation {rotationValue.x, rotationValue.y, rotationValue.z};
-            xform.setRotation(rotation, rotationOrder);
+            const auto rotationOrder = getAttribute<MEulerRotation::RotationOrder>(dataBlock, rotationOrderAttr_);
             
-            double3 scale {1.0, 1.0, 1.0};
-            scaleValue.get(scale);
-            xform.setScale(scale, MSpace::kTransform);
+            const core::EulerRotation rotation = {rotationValue.x, rotationValue.y, rotationValue.z,
+                                                  core::RotationOrder(rotationOrder)};
+            const core::Matrix matrix = core::compose(toCore(translationValue), rotation, toCore(scaleValue));
             
-            setAttribute(dataBlock, outputAttr_, xform.asMatrix());
+            setAttribute(dataBlock, outputAttr_, toMaya(matrix));
             
             return MS::kSuccess;
         }
@@ -0,0 +1,97 @@
+// Copyright (c) 2018-2023 Serguei Kalentchouk et al. All rights reserved.
+// Use of this source code is governed by an MIT license that can be found in the LICENSE file.
+#pragma once
+
+#include <vector>
+
+#include <maya/MAngle.h>
+#include <maya/MEulerRotation.h>
+#include <maya/MMatrix.h>
+#include <maya/MQuaternion.h>
+#include <maya/MVector.h>
+
+#include "core/Types.h"
+
+// Conversions between Maya types and the Maya independent core types
+inline double toCore(double value)
+{
+    return value;
+}
+
+inline int toCore(int value)
+{
+    return value;
+}
+
+inline double toCore(const MAngle& value)
+{
+    return value.asRadians();
+}
+
+inline core::Vector toCore(const MVector& value)
+{
+    return {value.x, value.y, value.z};
+}
+
+inline core::Quaternion toCore(const MQuaternion& value)
+{
+    return {value.x, value.y, value.z, value.w};
+}
+
+inline core::EulerRotation toCore(const MEulerRotation& value)
+{
+    return {value.x, value.y, value.z, core::RotationOrder(value.order)};
+}
+
+inline core::Matrix toCore(const MMatrix& value)
+{
+    core::Matrix out;
+    value.get(out.m);
+
+    return out;
+}
+
+template <typename TType>
+inline auto toCore(const std::vector<TType>& values) -> std::vector<decltype(toCore(values[0]))>
+{
+    std::vector<decltype(toCore(values[0]))> out;
+    out.reserve(values.size());
+
+    for (const auto& value : values)
+    {
+        out.push_back(toCore(value));
+    }
+
+    return out;
+}
+
+// Converts into a caller owned buffer, the buffer only grows when the input grows
+template <typename TType, typename TCoreType>
+inline void toCore(const std::vector<TType>& values, std::vector<TCoreType>& out)
+{
+    out.resize(values.size());
+    for (size_t index = 0u; index < values.size(); ++index)
+    {
+        out[index] = toCore(values[index]);
+    }
+}
+
+inline MVector toMaya(const core::Vector& value)
+{
+    return MVector(value.x, value.y, value.z);
+}
+
+inline MQuaternion toMaya(const core::Quaternion& value)
+{
+    return MQuaternion(value.x, value.y, value.z, value.w);
+}
+
+inline MEulerRotation toMaya(const core::EulerRotation& value)
+{
+    return MEulerRotation(value.x, value.y, value.z, MEulerRotation::RotationOrder(value.order));
+}
+
+inline MMatrix toMaya(const core::Matrix& value)
+{
+    return MMatrix(value.m);
+}
@@ -2,6 +2,20 @@
 // Use of this source code is governed by an MIT license that can be found in the LICENSE file.
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include <maya/MNodeMessage.h>
+#include <maya/MObjectHandle.h>
+#include <maya/MTime.h>
+#include <maya/MTimerMessage.h>
+
 #include "Utils.h"
 
 static inline void
@@ -67,6 +81,511 @@ logToConsole(const MString& name, const MMatrix& value)
 }
 
 
+// Debug log record, the value is stored unformatted and converted to text when the queue is drained
+struct DebugLogRecord
+{
+    enum Type
+    {
+        kDouble,
+        kInt,
+        kAngle,
+        kVector,
+        kRotation,
+        kQuaternion,
+        kMatrix
+    };
+    
+    enum Destination
+    {
+        kConsole = 1,
+        kFile = 2
+    };
+    
+    static constexpr unsigned kMaxNameLength = 64u;
+    
+    Type type;
+    int destination;
+    // Hash code of the node handle, the truncated name is only used when the node is gone by the time it is drained
+    unsigned node;
+    char name[kMaxNameLength];
+    double frame;
+    double values[16];
+    
+    unsigned valueCount() const
+    {
+        static const unsigned counts[] = {1u, 1u, 1u, 3u, 3u, 4u, 16u};
+        return counts[type];
+    }
+};
+
+static inline void
+toRecord(double value, DebugLogRecord& record)
+{
+    record.type = DebugLogRecord::kDouble;
+    record.values[0] = value;
+}
+
+static inline void
+toRecord(int value, DebugLogRecord& record)
+{
+    record.type = DebugLogRecord::kInt;
+    record.values[0] = value;
+}
+
+static inline void
+toRecord(const MAngle& value, DebugLogRecord& record)
+{
+    record.type = DebugLogRecord::kAngle;
+    record.values[0] = value.asRadians();
+}
+
+static inline void
+toRecord(const MVector& value, DebugLogRecord& record)
+{
+    record.type = DebugLogRecord::kVector;
+    record.values[0] = value.x;
+    record.values[1] = value.y;
+    record.values[2] = value.z;
+}
+
+static inline void
+toRecord(const MEulerRotation& value, DebugLogRecord& record)
+{
+    record.type = DebugLogRecord::kRotation;
+    record.values[0] = value.x;
+    record.values[1] = value.y;
+    record.values[2] = value.z;
+}
+
+static inline void
+toRecord(const MQuaternion& value, DebugLogRecord& record)
+{
+    record.type = DebugLogRecord::kQuaternion;
+    record.values[0] = value.x;
+    record.values[1] = value.y;
+    record.values[2] = value.z;
+    record.values[3] = value.w;
+}
+
+static inline void
+toRecord(const MMatrix& value, DebugLogRecord& record)
+{
+    record.type = DebugLogRecord::kMatrix;
+    for (auto i = 0u; i < 16u; ++i)
+    {
+        record.values[i] = value[i / 4u][i % 4u];
+    }
+}
+
+static inline void
+logToConsole(const DebugLogRecord& record, const MString& name)
+{
+    const double* values = record.values;
+    
+    switch (record.type)
+    {
+        case DebugLogRecord::kDouble:
+            logToConsole(name, values[0]);
+            break;
+        case DebugLogRecord::kInt:
+            logToConsole(name, int(values[0]));
+            break;
+        case DebugLogRecord::kAngle:
+            logToConsole(name, MAngle(values[0]));
+            break;
+        case DebugLogRecord::kVector:
+            logToConsole(name, MVector(values[0], values[1], values[2]));
+            break;
+        case DebugLogRecord::kRotation:
+            logToConsole(name, MEulerRotation(values[0], values[1], values[2]));
+            break;
+        case DebugLogRecord::kQuaternion:
+            logToConsole(name, MQuaternion(values[0], values[1], values[2], values[3]));
+            break;
+        case DebugLogRecord::kMatrix:
+        {
+            MMatrix matrix;
+            for (auto i = 0u; i < 16u; ++i)
+            {
+                matrix[i / 4u][i % 4u] = values[i];
+            }
+            
+            logToConsole(name, matrix);
+            break;
+        }
+    }
+}
+
+
+// Debug log queue
+// Bounded lock-free queue, computes on any thread push records and the main thread pops them.
+// Each cell carries a sequence number that tells producers and the consumer whether the cell is free,
+// records pushed while the queue is full are dropped and counted.
+class DebugLogQueue
+{
+public:
+    static constexpr size_t kCapacity = 4096u;
+    
+    DebugLogQueue()
+    {
+        for (size_t index = 0u; index < kCapacity; ++index)
+        {
+            cells_[index].sequence.store(index, std::memory_order_relaxed);
+        }
+    }
+    
+    bool push(const DebugLogRecord& record)
+    {
+        size_t position = enqueuePosition_.load(std::memory_order_relaxed);
+        
+        Cell* cell = nullptr;
+        for (;;)
+        {
+            cell = &cells_[position % kCapacity];
+            
+            const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            if (sequence == position)
+            {
+                if (enqueuePosition_.compare_exchange_weak(position, position + 1u, std::memory_order_relaxed)) break;
+            }
+            else if (sequence < position)
+            {
+                dropped_.fetch_add(1u, std::memory_order_relaxed);
+                return false;
+            }
+            else
+            {
+                position = enqueuePosition_.load(std::memory_order_relaxed);
+            }
+        }
+        
+        cell->record = record;
+        cell->sequence.store(position + 1u, std::memory_order_release);
+        
+        return true;
+    }
+    
+    // Must only be called from one thread at a time
+    bool pop(DebugLogRecord& record)
+    {
+        const size_t position = dequeuePosition_.load(std::memory_order_relaxed);
+        Cell& cell = cells_[position % kCapacity];
+        
+        if (cell.sequence.load(std::memory_order_acquire) != position + 1u) return false;
+        
+        record = cell.record;
+        cell.sequence.store(position + kCapacity, std::memory_order_release);
+        dequeuePosition_.store(position + 1u, std::memory_order_relaxed);
+        
+        return true;
+    }
+    
+    size_t takeDropped()
+    {
+        return dropped_.exchange(0u, std::memory_order_relaxed);
+    }
+    
+    static DebugLogQueue& instance()
+    {
+        static DebugLogQueue queue;
+        return queue;
+    }
+
+private:
+    struct Cell
+    {
+        std::atomic<size_t> sequence;
+        DebugLogRecord record;
+    };
+    
+    Cell cells_[kCapacity];
+    std::atomic<size_t> enqueuePosition_{0u};
+    std::atomic<size_t> dequeuePosition_{0u};
+    std::atomic<size_t> dropped_{0u};
+};
+
+// Debug log nodes by handle hash code, the records are named after the full current name of their node
+// Nodes are added and removed on the main thread, which is also the thread that drains the records.
+class DebugLogNodes
+{
+public:
+    static void add(const MObjectHandle& handle)
+    {
+        getNodes()[handle.hashCode()] = handle;
+    }
+    
+    static void remove(unsigned hashCode)
+    {
+        getNodes().erase(hashCode);
+    }
+    
+    static MString name(const DebugLogRecord& record)
+    {
+        const auto it = getNodes().find(record.node);
+        if (it == getNodes().end() || !it->second.isValid()) return MString(record.name);
+        
+        return MFnDependencyNode(it->second.object()).name();
+    }
+
+private:
+    static std::unordered_map<unsigned, MObjectHandle>& getNodes()
+    {
+        static std::unordered_map<unsigned, MObjectHandle> nodes;
+        return nodes;
+    }
+};
+
+// Debug log file
+// Little endian binary stream, decoded by maya_math_nodes.debug_log:
+//   header: "MMNDLOG" 0, uint32 version
+//   node:   uint8 0, uint32 node id, uint16 name length, name
+//   value:  uint8 1, uint32 node id, float64 frame, uint8 type, payload
+// The payload is an int32 for DebugLogInt and 1, 3, 4 or 16 float64 values otherwise, angles are in radians.
+class DebugLogFile
+{
+public:
+    static constexpr uint32_t kVersion = 1u;
+    
+    bool open(const char* path)
+    {
+        close();
+        
+        stream_.open(path, std::ios::binary | std::ios::trunc);
+        if (!stream_) return false;
+        
+        stream_.write("MMNDLOG", 8);
+        write(kVersion);
+        
+        return bool(stream_);
+    }
+    
+    void close()
+    {
+        if (stream_.is_open())
+        {
+            stream_.close();
+        }
+        
+        nodeIds_.clear();
+    }
+    
+    bool isOpen() const
+    {
+        return stream_.is_open();
+    }
+    
+    // Node ids are keyed by the node handle, the full name of the node is written the first time it is seen
+    void write(const DebugLogRecord& record)
+    {
+        auto it = nodeIds_.find(record.node);
+        if (it == nodeIds_.end())
+        {
+            it = nodeIds_.emplace(record.node, uint32_t(nodeIds_.size())).first;
+            
+            const MString name = DebugLogNodes::name(record);
+            const uint16_t length = uint16_t(std::min(name.length(), 0xffffu));
+            write(uint8_t(0u));
+            write(it->second);
+            write(length);
+            stream_.write(name.asChar(), length);
+        }
+        
+        write(uint8_t(1u));
+        write(it->second);
+        write(record.frame);
+        write(uint8_t(record.type));
+        
+        if (record.type == DebugLogRecord::kInt)
+        {
+            write(int32_t(record.values[0]));
+        }
+        else
+        {
+            stream_.write(reinterpret_cast<const char*>(record.values), record.valueCount() * sizeof(double));
+        }
+    }
+    
+    void flush()
+    {
+        if (stream_.is_open())
+        {
+            stream_.flush();
+        }
+    }
+
+private:
+    template<typename TType>
+    void write(TType value)
+    {
+        stream_.write(reinterpret_cast<const char*>(&value), sizeof(TType));
+    }
+    
+    std::ofstream stream_;
+    std::unordered_map<unsigned, uint32_t> nodeIds_;
+};
+
+// Debug log sink, drains the queue to the script editor and the log file from a main thread timer callback
+class DebugLogSink
+{
+public:
+    static void registerCallback()
+    {
+        getCallbackId() = MTimerMessage::addTimerCallback(0.1f, [](float, float, void*) { flush(); });
+    }
+    
+    static void deregisterCallback()
+    {
+        flush();
+        MMessage::removeCallback(getCallbackId());
+        
+        getFile().close();
+    }
+    
+    static bool openFile(const char* path)
+    {
+        flush();
+        return getFile().open(path);
+    }
+    
+    static void closeFile()
+    {
+        flush();
+        getFile().close();
+    }
+    
+    static void flush()
+    {
+        DebugLogQueue& queue = DebugLogQueue::instance();
+        
+        DebugLogFile& file = getFile();
+        
+        DebugLogRecord record;
+        while (queue.pop(record))
+        {
+            if (record.destination & DebugLogRecord::kConsole)
+            {
+                logToConsole(record, DebugLogNodes::name(record));
+            }
+            
+            if ((record.destination & DebugLogRecord::kFile) && file.isOpen())
+            {
+                file.write(record);
+            }
+        }
+        
+        file.flush();
+        
+        const size_t dropped = queue.takeDropped();
+        if (dropped != 0u)
+        {
+            MGlobal::displayWarning(MString("DebugLog dropped ") + int(dropped) + " records");
+        }
+    }
+
+private:
+    static MCallbackId& getCallbackId()
+    {
+        static MCallbackId callbackId = 0;
+        return callbackId;
+    }
+    
+    static DebugLogFile& getFile()
+    {
+        static DebugLogFile file;
+        return file;
+    }
+};
+
+// mathNodesDebugLog [-flush] [-file path] [-close]
+// Prints the pending debug log records immediately instead of waiting for the timer,
+// and opens or closes the binary file that receives the records of nodes logging to file
+class DebugLogCommand : public MPxCommand
+{
+public:
+    static void* creator()
+    {
+        return new DebugLogCommand();
+    }
+    
+    static MSyntax createSyntax()
+    {
+        MSyntax syntax;
+        syntax.addFlag("-fl", "-flush");
+        syntax.addFlag("-f", "-file", MSyntax::kString);
+        syntax.addFlag("-cl", "-close");
+        
+        return syntax;
+    }
+    
+    MStatus doIt(const MArgList& args) override
+    {
+        MStatus status;
+        MArgDatabase argData(syntax(), args, &status);
+        if (!status) return status;
+        
+        if (argData.isFlagSet("-flush"))
+        {
+            DebugLogSink::flush();
+        }
+        
+        if (argData.isFlagSet("-close"))
+        {
+            DebugLogSink::closeFile();
+        }
+        
+        if (argData.isFlagSet("-file"))
+        {
+            MString path;
+            argData.getFlagArgument("-file", 0, path);
+            
+            if (!DebugLogSink::openFile(path.asChar()))
+            {
+                MGlobal::displayError(MString("Could not open ") + path);
+                return MS::kFailure;
+            }
+        }
+        
+        return MS::kSuccess;
+    }
+};
+
+
+// Sampling state of a debug log node, decides which evaluations are logged
+class DebugLogSampling
+{
+public:
+    bool accept(const DebugLogRecord& record, double interval, int sampleEvery, bool onChange)
+    {
+        // Sampling, every Nth evaluation
+        const unsigned evaluation = evaluationCount_++;
+        if (sampleEvery > 1 && evaluation % unsigned(sampleEvery) != 0u) return false;
+        
+        // Rate limit, at most one record per interval in seconds
+        const auto now = std::chrono::steady_clock::now();
+        if (interval > 0.0 && now - lastLogTime_ < std::chrono::duration<double>(interval)) return false;
+        
+        // Sampling, only when the value differs from the last logged value
+        if (onChange && hasLastValue_ &&
+            std::equal(record.values, record.values + record.valueCount(), lastValues_, almostEquals<double>))
+        {
+            return false;
+        }
+        
+        lastLogTime_ = now;
+        hasLastValue_ = true;
+        std::copy(record.values, record.values + record.valueCount(), lastValues_);
+        
+        return true;
+    }
+
+private:
+    std::chrono::steady_clock::time_point lastLogTime_;
+    unsigned evaluationCount_ = 0u;
+    bool hasLastValue_ = false;
+    double lastValues_[16];
+};
+
+
 template<typename TAttrType, typename TClass, const char* TTypeName>
 class DebugLogNode : public BaseNode<TClass, TTypeName>
 {
@@ -74,9 +593,23 @@ public:
     static MStatus initialize()
     {
         createAttribute(inputAttr_, "input", DefaultValue<TAttrType>());
+        createAttribute(intervalAttr_, "interval", 0.0);
+        createAttribute(sampleEveryAttr_, "sampleEvery", 1);
+        createAttribute(onChangeAttr_, "onChange", false);
         createAttribute(outputAttr_, "output", DefaultValue<TAttrType>(), false);
         
+        MFnEnumAttribute attrFn;
+        destinationAttr_ = attrFn.create("destination", "destination");
+        attrFn.addField("console", DebugLogRecord::kConsole);
+        attrFn.addField("file", DebugLogRecord::kFile);
+        attrFn.addField("consoleAndFile", DebugLogRecord::kConsole | DebugLogRecord::kFile);
+        attrFn.setDefault(DebugLogRecord::kConsole);
+        
         MPxNode::addAttribute(inputAttr_);
+        MPxNode::addAttribute(intervalAttr_);
+        MPxNode::addAttribute(sampleEveryAttr_);
+        MPxNode::addAttribute(onChangeAttr_);
+        MPxNode::addAttribute(destinationAttr_);
         MPxNode::addAttribute(outputAttr_);
         
         MPxNode::attributeAffects(inputAttr_, outputAttr_);
@@ -89,9 +622,38 @@ public:
         if (plug == outputAttr_ || (plug.isChild() && plug.parent() == outputAttr_))
         {
             const auto inputValue = getAttribute<TAttrType>(dataBlock, inputAttr_);
+            const auto intervalValue = getAttribute<double>(dataBlock, intervalAttr_);
+            const auto sampleEveryValue = getAttribute<int>(dataBlock, sampleEveryAttr_);
+            const auto onChangeValue = getAttribute<bool>(dataBlock, onChangeAttr_);
             setAttribute(dataBlock, outputAttr_, inputValue);
             
-            logToConsole(this->name(), inputValue);
+            MDataHandle destinationHandle = dataBlock.inputValue(destinationAttr_);
+            const int destination = destinationHandle.asShort();
+            
+            DebugLogRecord record;
+            toRecord(inputValue, record);
+            
+            // Computes in other contexts, such as cached playback, may run on a background thread while the
+            // normal context evaluates, they sample through their own guarded state
+            if (dataBlock.context().isNormal())
+            {
+                if (!sampling_.accept(record, intervalValue, sampleEveryValue, onChangeValue)) return MS::kSuccess;
+            }
+            else
+            {
+                std::lock_guard<std::mutex> lock(contextSamplingMutex_);
+                if (!contextSampling_.accept(record, intervalValue, sampleEveryValue, onChangeValue)) return MS::kSuccess;
+            }
+            
+            record.destination = destination;
+            record.frame = dataBlock.context().getTime().value();
+            record.node = hashCode_;
+            {
+                std::lock_guard<std::mutex> lock(nameMutex_);
+                std::memcpy(record.name, name_, DebugLogRecord::kMaxNameLength);
+            }
+            
+            DebugLogQueue::instance().push(record);
             
             return MS::kSuccess;
         }
@@ -99,6 +661,24 @@ public:
         return MS::kUnknownParameter;
     }
     
+    void postConstructor() override
+    {
+        MObject node = this->thisMObject();
+        const MObjectHandle handle(node);
+        hashCode_ = handle.hashCode();
+        
+        DebugLogNodes::add(handle);
+        
+        setName(this->name());
+        nameCallbackId_ = MNodeMessage::addNameChangedCallback(node, &onNameChanged, this);
+    }
+    
+    ~DebugLogNode() override
+    {
+        MMessage::removeCallback(nameCallbackId_);
+        DebugLogNodes::remove(hashCode_);
+    }
+    
     MPlug passThroughToOne(const MPlug& plug) const override
     {
         if (plug == inputAttr_)
@@ -110,13 +690,50 @@ public:
     }
 
 private:
+    // The truncated name given to the records is kept up to date on rename, so that computes do not query it
+    static void onNameChanged(MObject& node, const MString&, void* clientData)
+    {
+        static_cast<DebugLogNode*>(clientData)->setName(MFnDependencyNode(node).name());
+    }
+    
+    void setName(const MString& name)
+    {
+        std::lock_guard<std::mutex> lock(nameMutex_);
+        std::strncpy(name_, name.asChar(), DebugLogRecord::kMaxNameLength - 1u);
+        name_[DebugLogRecord::kMaxNameLength - 1u] = '\0';
+    }
+    
     static Attribute inputAttr_;
+    static Attribute intervalAttr_;
+    static Attribute sampleEveryAttr_;
+    static Attribute onChangeAttr_;
+    static Attribute destinationAttr_;
     static Attribute outputAttr_;
+    
+    unsigned hashCode_ = 0u;
+    MCallbackId nameCallbackId_ = 0;
+    char name_[DebugLogRecord::kMaxNameLength] = {};
+    std::mutex nameMutex_;
+    DebugLogSampling sampling_;
+    DebugLogSampling contextSampling_;
+    std::mutex contextSamplingMutex_;
 };
 
 template<typename TAttrType, typename TClass, const char* TTypeName>
 Attribute DebugLogNode<TAttrType, TClass, TTypeName>::inputAttr_;
 
+template<typename TAttrType, typename TClass, const char* TTypeName>
+Attribute DebugLogNode<TAttrType, TClass, TTypeName>::intervalAttr_;
+
+template<typename TAttrType, typename TClass, const char* TTypeName>
+Attribute DebugLogNode<TAttrType, TClass, TTypeName>::sampleEveryAttr_;
+
+template<typename TAttrType, typename TClass, const char* TTypeName>
+Attribute DebugLogNode<TAttrType, TClass, TTypeName>::onChangeAttr_;
+
+template<typename TAttrType, typename TClass, const char* TTypeName>
+Attribute DebugLogNode<TAttrType, TClass, TTypeName>::destinationAttr_;
+
 template<typename TAttrType, typename TClass, const char* TTypeName>
 Attribute DebugLogNode<TAttrType, TClass, TTypeName>::outputAttr_;
 
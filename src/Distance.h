@@ -2,6 +2,8 @@
 // Use of this source code is governed by an MIT license that can be found in the LICENSE file.
 #pragma once
 
+#include "core/Interpolate.h"
+#include "Core.h"
 #include "Utils.h"
 
 template<typename TType>
@@ -10,13 +12,13 @@ inline double distance(const TType& value1, const TType& value2);
 template<>
 inline double distance(const MMatrix& value1, const MMatrix& value2)
 {
-    return (MVector(value1[3]) - MVector(value2[3])).length();
+    return core::distance(toCore(value1), toCore(value2));
 }
 
 template<>
 inline double distance(const MVector& value1, const MVector& value2)
 {
-    return (value1 - value2).length();
+    return core::distance(toCore(value1), toCore(value2));
 }
 
 
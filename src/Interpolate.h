@@ -2,52 +2,83 @@
 // Use of this source code is governed by an MIT license that can be found in the LICENSE file.
 #pragma once
 
+#include <cstring>
+
 #include <maya/MFnEnumAttribute.h>
-#include <maya/MTransformationMatrix.h>
 
+#include "core/Interpolate.h"
+#include "Core.h"
 #include "Utils.h"
 
 template<typename TType>
-inline TType lerp(const TType& value1, const TType& value2, double alpha)
+inline TType lerp(const TType& value1, const TType& value2, double alpha);
+
+template<>
+inline double lerp(const double& value1, const double& value2, double alpha)
+{
+    return core::lerp(value1, value2, alpha);
+}
+
+template<>
+inline MAngle lerp(const MAngle& value1, const MAngle& value2, double alpha)
 {
-    return value1 + (value2 - value1) * alpha;
+    return MAngle(core::lerp(value1.asRadians(), value2.asRadians(), alpha));
+}
+
+template<>
+inline MVector lerp(const MVector& value1, const MVector& value2, double alpha)
+{
+    return toMaya(core::lerp(toCore(value1), toCore(value2), alpha));
 }
 
 template<>
 inline MMatrix lerp(const MMatrix& value1, const MMatrix& value2, double alpha)
 {
-    MTransformationMatrix outXform(MMatrix::identity);
-    const MTransformationMatrix xform1(value1);
-    const MTransformationMatrix xform2(value2);
-    
-    double3 scale1, scale2, outScale;
-    xform1.getScale(scale1, MSpace::kWorld);
-    xform2.getScale(scale2, MSpace::kWorld);
-    
-    outScale[0] = lerp(scale1[0], scale2[0], alpha);
-    outScale[1] = lerp(scale1[1], scale2[1], alpha);
-    outScale[2] = lerp(scale1[2], scale2[2], alpha);
-    
-    double3 shear1, shear2, outShear;
-    xform1.getShear(shear1, MSpace::kWorld);
-    xform2.getShear(shear2, MSpace::kWorld);
-    
-    outShear[0] = lerp(shear1[0], shear2[0], alpha);
-    outShear[1] = lerp(shear1[1], shear2[1], alpha);
-    outShear[2] = lerp(shear1[2], shear2[2], alpha);
-    
-    MQuaternion outQuaternion = slerp(xform1.rotation(), xform2.rotation(), alpha);
-    
-    outXform.setScale(outScale, MSpace::kWorld);
-    outXform.setShear(outShear, MSpace::kWorld);
-    outXform.setRotationQuaternion(outQuaternion.x, outQuaternion.y, outQuaternion.z, outQuaternion.w);
-    outXform.setTranslation(lerp(xform1.getTranslation(MSpace::kWorld),
-                                 xform2.getTranslation(MSpace::kWorld),
-                                 alpha), MSpace::kWorld);
-    
-    return outXform.asMatrix();
+    return toMaya(core::lerp(core::decompose(toCore(value1)), core::decompose(toCore(value2)), alpha));
 }
 
+// Interpolation kernel owned by the lerp nodes
+// Matrices keep the decomposition of each input keyed by the raw bits of the matrix, so that a static input,
+// such as a rest pose, is only decomposed once. The cache holds the inputs of the normal context, evaluations in
+// other contexts may run concurrently with it and call lerp directly.
+template<typename TType>
+struct Lerper
+{
+    TType operator()(const TType& value1, const TType& value2, double alpha) { return lerp(value1, value2, alpha); }
+};
+
+template<>
+struct Lerper<MMatrix>
+{
+    struct Decomposition
+    {
+        MMatrix matrix;
+        core::Transform transform;
+        bool valid = false;
+        
+        const core::Transform& get(const MMatrix& value)
+        {
+            if (!valid || std::memcmp(&matrix, &value, sizeof(MMatrix)) != 0)
+            {
+                matrix = value;
+                transform = core::decompose(toCore(value));
+                valid = true;
+            }
+            
+            return transform;
+        }
+    };
+    
+    MMatrix operator()(const MMatrix& value1, const MMatrix& value2, double alpha)
+    {
+        return toMaya(core::lerp(decomposition1_.get(value1), decomposition2_.get(value2), alpha));
+    }
+
+private:
+    Decomposition decomposition1_;
+    Decomposition decomposition2_;
+};
+
 template<typename TAttrType, typename TClass, const char* TTypeName>
 class LerpNode : public BaseNode<TClass, TTypeName>
 {
@@ -83,7 +114,20 @@ public:
             const auto input2Value = getAttribute<TAttrType>(dataBlock, input2Attr_);
             const auto alphaValue = getAttribute<double>(dataBlock, alphaAttr_);
             
-            setAttribute(dataBlock, outputAttr_, lerp(input1Value, input2Value, alphaValue));
+            if (MemoizeInputs<TAttrType>::value && this->inputsUnchanged(dataBlock, input1Value, input2Value, alphaValue))
+            {
+                dataBlock.setClean(outputAttr_);
+                return MS::kSuccess;
+            }
+            
+            if (dataBlock.context().isNormal())
+            {
+                setAttribute(dataBlock, outputAttr_, lerper_(input1Value, input2Value, alphaValue));
+            }
+            else
+            {
+                setAttribute(dataBlock, outputAttr_, lerp(input1Value, input2Value, alphaValue));
+            }
             
             return MS::kSuccess;
         }
@@ -96,6 +140,8 @@ private:
     static Attribute input2Attr_;
     static Attribute alphaAttr_;
     static Attribute outputAttr_;
+    
+    Lerper<TAttrType> lerper_;
 };
 
 template<typename TAttrType, typename TClass, const char* TTypeName>
@@ -165,7 +211,8 @@ public:
             MDataHandle interpTypeHandle = dataBlock.inputValue(interpTypeAttr_);
             const auto interpType = interpTypeHandle.asShort() * -1;
             
-            setAttribute(dataBlock, outputAttr_, slerp(input1Value, input2Value, alphaValue, interpType));
+            const auto outputValue = core::slerp(toCore(input1Value), toCore(input2Value), alphaValue, interpType);
+            setAttribute(dataBlock, outputAttr_, toMaya(outputValue));
             
             return MS::kSuccess;
         }
@@ -2,8 +2,36 @@
 // Use of this source code is governed by an MIT license that can be found in the LICENSE file.
 #pragma once
 
+#include <type_traits>
+
+#include "core/Matrix.h"
+#include "Core.h"
 #include "Utils.h"
 
+template<typename TType>
+inline TType inverse(const TType& value, bool)
+{
+    return value.inverse();
+}
+
+// Rigid and affine matrices skip the general 4x4 inverse unless strict is set
+template<>
+inline MMatrix inverse(const MMatrix& value, bool strict)
+{
+    if (strict) return value.inverse();
+    
+    const core::Matrix matrix = toCore(value);
+    switch (core::classify(matrix))
+    {
+        case core::MatrixClass::kRigid:
+            return toMaya(core::inverseRigid(matrix));
+        case core::MatrixClass::kAffine:
+            return toMaya(core::inverseAffine(matrix));
+        default:
+            return value.inverse();
+    }
+}
+
 template<typename TAttrType, typename TClass, const char* TTypeName>
 class InverseNode : public BaseNode<TClass, TTypeName>
 {
@@ -18,6 +46,13 @@ public:
         
         MPxNode::attributeAffects(inputAttr_, outputAttr_);
         
+        if (std::is_same<TAttrType, MMatrix>::value)
+        {
+            createAttribute(strictAttr_, "strict", false);
+            MPxNode::addAttribute(strictAttr_);
+            MPxNode::attributeAffects(strictAttr_, outputAttr_);
+        }
+        
         return MS::kSuccess;
     }
     
@@ -26,8 +61,9 @@ public:
         if (plug == outputAttr_ || (plug.isChild() && plug.parent() == outputAttr_))
         {
             const auto inputValue = getAttribute<TAttrType>(dataBlock, inputAttr_);
+            const bool strict = std::is_same<TAttrType, MMatrix>::value && getAttribute<bool>(dataBlock, strictAttr_);
             
-            setAttribute(dataBlock, outputAttr_, inputValue.inverse());
+            setAttribute(dataBlock, outputAttr_, inverse(inputValue, strict));
             
             return MS::kSuccess;
         }
@@ -47,12 +83,16 @@ public:
 
 private:
     static Attribute inputAttr_;
+    static Attribute strictAttr_;
     static Attribute outputAttr_;
 };
 
 template<typename TAttrType, typename TClass, const char* TTypeName>
 Attribute InverseNode<TAttrType, TClass, TTypeName>::inputAttr_;
 
+template<typename TAttrType, typename TClass, const char* TTypeName>
+Attribute InverseNode<TAttrType, TClass, TTypeName>::strictAttr_;
+
 template<typename TAttrType, typename TClass, const char* TTypeName>
 Attribute InverseNode<TAttrType, TClass, TTypeName>::outputAttr_;
 
@@ -2,8 +2,31 @@
 // Use of this source code is governed by an MIT license that can be found in the LICENSE file.
 #pragma once
 
+#include <type_traits>
+
+#include "core/Matrix.h"
+#include "Core.h"
 #include "Utils.h"
 
+template<typename TInOutType, typename TInType>
+inline TInOutType multiply(const TInOutType& value1, const TInType& value2, bool)
+{
+    return TInOutType(value1 * value2);
+}
+
+// Affine matrices skip the projective column of the product unless strict is set
+template<>
+inline MMatrix multiply(const MMatrix& value1, const MMatrix& value2, bool strict)
+{
+    if (strict) return value1 * value2;
+    
+    const core::Matrix matrix1 = toCore(value1);
+    const core::Matrix matrix2 = toCore(value2);
+    if (!core::isAffine(matrix1) || !core::isAffine(matrix2)) return value1 * value2;
+    
+    return toMaya(core::multiplyAffine(matrix1, matrix2));
+}
+
 template<typename TInOutAttrType, typename TInAttrType, typename TClass, const char* TTypeName>
 class MultiplyNode : public BaseNode<TClass, TTypeName>
 {
@@ -21,6 +44,13 @@ public:
         MPxNode::attributeAffects(input1Attr_, outputAttr_);
         MPxNode::attributeAffects(input2Attr_, outputAttr_);
         
+        if (isMatrixProduct)
+        {
+            createAttribute(strictAttr_, "strict", false);
+            MPxNode::addAttribute(strictAttr_);
+            MPxNode::attributeAffects(strictAttr_, outputAttr_);
+        }
+        
         return MS::kSuccess;
     }
     
@@ -30,8 +60,9 @@ public:
         {
             const auto input1Value = getAttribute<TInOutAttrType>(dataBlock, input1Attr_);
             const auto input2Value = getAttribute<TInAttrType>(dataBlock, input2Attr_);
+            const bool strict = isMatrixProduct && getAttribute<bool>(dataBlock, strictAttr_);
             
-            setAttribute(dataBlock, outputAttr_, TInOutAttrType(input1Value * input2Value));
+            setAttribute(dataBlock, outputAttr_, multiply(input1Value, input2Value, strict));
             
             return MS::kSuccess;
         }
@@ -50,8 +81,12 @@ public:
     }
 
 private:
+    static const bool isMatrixProduct = std::is_same<TInOutAttrType, MMatrix>::value &&
+                                        std::is_same<TInAttrType, MMatrix>::value;
+    
     static Attribute input1Attr_;
     static Attribute input2Attr_;
+    static Attribute strictAttr_;
     static Attribute outputAttr_;
 };
 
@@ -61,6 +96,9 @@ Attribute MultiplyNode<TInOutAttrType, TInAttrType, TClass, TTypeName>::input1At
 template<typename TInOutAttrType, typename TInAttrType, typename TClass, const char* TTypeName>
 Attribute MultiplyNode<TInOutAttrType, TInAttrType, TClass, TTypeName>::input2Attr_;
 
+template<typename TInOutAttrType, typename TInAttrType, typename TClass, const char* TTypeName>
+Attribute MultiplyNode<TInOutAttrType, TInAttrType, TClass, TTypeName>::strictAttr_;
+
 template<typename TInOutAttrType, typename TInAttrType, typename TClass, const char* TTypeName>
 Attribute MultiplyNode<TInOutAttrType, TInAttrType, TClass, TTypeName>::outputAttr_;
 
@@ -5,6 +5,7 @@
 #include "Absolute.h"
 #include "Add.h"
 #include "Array.h"
+#include "ArrayData.h"
 #include "Clamp.h"
 #include "Condition.h"
 #include "Convert.h"
@@ -16,17 +17,24 @@
 #include "Multiply.h"
 #include "Negate.h"
 #include "Power.h"
+#include "Profiling.h"
 #include "Round.h"
+#include "Stats.h"
 #include "Subtract.h"
+#include "Trace.h"
 #include "Trig.h"
 #include "Twist.h"
 #include "VectorOps.h"
+#include "core/Simd.h"
 
 MStatus
 initializePlugin(MObject pluginObj)
 {
     MFnPlugin pluginFn(pluginObj, "Serguei Kalentchouk, et al.", PROJECT_VERSION, "Any");
     
+    NodeProfiler::registerCategory();
+    core::selectInstructionSet(core::supportedInstructionSet());
+    
     int typeId = 0x0012c340;
     
     // 1.0.0
@@ -189,6 +197,48 @@ initializePlugin(MObject pluginObj)
     RotateVectorByQuaternion::registerNode(pluginFn, typeId++);
     RotateVectorByRotation::registerNode(pluginFn, typeId++);
     
+    // 1.7.0
+    PackedArrayData::registerData(pluginFn, typeId++);
+    AverageDoubleArrayData::registerNode(pluginFn, typeId++);
+    AverageMatrixArrayData::registerNode(pluginFn, typeId++);
+    AveragePackedArray::registerNode(pluginFn, typeId++);
+    AveragePackedMatrixArray::registerNode(pluginFn, typeId++);
+    AveragePackedQuaternionArray::registerNode(pluginFn, typeId++);
+    AveragePackedRotationArray::registerNode(pluginFn, typeId++);
+    AveragePackedVectorArray::registerNode(pluginFn, typeId++);
+    AverageVectorArrayData::registerNode(pluginFn, typeId++);
+    MaxElementDoubleArrayData::registerNode(pluginFn, typeId++);
+    MinElementDoubleArrayData::registerNode(pluginFn, typeId++);
+    NormalizeDoubleArrayData::registerNode(pluginFn, typeId++);
+    NormalizePackedArray::registerNode(pluginFn, typeId++);
+    NormalizeWeightsDoubleArrayData::registerNode(pluginFn, typeId++);
+    NormalizeWeightsPackedArray::registerNode(pluginFn, typeId++);
+    PackArray::registerNode(pluginFn, typeId++);
+    PackMatrixArray::registerNode(pluginFn, typeId++);
+    PackQuaternionArray::registerNode(pluginFn, typeId++);
+    PackRotationArray::registerNode(pluginFn, typeId++);
+    PackVectorArray::registerNode(pluginFn, typeId++);
+    SelectDoubleArrayData::registerNode(pluginFn, typeId++);
+    SelectMatrixArrayData::registerNode(pluginFn, typeId++);
+    SelectPackedArray::registerNode(pluginFn, typeId++);
+    SelectVectorArrayData::registerNode(pluginFn, typeId++);
+    SumDoubleArrayData::registerNode(pluginFn, typeId++);
+    SumVectorArrayData::registerNode(pluginFn, typeId++);
+    UnpackArray::registerNode(pluginFn, typeId++);
+    UnpackMatrixArray::registerNode(pluginFn, typeId++);
+    UnpackQuaternionArray::registerNode(pluginFn, typeId++);
+    UnpackRotationArray::registerNode(pluginFn, typeId++);
+    UnpackVectorArray::registerNode(pluginFn, typeId++);
+    WeightedAverageDoubleArrayData::registerNode(pluginFn, typeId++);
+    WeightedAverageMatrixArrayData::registerNode(pluginFn, typeId++);
+    WeightedAverageVectorArrayData::registerNode(pluginFn, typeId++);
+    
+    pluginFn.registerCommand("mathNodesStats", StatsCommand::creator, StatsCommand::createSyntax);
+    pluginFn.registerCommand("mathNodesTrace", TraceCommand::creator, TraceCommand::createSyntax);
+    pluginFn.registerCommand("mathNodesDebugLog", DebugLogCommand::creator, DebugLogCommand::createSyntax);
+    
+    DebugLogSink::registerCallback();
+    
     return MS::kSuccess;
 }
 
@@ -350,6 +400,50 @@ uninitializePlugin(MObject pluginObj)
     RotateVectorByMatrix::deregisterNode(pluginFn);
     RotateVectorByQuaternion::deregisterNode(pluginFn);
     RotateVectorByRotation::deregisterNode(pluginFn);
+    AverageDoubleArrayData::deregisterNode(pluginFn);
+    AverageMatrixArrayData::deregisterNode(pluginFn);
+    AveragePackedArray::deregisterNode(pluginFn);
+    AveragePackedMatrixArray::deregisterNode(pluginFn);
+    AveragePackedQuaternionArray::deregisterNode(pluginFn);
+    AveragePackedRotationArray::deregisterNode(pluginFn);
+    AveragePackedVectorArray::deregisterNode(pluginFn);
+    AverageVectorArrayData::deregisterNode(pluginFn);
+    MaxElementDoubleArrayData::deregisterNode(pluginFn);
+    MinElementDoubleArrayData::deregisterNode(pluginFn);
+    NormalizeDoubleArrayData::deregisterNode(pluginFn);
+    NormalizePackedArray::deregisterNode(pluginFn);
+    NormalizeWeightsDoubleArrayData::deregisterNode(pluginFn);
+    NormalizeWeightsPackedArray::deregisterNode(pluginFn);
+    PackArray::deregisterNode(pluginFn);
+    PackMatrixArray::deregisterNode(pluginFn);
+    PackQuaternionArray::deregisterNode(pluginFn);
+    PackRotationArray::deregisterNode(pluginFn);
+    PackVectorArray::deregisterNode(pluginFn);
+    SelectDoubleArrayData::deregisterNode(pluginFn);
+    SelectMatrixArrayData::deregisterNode(pluginFn);
+    SelectPackedArray::deregisterNode(pluginFn);
+    SelectVectorArrayData::deregisterNode(pluginFn);
+    SumDoubleArrayData::deregisterNode(pluginFn);
+    SumVectorArrayData::deregisterNode(pluginFn);
+    UnpackArray::deregisterNode(pluginFn);
+    UnpackMatrixArray::deregisterNode(pluginFn);
+    UnpackQuaternionArray::deregisterNode(pluginFn);
+    UnpackRotationArray::deregisterNode(pluginFn);
+    UnpackVectorArray::deregisterNode(pluginFn);
+    WeightedAverageDoubleArrayData::deregisterNode(pluginFn);
+    WeightedAverageMatrixArrayData::deregisterNode(pluginFn);
+    WeightedAverageVectorArrayData::deregisterNode(pluginFn);
+    
+    // Data types are deregistered once no node uses them
+    PackedArrayData::deregisterData(pluginFn);
+    
+    pluginFn.deregisterCommand("mathNodesStats");
+    pluginFn.deregisterCommand("mathNodesTrace");
+    pluginFn.deregisterCommand("mathNodesDebugLog");
+    
+    DebugLogSink::deregisterCallback();
+    
+    NodeProfiler::deregisterCategory();
     
     return MS::kSuccess;
 }
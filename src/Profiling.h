@@ -0,0 +1,90 @@
+// Copyright (c) 2018-2023 Serguei Kalentchouk et al. All rights reserved.
+// Use of this source code is governed by an MIT license that can be found in the LICENSE file.
+#pragma once
+
+#include <atomic>
+
+#include <maya/MProfiler.h>
+
+// Maya Profiler integration
+// Every math node compute is recorded as an event named after the node type in the "Math Nodes" category.
+// The detailed mode additionally records every data block read and write as nested events, the time spent
+// in the math kernel is the self time of the compute event.
+class NodeProfiler
+{
+public:
+    static void registerCategory()
+    {
+        getCategory() = MProfiler::addCategory("Math Nodes", "Math node evaluation");
+    }
+
+    static void deregisterCategory()
+    {
+        MProfiler::removeCategory("Math Nodes");
+        getCategory() = -1;
+    }
+
+    static int category()
+    {
+        return getCategory();
+    }
+
+    static bool isDetailed()
+    {
+        return getDetailed().load(std::memory_order_relaxed);
+    }
+
+    static void setDetailed(bool state)
+    {
+        getDetailed().store(state, std::memory_order_relaxed);
+    }
+
+private:
+    static int& getCategory()
+    {
+        static int category = -1;
+        return category;
+    }
+
+    static std::atomic<bool>& getDetailed()
+    {
+        static std::atomic<bool> detailed{false};
+        return detailed;
+    }
+};
+
+// Data block access event, only recorded in the detailed mode
+class ProfilingStage
+{
+public:
+    enum Stage
+    {
+        kRead,
+        kWrite
+    };
+
+    explicit ProfilingStage(Stage stage)
+        : eventId_(-1)
+    {
+        if (NodeProfiler::isDetailed() && MProfiler::isRecordingActive())
+        {
+            eventId_ = stage == kRead
+                ? MProfiler::eventBegin(NodeProfiler::category(), MProfiler::kColorC_L2, "Read inputs")
+                : MProfiler::eventBegin(NodeProfiler::category(), MProfiler::kColorD_L2, "Write outputs");
+        }
+    }
+
+    ~ProfilingStage()
+    {
+        if (eventId_ >= 0)
+        {
+            MProfiler::eventEnd(eventId_);
+        }
+    }
+
+    ProfilingStage(const ProfilingStage&) = delete;
+    ProfilingStage& operator=(const ProfilingStage&) = delete;
+
+private:
+    int eventId_;
+};
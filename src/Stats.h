@@ -0,0 +1,285 @@
+// Copyright (c) 2018-2023 Serguei Kalentchouk et al. All rights reserved.
+// Use of this source code is governed by an MIT license that can be found in the LICENSE file.
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <maya/MArgDatabase.h>
+#include <maya/MArgList.h>
+#include <maya/MPxCommand.h>
+#include <maya/MStringArray.h>
+#include <maya/MSyntax.h>
+
+#include "Profiling.h"
+
+// Per node type compute statistics
+// Every thread records into its own block of counters, only the owning thread writes to a block so the
+// counters are relaxed atomics and recording never takes a lock. Blocks are merged when queried.
+// A reset bumps the global epoch, a block is cleared by its owner the next time it records and blocks
+// from an older epoch are skipped when merging. Blocks are kept for the lifetime of the process.
+class ComputeStats
+{
+public:
+    static constexpr unsigned kMaxNodeTypes = 512u;
+
+    struct Entry
+    {
+        std::string typeName;
+        uint64_t calls = 0u;
+        uint64_t unknownParameter = 0u;
+        uint64_t totalNs = 0u;
+        uint64_t maxNs = 0u;
+    };
+
+    // Returns the slot of the node type, types past kMaxNodeTypes get an invalid slot and are not recorded
+    static unsigned registerNodeType(const std::string& typeName)
+    {
+        State& state = getState();
+        std::lock_guard<std::mutex> lock(state.mutex);
+
+        const auto it = std::find(state.typeNames.begin(), state.typeNames.end(), typeName);
+        if (it != state.typeNames.end()) return unsigned(it - state.typeNames.begin());
+
+        if (state.typeNames.size() >= kMaxNodeTypes) return kMaxNodeTypes;
+
+        state.typeNames.push_back(typeName);
+        return unsigned(state.typeNames.size() - 1u);
+    }
+
+    static bool isEnabled()
+    {
+        return getState().enabled.load(std::memory_order_relaxed);
+    }
+
+    static void setEnabled(bool state)
+    {
+        getState().enabled.store(state, std::memory_order_relaxed);
+    }
+
+    static void reset()
+    {
+        getState().epoch.fetch_add(1u, std::memory_order_relaxed);
+    }
+
+    static void record(unsigned slot, const MStatus& status, uint64_t nanoseconds)
+    {
+        if (slot >= kMaxNodeTypes) return;
+
+        Block& block = getThreadBlock();
+
+        const unsigned epoch = getState().epoch.load(std::memory_order_relaxed);
+        if (block.epoch.load(std::memory_order_relaxed) != epoch)
+        {
+            for (Counters& counters : block.counters)
+            {
+                counters.calls.store(0u, std::memory_order_relaxed);
+                counters.unknownParameter.store(0u, std::memory_order_relaxed);
+                counters.totalNs.store(0u, std::memory_order_relaxed);
+                counters.maxNs.store(0u, std::memory_order_relaxed);
+            }
+
+            block.epoch.store(epoch, std::memory_order_release);
+        }
+
+        Counters& counters = block.counters[slot];
+        counters.calls.store(counters.calls.load(std::memory_order_relaxed) + 1u, std::memory_order_relaxed);
+        counters.totalNs.store(counters.totalNs.load(std::memory_order_relaxed) + nanoseconds, std::memory_order_relaxed);
+
+        if (nanoseconds > counters.maxNs.load(std::memory_order_relaxed))
+        {
+            counters.maxNs.store(nanoseconds, std::memory_order_relaxed);
+        }
+
+        if (status == MS::kUnknownParameter)
+        {
+            counters.unknownParameter.store(counters.unknownParameter.load(std::memory_order_relaxed) + 1u,
+                                            std::memory_order_relaxed);
+        }
+    }
+
+    // Returns the merged statistics of the node types that were computed since the last reset
+    static std::vector<Entry> query()
+    {
+        State& state = getState();
+        std::lock_guard<std::mutex> lock(state.mutex);
+
+        std::vector<Entry> entries(state.typeNames.size());
+        for (size_t i = 0u; i < entries.size(); ++i)
+        {
+            entries[i].typeName = state.typeNames[i];
+        }
+
+        const unsigned epoch = state.epoch.load(std::memory_order_relaxed);
+        for (const Block* block : state.blocks)
+        {
+            if (block->epoch.load(std::memory_order_acquire) != epoch) continue;
+
+            for (size_t i = 0u; i < entries.size(); ++i)
+            {
+                const Counters& counters = block->counters[i];
+                entries[i].calls += counters.calls.load(std::memory_order_relaxed);
+                entries[i].unknownParameter += counters.unknownParameter.load(std::memory_order_relaxed);
+                entries[i].totalNs += counters.totalNs.load(std::memory_order_relaxed);
+                entries[i].maxNs = std::max(entries[i].maxNs, uint64_t(counters.maxNs.load(std::memory_order_relaxed)));
+            }
+        }
+
+        entries.erase(std::remove_if(entries.begin(), entries.end(), [](const Entry& entry) { return entry.calls == 0u; }),
+                      entries.end());
+        std::stable_sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.totalNs > b.totalNs; });
+
+        return entries;
+    }
+
+private:
+    struct Counters
+    {
+        std::atomic<uint64_t> calls{0u};
+        std::atomic<uint64_t> unknownParameter{0u};
+        std::atomic<uint64_t> totalNs{0u};
+        std::atomic<uint64_t> maxNs{0u};
+    };
+
+    struct Block
+    {
+        std::atomic<unsigned> epoch{0u};
+        Counters counters[kMaxNodeTypes];
+    };
+
+    struct State
+    {
+        std::atomic<bool> enabled{false};
+        std::atomic<unsigned> epoch{0u};
+        std::mutex mutex;
+        std::vector<std::string> typeNames;
+        std::vector<Block*> blocks;
+    };
+
+    static State& getState()
+    {
+        static State state;
+        return state;
+    }
+
+    static Block& getThreadBlock()
+    {
+        static thread_local Block* block = nullptr;
+        if (block == nullptr)
+        {
+            block = new Block();
+
+            State& state = getState();
+            std::lock_guard<std::mutex> lock(state.mutex);
+            state.blocks.push_back(block);
+        }
+
+        return *block;
+    }
+};
+
+// mathNodesStats [-enable bool] [-reset] [-list] [-json] [-profileIO bool]
+// The -profileIO flag toggles the detailed Maya Profiler mode, without flags the command behaves as -list, the results are sorted by total compute time
+class StatsCommand : public MPxCommand
+{
+public:
+    static void* creator()
+    {
+        return new StatsCommand();
+    }
+
+    static MSyntax createSyntax()
+    {
+        MSyntax syntax;
+        syntax.addFlag("-en", "-enable", MSyntax::kBoolean);
+        syntax.addFlag("-rst", "-reset");
+        syntax.addFlag("-ls", "-list");
+        syntax.addFlag("-js", "-json");
+        syntax.addFlag("-pio", "-profileIO", MSyntax::kBoolean);
+
+        return syntax;
+    }
+
+    MStatus doIt(const MArgList& args) override
+    {
+        MStatus status;
+        MArgDatabase argData(syntax(), args, &status);
+        if (!status) return status;
+
+        const bool enable = argData.isFlagSet("-enable");
+        const bool reset = argData.isFlagSet("-reset");
+        const bool json = argData.isFlagSet("-json");
+        const bool profileIO = argData.isFlagSet("-profileIO");
+        const bool list = argData.isFlagSet("-list") || (!enable && !reset && !json && !profileIO);
+
+        if (enable)
+        {
+            bool state = false;
+            argData.getFlagArgument("-enable", 0, state);
+            ComputeStats::setEnabled(state);
+            setResult(state);
+        }
+
+        if (profileIO)
+        {
+            bool state = false;
+            argData.getFlagArgument("-profileIO", 0, state);
+            NodeProfiler::setDetailed(state);
+            setResult(state);
+        }
+
+        if (reset)
+        {
+            ComputeStats::reset();
+        }
+
+        if (json)
+        {
+            setResult(toJson(ComputeStats::query()));
+        }
+        else if (list)
+        {
+            MStringArray result;
+            for (const ComputeStats::Entry& entry : ComputeStats::query())
+            {
+                char buffer[256];
+                std::snprintf(buffer, sizeof(buffer), "%s calls=%llu total_ms=%.3f max_ms=%.3f unknown_parameter=%llu",
+                              entry.typeName.c_str(), (unsigned long long)entry.calls, entry.totalNs * 1.0e-6,
+                              entry.maxNs * 1.0e-6, (unsigned long long)entry.unknownParameter);
+                result.append(buffer);
+            }
+
+            setResult(result);
+        }
+
+        return MS::kSuccess;
+    }
+
+private:
+    static MString toJson(const std::vector<ComputeStats::Entry>& entries)
+    {
+        std::string out = "{\"nodes\": [";
+
+        for (size_t i = 0u; i < entries.size(); ++i)
+        {
+            const ComputeStats::Entry& entry = entries[i];
+
+            char buffer[256];
+            std::snprintf(buffer, sizeof(buffer),
+                          "%s{\"type\": \"%s\", \"calls\": %llu, \"total_ns\": %llu, \"max_ns\": %llu, \"unknown_parameter\": %llu}",
+                          i != 0u ? ", " : "", entry.typeName.c_str(), (unsigned long long)entry.calls,
+                          (unsigned long long)entry.totalNs, (unsigned long long)entry.maxNs,
+                          (unsigned long long)entry.unknownParameter);
+            out += buffer;
+        }
+
+        out += "]}";
+
+        return MString(out.c_str());
+    }
+};
@@ -0,0 +1,249 @@
+// Copyright (c) 2018-2023 Serguei Kalentchouk et al. All rights reserved.
+// Use of this source code is governed by an MIT license that can be found in the LICENSE file.
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <maya/MArgDatabase.h>
+#include <maya/MArgList.h>
+#include <maya/MGlobal.h>
+#include <maya/MPxCommand.h>
+#include <maya/MString.h>
+#include <maya/MSyntax.h>
+
+// Compute timeline
+// Every thread records the computes it runs into its own ring buffer, the oldest events are overwritten once
+// the buffer is full. Only the owning thread writes to a buffer, readers copy the events and then discard
+// those that the owner may have overwritten while they were being copied.
+class ComputeTrace
+{
+public:
+    static constexpr unsigned kCapacity = 16384u;
+    static constexpr unsigned kMaxNameLength = 64u;
+
+    struct Event
+    {
+        const char* typeName;
+        char nodeName[kMaxNameLength];
+        int64_t beginNs;
+        int64_t endNs;
+    };
+
+    static bool isEnabled()
+    {
+        return getState().enabled.load(std::memory_order_relaxed);
+    }
+
+    static void setEnabled(bool state)
+    {
+        getState().enabled.store(state, std::memory_order_relaxed);
+    }
+
+    // Discards the recorded events, buffers are cleared by their owner the next time they record
+    static void clear()
+    {
+        getState().epoch.fetch_add(1u, std::memory_order_relaxed);
+    }
+
+    static void record(const char* typeName, const MString& nodeName,
+                       std::chrono::steady_clock::time_point begin, std::chrono::steady_clock::time_point end)
+    {
+        Buffer& buffer = getThreadBuffer();
+
+        const unsigned epoch = getState().epoch.load(std::memory_order_relaxed);
+        if (buffer.epoch.load(std::memory_order_relaxed) != epoch)
+        {
+            buffer.head.store(0u, std::memory_order_relaxed);
+            buffer.epoch.store(epoch, std::memory_order_release);
+        }
+
+        const uint64_t head = buffer.head.load(std::memory_order_relaxed);
+
+        Event& event = buffer.events[head % kCapacity];
+        event.typeName = typeName;
+        std::strncpy(event.nodeName, nodeName.asChar(), kMaxNameLength - 1u);
+        event.nodeName[kMaxNameLength - 1u] = '\0';
+        event.beginNs = std::chrono::duration_cast<std::chrono::nanoseconds>(begin.time_since_epoch()).count();
+        event.endNs = std::chrono::duration_cast<std::chrono::nanoseconds>(end.time_since_epoch()).count();
+
+        buffer.head.store(head + 1u, std::memory_order_release);
+    }
+
+    // Writes the recorded events in the Chrome trace event format, each buffer is reported as a separate thread
+    static std::string toJson()
+    {
+        State& state = getState();
+        std::lock_guard<std::mutex> lock(state.mutex);
+
+        std::vector<std::vector<Event>> threads;
+        int64_t origin = std::numeric_limits<int64_t>::max();
+
+        const unsigned epoch = state.epoch.load(std::memory_order_relaxed);
+        for (const Buffer* buffer : state.buffers)
+        {
+            threads.emplace_back();
+            if (buffer->epoch.load(std::memory_order_acquire) != epoch) continue;
+
+            const uint64_t head = buffer->head.load(std::memory_order_acquire);
+            const uint64_t first = head > kCapacity ? head - kCapacity : 0u;
+
+            std::vector<Event>& events = threads.back();
+            events.reserve(size_t(head - first));
+            for (uint64_t index = first; index < head; ++index)
+            {
+                events.push_back(buffer->events[index % kCapacity]);
+            }
+
+            // Events at or below the slot being written after the copy may have been overwritten
+            const uint64_t headAfter = buffer->head.load(std::memory_order_acquire);
+            const uint64_t valid = headAfter >= kCapacity ? headAfter - kCapacity + 1u : 0u;
+            if (valid > first)
+            {
+                events.erase(events.begin(), events.begin() + std::min(size_t(valid - first), events.size()));
+            }
+
+            for (const Event& event : events)
+            {
+                origin = std::min(origin, event.beginNs);
+            }
+        }
+
+        std::string out = "{\"traceEvents\": [";
+
+        bool first = true;
+        char buffer[256];
+        for (size_t thread = 0u; thread < threads.size(); ++thread)
+        {
+            std::snprintf(buffer, sizeof(buffer),
+                          "%s\n{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": %u, \"args\": {\"name\": \"Thread %u\"}}",
+                          first ? "" : ",", unsigned(thread), unsigned(thread));
+            out += buffer;
+            first = false;
+
+            for (const Event& event : threads[thread])
+            {
+                std::snprintf(buffer, sizeof(buffer),
+                              ",\n{\"name\": \"%s\", \"cat\": \"%s\", \"ph\": \"X\", \"pid\": 1, \"tid\": %u, \"ts\": %.3f, \"dur\": %.3f}",
+                              event.nodeName, event.typeName, unsigned(thread),
+                              (event.beginNs - origin) * 1.0e-3, (event.endNs - event.beginNs) * 1.0e-3);
+                out += buffer;
+            }
+        }
+
+        out += "\n], \"displayTimeUnit\": \"ns\"}\n";
+
+        return out;
+    }
+
+private:
+    struct Buffer
+    {
+        std::atomic<unsigned> epoch{0u};
+        std::atomic<uint64_t> head{0u};
+        Event events[kCapacity];
+    };
+
+    struct State
+    {
+        std::atomic<bool> enabled{false};
+        std::atomic<unsigned> epoch{0u};
+        std::mutex mutex;
+        std::vector<Buffer*> buffers;
+    };
+
+    static State& getState()
+    {
+        static State state;
+        return state;
+    }
+
+    static Buffer& getThreadBuffer()
+    {
+        static thread_local Buffer* buffer = nullptr;
+        if (buffer == nullptr)
+        {
+            buffer = new Buffer();
+
+            State& state = getState();
+            std::lock_guard<std::mutex> lock(state.mutex);
+            state.buffers.push_back(buffer);
+        }
+
+        return *buffer;
+    }
+};
+
+// mathNodesTrace [-enable bool] [-clear] [-file path] [-json]
+// Writes the recorded timeline to the given file, or returns it with -json
+class TraceCommand : public MPxCommand
+{
+public:
+    static void* creator()
+    {
+        return new TraceCommand();
+    }
+
+    static MSyntax createSyntax()
+    {
+        MSyntax syntax;
+        syntax.addFlag("-en", "-enable", MSyntax::kBoolean);
+        syntax.addFlag("-clr", "-clear");
+        syntax.addFlag("-f", "-file", MSyntax::kString);
+        syntax.addFlag("-js", "-json");
+
+        return syntax;
+    }
+
+    MStatus doIt(const MArgList& args) override
+    {
+        MStatus status;
+        MArgDatabase argData(syntax(), args, &status);
+        if (!status) return status;
+
+        if (argData.isFlagSet("-enable"))
+        {
+            bool state = false;
+            argData.getFlagArgument("-enable", 0, state);
+            ComputeTrace::setEnabled(state);
+            setResult(state);
+        }
+
+        if (argData.isFlagSet("-file"))
+        {
+            MString path;
+            argData.getFlagArgument("-file", 0, path);
+
+            std::ofstream stream(path.asChar());
+            if (!stream)
+            {
+                MGlobal::displayError(MString("Could not open ") + path);
+                return MS::kFailure;
+            }
+
+            stream << ComputeTrace::toJson();
+            setResult(path);
+        }
+
+        if (argData.isFlagSet("-json"))
+        {
+            setResult(MString(ComputeTrace::toJson().c_str()));
+        }
+
+        if (argData.isFlagSet("-clear"))
+        {
+            ComputeTrace::clear();
+        }
+
+        return MS::kSuccess;
+    }
+};
@@ -3,11 +3,27 @@
 #pragma once
 
 #include <maya/MFnEnumAttribute.h>
-#include <maya/MTransformationMatrix.h>
 
-#include "Convert.h"
+#include "core/Interpolate.h"
+#include "core/Rotation.h"
+#include "Core.h"
 #include "Utils.h"
 
+template<typename TInType>
+inline core::Quaternion getTwistRotation(const TInType& value, MEulerRotation::RotationOrder rotationOrder);
+
+template<>
+inline core::Quaternion getTwistRotation(const MEulerRotation& value, MEulerRotation::RotationOrder rotationOrder)
+{
+    return core::toQuaternion(core::EulerRotation{value.x, value.y, value.z, core::RotationOrder(rotationOrder)});
+}
+
+template<>
+inline core::Quaternion getTwistRotation(const MMatrix& value, MEulerRotation::RotationOrder)
+{
+    return core::decompose(toCore(value)).rotation;
+}
+
 template<typename TInAttrType, typename TClass, const char* TTypeName>
 class GetTwistNode : public BaseNode<TClass, TTypeName>
 {
@@ -47,36 +63,14 @@ public:
             MDataHandle axisHandle = dataBlock.inputValue(axisAttr_);
             const auto axis = axisHandle.asShort();
             
-            auto quaternion = getRotation<TInAttrType, MQuaternion>(inputValue, rotationOrder);
-            
-            double angle = 0.0;
-            switch (axis)
+            if (MemoizeInputs<TInAttrType>::value && this->inputsUnchanged(dataBlock, inputValue, rotationOrder, axis))
             {
-                case 0:
-                {
-                    quaternion.y = 0.0;
-                    quaternion.z = 0.0;
-                    angle = quaternion.asEulerRotation().x;
-                    break;
-                }
-                case 1:
-                {
-                    quaternion.x = 0.0;
-                    quaternion.z = 0.0;
-                    angle = quaternion.asEulerRotation().y;
-                    break;
-                }
-                case 2:
-                {
-                    quaternion.x = 0.0;
-                    quaternion.y = 0.0;
-                    angle = quaternion.asEulerRotation().z;
-                    break;
-                }
-                default:
-                    break;
+                dataBlock.setClean(outputAttr_);
+                return MS::kSuccess;
             }
             
+            const double angle = core::twist(getTwistRotation(inputValue, rotationOrder), unsigned(axis));
+            
             setAttribute(dataBlock, outputAttr_, angle);
             
             return MS::kSuccess;
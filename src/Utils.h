@@ -3,7 +3,10 @@
 #pragma once
 
 #include <algorithm>
+#include <chrono>
 #include <cmath>
+#include <cstring>
+#include <iterator>
 #include <limits>
 #include <string>
 #include <type_traits>
@@ -11,20 +14,32 @@
 
 #include <maya/MAngle.h>
 #include <maya/MArrayDataBuilder.h>
+#include <maya/MDGContext.h>
+#include <maya/MDoubleArray.h>
 #include <maya/MEulerRotation.h>
 #include <maya/MGlobal.h>
 #include <maya/MMatrix.h>
 #include <maya/MFnCompoundAttribute.h>
 #include <maya/MFnDependencyNode.h>
+#include <maya/MFnDoubleArrayData.h>
 #include <maya/MFnEnumAttribute.h>
+#include <maya/MFnMatrixArrayData.h>
 #include <maya/MFnMatrixAttribute.h>
 #include <maya/MFnNumericAttribute.h>
 #include <maya/MFnTypedAttribute.h>
 #include <maya/MFnUnitAttribute.h>
+#include <maya/MFnVectorArrayData.h>
+#include <maya/MMatrixArray.h>
+#include <maya/MPlug.h>
 #include <maya/MPxNode.h>
 #include <maya/MVector.h>
+#include <maya/MVectorArray.h>
 #include <maya/MQuaternion.h>
 
+#include "Profiling.h"
+#include "Stats.h"
+#include "Trace.h"
+
 #ifdef __APPLE__
     #define TEMPLATE_PARAMETER_LINKAGE constexpr
 #else
@@ -90,6 +105,53 @@ inline MEulerRotation DefaultValue(double x, double y, double z)
     return MEulerRotation(x, y, z);
 }
 
+// Typed array data type that holds an array of values
+template <typename TType>
+inline MFnData::Type ArrayDataType();
+
+template <>
+inline MFnData::Type ArrayDataType<double>()
+{
+    return MFnData::kDoubleArray;
+}
+
+template <>
+inline MFnData::Type ArrayDataType<MVector>()
+{
+    return MFnData::kVectorArray;
+}
+
+template <>
+inline MFnData::Type ArrayDataType<MMatrix>()
+{
+    return MFnData::kMatrixArray;
+}
+
+// Maya array and function set of the typed array data holding a type
+template <typename TType>
+struct ArrayDataTraits;
+
+template <>
+struct ArrayDataTraits<double>
+{
+    typedef MDoubleArray Array;
+    typedef MFnDoubleArrayData FnData;
+};
+
+template <>
+struct ArrayDataTraits<MVector>
+{
+    typedef MVectorArray Array;
+    typedef MFnVectorArrayData FnData;
+};
+
+template <>
+struct ArrayDataTraits<MMatrix>
+{
+    typedef MMatrixArray Array;
+    typedef MFnMatrixArrayData FnData;
+};
+
 
 // Math helper functions
 template <typename TType>
@@ -278,8 +340,25 @@ inline void createAttribute(Attribute& attr, const char* name, const MEulerRotat
 
 inline void createAttribute(Attribute& attr, const char* name, MFnData::Type type, bool isInput = true, bool isArray = false)
 {
+    // Typed array data defaults to an empty array so that unconnected inputs read as empty
+    MObject defaultValue;
+    switch (type)
+    {
+        case MFnData::kDoubleArray:
+            defaultValue = MFnDoubleArrayData().create();
+            break;
+        case MFnData::kVectorArray:
+            defaultValue = MFnVectorArrayData().create();
+            break;
+        case MFnData::kMatrixArray:
+            defaultValue = MFnMatrixArrayData().create();
+            break;
+        default:
+            break;
+    }
+    
     MFnTypedAttribute attrFn;
-    attr.attr = attrFn.create(name, name, type);
+    attr.attr = attrFn.create(name, name, type, defaultValue);
     attrFn.setKeyable(isInput);
     attrFn.setStorable(isInput);
     attrFn.setWritable(isInput);
@@ -322,6 +401,126 @@ inline void createRotationOrderAttribute(Attribute& attr)
 }
 
 
+// Template specializations for getValue, reads a single value from a data handle
+// Compound values read their children through the given attribute
+template <typename TType>
+inline TType getValue(MDataHandle& handle, const Attribute& attribute);
+
+template <>
+inline double getValue(MDataHandle& handle, const Attribute&)
+{
+    return handle.asDouble();
+}
+
+template <>
+inline int getValue(MDataHandle& handle, const Attribute&)
+{
+    return handle.asInt();
+}
+
+template <>
+inline MAngle getValue(MDataHandle& handle, const Attribute&)
+{
+    return handle.asAngle();
+}
+
+template <>
+inline MVector getValue(MDataHandle& handle, const Attribute&)
+{
+    return handle.asVector();
+}
+
+template <>
+inline MMatrix getValue(MDataHandle& handle, const Attribute&)
+{
+    return handle.asMatrix();
+}
+
+// Rotations are numeric compounds so all three angles are read in internal units, radians, with a single call
+template <>
+inline MEulerRotation getValue(MDataHandle& handle, const Attribute&)
+{
+    const double3& value = handle.asDouble3();
+    
+    return MEulerRotation(value[0], value[1], value[2]);
+}
+
+// Quaternions are generic compounds, their children are looked up on the one parent handle
+template <>
+inline MQuaternion getValue(MDataHandle& handle, const Attribute& attribute)
+{
+    const double x = handle.child(attribute.attrX).asDouble();
+    const double y = handle.child(attribute.attrY).asDouble();
+    const double z = handle.child(attribute.attrZ).asDouble();
+    const double w = handle.child(attribute.attrW).asDouble();
+    
+    return MQuaternion(x, y, z, w);
+}
+
+
+// Non-owning view over the elements of an input array attribute
+// Elements are read from the data block as they are iterated, the view is single pass since iterating
+// advances the underlying array handle. With a child attribute the view reads that child of each element.
+template <typename TType>
+class ArrayView
+{
+public:
+    class iterator
+    {
+    public:
+        typedef std::input_iterator_tag iterator_category;
+        typedef TType value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const TType* pointer;
+        typedef TType reference;
+        
+        iterator(ArrayView* view, unsigned index) : view_(view), index_(index) {}
+        
+        TType operator*() const { return view_->read(); }
+        iterator& operator++() { view_->arrayHandle_.next(); ++index_; return *this; }
+        bool operator==(const iterator& other) const { return index_ == other.index_; }
+        bool operator!=(const iterator& other) const { return index_ != other.index_; }
+    
+    private:
+        ArrayView* view_;
+        unsigned index_;
+    };
+    
+    ArrayView(MDataBlock& dataBlock, const Attribute& attribute)
+        : arrayHandle_(dataBlock.inputArrayValue(attribute))
+        , attribute_(attribute)
+        , childAttribute_(nullptr)
+    {
+    }
+    
+    ArrayView(MDataBlock& dataBlock, const Attribute& attribute, const Attribute& childAttribute)
+        : arrayHandle_(dataBlock.inputArrayValue(attribute))
+        , attribute_(childAttribute)
+        , childAttribute_(&childAttribute)
+    {
+    }
+    
+    unsigned size() const { return arrayHandle_.elementCount(); }
+    
+    iterator begin() { return iterator(this, 0u); }
+    iterator end() { return iterator(this, size()); }
+
+private:
+    TType read()
+    {
+        MDataHandle handle = arrayHandle_.inputValue();
+        if (childAttribute_ == nullptr) return getValue<TType>(handle, attribute_);
+        
+        MDataHandle childHandle = handle.child(*childAttribute_);
+        return getValue<TType>(childHandle, attribute_);
+    }
+    
+    MArrayDataHandle arrayHandle_;
+    const Attribute& attribute_;
+    const Attribute* childAttribute_;
+};
+
+
 // Template specializations for getAttribute
 template <typename TType>
 inline TType getAttribute(MDataBlock& dataBlock, const Attribute& attribute);
@@ -329,9 +528,56 @@ inline TType getAttribute(MDataBlock& dataBlock, const Attribute& attribute);
 template <typename TType>
 inline TType getAttribute(MDataBlock& dataBlock, const Attribute& attribute, const Attribute& childAttribute);
 
+// Reads an array attribute into a caller owned buffer, the buffer keeps its capacity between evaluations
+template <typename TType>
+inline void getAttribute(MDataBlock& dataBlock, const Attribute& attribute, std::vector<TType>& out)
+{
+    ProfilingStage stage(ProfilingStage::kRead);
+    
+    ArrayView<TType> view(dataBlock, attribute);
+    
+    out.resize(view.size());
+    std::copy(view.begin(), view.end(), out.begin());
+}
+
+template <typename TType>
+inline void getAttribute(MDataBlock& dataBlock, const Attribute& attribute, const Attribute& childAttribute, std::vector<TType>& out)
+{
+    ProfilingStage stage(ProfilingStage::kRead);
+    
+    ArrayView<TType> view(dataBlock, attribute, childAttribute);
+    
+    out.resize(view.size());
+    std::copy(view.begin(), view.end(), out.begin());
+}
+
+// Reads the value and weight children of a compound array attribute in a single pass
+template <typename TType>
+inline void getAttribute(MDataBlock& dataBlock, const Attribute& attribute, const Attribute& valueAttribute,
+                         const Attribute& weightAttribute, std::vector<TType>& values, std::vector<double>& weights)
+{
+    ProfilingStage stage(ProfilingStage::kRead);
+    
+    MArrayDataHandle arrayHandle = dataBlock.inputArrayValue(attribute);
+    
+    values.resize(arrayHandle.elementCount());
+    weights.resize(arrayHandle.elementCount());
+    for (unsigned index = 0u; index < arrayHandle.elementCount(); ++index)
+    {
+        MDataHandle handle = arrayHandle.inputValue();
+        MDataHandle valueHandle = handle.child(valueAttribute);
+        
+        values[index] = getValue<TType>(valueHandle, valueAttribute);
+        weights[index] = handle.child(weightAttribute).asDouble();
+        arrayHandle.next();
+    }
+}
+
 template <>
 inline double getAttribute(MDataBlock& dataBlock, const Attribute& attribute)
 {
+    ProfilingStage stage(ProfilingStage::kRead);
+    
     MDataHandle handle = dataBlock.inputValue(attribute);
     return handle.asDouble();
 }
@@ -340,14 +586,7 @@ template <>
 inline std::vector<double> getAttribute(MDataBlock& dataBlock, const Attribute& attribute)
 {
     std::vector<double> out;
-    MArrayDataHandle arrayHandle = dataBlock.inputArrayValue(attribute);
-    
-    out.resize(arrayHandle.elementCount());
-    for (unsigned index = 0u; index < arrayHandle.elementCount(); ++index)
-    {
-        out[index] = arrayHandle.inputValue().asDouble();
-        arrayHandle.next();
-    }
+    getAttribute(dataBlock, attribute, out);
     
     return out;
 }
@@ -356,15 +595,7 @@ template <>
 inline std::vector<double> getAttribute(MDataBlock& dataBlock, const Attribute& attribute, const Attribute& childAttribute)
 {
     std::vector<double> out;
-    MArrayDataHandle arrayHandle = dataBlock.inputArrayValue(attribute);
-    
-    out.resize(arrayHandle.elementCount());
-    for (unsigned index = 0u; index < arrayHandle.elementCount(); ++index)
-    {
-        MDataHandle handle = arrayHandle.inputValue();
-        out[index] = handle.child(childAttribute).asDouble();
-        arrayHandle.next();
-    }
+    getAttribute(dataBlock, attribute, childAttribute, out);
     
     return out;
 }
@@ -372,6 +603,8 @@ inline std::vector<double> getAttribute(MDataBlock& dataBlock, const Attribute&
 template <>
 inline int getAttribute(MDataBlock& dataBlock, const Attribute& attribute)
 {
+    ProfilingStage stage(ProfilingStage::kRead);
+    
     MDataHandle handle = dataBlock.inputValue(attribute);
     return handle.asInt();
 }
@@ -380,14 +613,7 @@ template <>
 inline std::vector<int> getAttribute(MDataBlock& dataBlock, const Attribute& attribute)
 {
     std::vector<int> out;
-    MArrayDataHandle arrayHandle = dataBlock.inputArrayValue(attribute);
-    
-    out.resize(arrayHandle.elementCount());
-    for (unsigned index = 0u; index < arrayHandle.elementCount(); ++index)
-    {
-        out[index] = arrayHandle.inputValue().asInt();
-        arrayHandle.next();
-    }
+    getAttribute(dataBlock, attribute, out);
     
     return out;
 }
@@ -396,15 +622,7 @@ template <>
 inline std::vector<int> getAttribute(MDataBlock& dataBlock, const Attribute& attribute, const Attribute& childAttribute)
 {
     std::vector<int> out;
-    MArrayDataHandle arrayHandle = dataBlock.inputArrayValue(attribute);
-    
-    out.resize(arrayHandle.elementCount());
-    for (unsigned index = 0u; index < arrayHandle.elementCount(); ++index)
-    {
-        MDataHandle handle = arrayHandle.inputValue();
-        out[index] = handle.child(childAttribute).asInt();
-        arrayHandle.next();
-    }
+    getAttribute(dataBlock, attribute, childAttribute, out);
     
     return out;
 }
@@ -412,6 +630,8 @@ inline std::vector<int> getAttribute(MDataBlock& dataBlock, const Attribute& att
 template <>
 inline bool getAttribute(MDataBlock& dataBlock, const Attribute& attribute)
 {
+    ProfilingStage stage(ProfilingStage::kRead);
+    
     MDataHandle handle = dataBlock.inputValue(attribute);
     return handle.asBool();
 }
@@ -419,6 +639,8 @@ inline bool getAttribute(MDataBlock& dataBlock, const Attribute& attribute)
 template <>
 inline MAngle getAttribute(MDataBlock& dataBlock, const Attribute& attribute)
 {
+    ProfilingStage stage(ProfilingStage::kRead);
+    
     MDataHandle handle = dataBlock.inputValue(attribute);
     return handle.asAngle();
 }
@@ -427,14 +649,7 @@ template <>
 inline std::vector<MAngle> getAttribute(MDataBlock& dataBlock, const Attribute& attribute)
 {
     std::vector<MAngle> out;
-    MArrayDataHandle arrayHandle = dataBlock.inputArrayValue(attribute);
-    
-    out.resize(arrayHandle.elementCount());
-    for (unsigned index = 0u; index < arrayHandle.elementCount(); ++index)
-    {
-        out[index] = arrayHandle.inputValue().asAngle();
-        arrayHandle.next();
-    }
+    getAttribute(dataBlock, attribute, out);
     
     return out;
 }
@@ -443,15 +658,7 @@ template <>
 inline std::vector<MAngle> getAttribute(MDataBlock& dataBlock, const Attribute& attribute, const Attribute& childAttribute)
 {
     std::vector<MAngle> out;
-    MArrayDataHandle arrayHandle = dataBlock.inputArrayValue(attribute);
-    
-    out.resize(arrayHandle.elementCount());
-    for (unsigned index = 0u; index < arrayHandle.elementCount(); ++index)
-    {
-        MDataHandle handle = arrayHandle.inputValue();
-        out[index] = handle.child(childAttribute).asAngle();
-        arrayHandle.next();
-    }
+    getAttribute(dataBlock, attribute, childAttribute, out);
     
     return out;
 }
@@ -459,6 +666,8 @@ inline std::vector<MAngle> getAttribute(MDataBlock& dataBlock, const Attribute&
 template <>
 inline MVector getAttribute(MDataBlock& dataBlock, const Attribute& attribute)
 {
+    ProfilingStage stage(ProfilingStage::kRead);
+    
     MDataHandle handle = dataBlock.inputValue(attribute);
     return handle.asVector();
 }
@@ -466,6 +675,8 @@ inline MVector getAttribute(MDataBlock& dataBlock, const Attribute& attribute)
 template <>
 inline MPoint getAttribute(MDataBlock& dataBlock, const Attribute& attribute)
 {
+    ProfilingStage stage(ProfilingStage::kRead);
+    
     MDataHandle handle = dataBlock.inputValue(attribute);
     return MPoint(handle.asVector());
 }
@@ -474,14 +685,7 @@ template <>
 inline std::vector<MVector> getAttribute(MDataBlock& dataBlock, const Attribute& attribute)
 {
     std::vector<MVector> out;
-    MArrayDataHandle arrayHandle = dataBlock.inputArrayValue(attribute);
-    
-    out.resize(arrayHandle.elementCount());
-    for (unsigned index = 0u; index < arrayHandle.elementCount(); ++index)
-    {
-        out[index] = arrayHandle.inputValue().asVector();
-        arrayHandle.next();
-    }
+    getAttribute(dataBlock, attribute, out);
     
     return out;
 }
@@ -490,15 +694,7 @@ template <>
 inline std::vector<MVector> getAttribute(MDataBlock& dataBlock, const Attribute& attribute, const Attribute& childAttribute)
 {
     std::vector<MVector> out;
-    MArrayDataHandle arrayHandle = dataBlock.inputArrayValue(attribute);
-    
-    out.resize(arrayHandle.elementCount());
-    for (unsigned index = 0u; index < arrayHandle.elementCount(); ++index)
-    {
-        MDataHandle handle = arrayHandle.inputValue();
-        out[index] = handle.child(childAttribute).asVector();
-        arrayHandle.next();
-    }
+    getAttribute(dataBlock, attribute, childAttribute, out);
     
     return out;
 }
@@ -506,6 +702,8 @@ inline std::vector<MVector> getAttribute(MDataBlock& dataBlock, const Attribute&
 template <>
 inline MMatrix getAttribute(MDataBlock& dataBlock, const Attribute& attribute)
 {
+    ProfilingStage stage(ProfilingStage::kRead);
+    
     MDataHandle handle = dataBlock.inputValue(attribute);
     return handle.asMatrix();
 }
@@ -514,14 +712,7 @@ template <>
 inline std::vector<MMatrix> getAttribute(MDataBlock& dataBlock, const Attribute& attribute)
 {
     std::vector<MMatrix> out;
-    MArrayDataHandle arrayHandle = dataBlock.inputArrayValue(attribute);
-    
-    out.resize(arrayHandle.elementCount());
-    for (unsigned index = 0u; index < arrayHandle.elementCount(); ++index)
-    {
-        out[index] = arrayHandle.inputValue().asMatrix();
-        arrayHandle.next();
-    }
+    getAttribute(dataBlock, attribute, out);
     
     return out;
 }
@@ -530,15 +721,7 @@ template <>
 inline std::vector<MMatrix> getAttribute(MDataBlock& dataBlock, const Attribute& attribute, const Attribute& childAttribute)
 {
     std::vector<MMatrix> out;
-    MArrayDataHandle arrayHandle = dataBlock.inputArrayValue(attribute);
-    
-    out.resize(arrayHandle.elementCount());
-    for (unsigned index = 0u; index < arrayHandle.elementCount(); ++index)
-    {
-        MDataHandle handle = arrayHandle.inputValue();
-        out[index] = handle.child(childAttribute).asMatrix();
-        arrayHandle.next();
-    }
+    getAttribute(dataBlock, attribute, childAttribute, out);
     
     return out;
 }
@@ -546,33 +729,17 @@ inline std::vector<MMatrix> getAttribute(MDataBlock& dataBlock, const Attribute&
 template <>
 inline MEulerRotation getAttribute(MDataBlock& dataBlock, const Attribute& attribute)
 {
-    MDataHandle handle = dataBlock.inputValue(attribute.attr);
+    ProfilingStage stage(ProfilingStage::kRead);
     
-    const double x = handle.child(attribute.attrX).asAngle().asRadians();
-    const double y = handle.child(attribute.attrY).asAngle().asRadians();
-    const double z = handle.child(attribute.attrZ).asAngle().asRadians();
-    
-    return MEulerRotation(x, y, z);
+    MDataHandle handle = dataBlock.inputValue(attribute.attr);
+    return getValue<MEulerRotation>(handle, attribute);
 }
 
 template <>
 inline std::vector<MEulerRotation> getAttribute(MDataBlock& dataBlock, const Attribute& attribute)
 {
     std::vector<MEulerRotation> out;
-    MArrayDataHandle arrayHandle = dataBlock.inputArrayValue(attribute);
-    
-    out.resize(arrayHandle.elementCount());
-    for (unsigned index = 0u; index < arrayHandle.elementCount(); ++index)
-    {
-        MDataHandle handle = arrayHandle.inputValue();
-        
-        const double x = handle.child(attribute.attrX).asAngle().asRadians();
-        const double y = handle.child(attribute.attrY).asAngle().asRadians();
-        const double z = handle.child(attribute.attrZ).asAngle().asRadians();
-        
-        out[index] = MEulerRotation(x, y, z);
-        arrayHandle.next();
-    }
+    getAttribute(dataBlock, attribute, out);
     
     return out;
 }
@@ -581,21 +748,7 @@ template <>
 inline std::vector<MEulerRotation> getAttribute(MDataBlock& dataBlock, const Attribute& attribute, const Attribute& childAttribute)
 {
     std::vector<MEulerRotation> out;
-    MArrayDataHandle arrayHandle = dataBlock.inputArrayValue(attribute);
-    
-    out.resize(arrayHandle.elementCount());
-    for (unsigned index = 0u; index < arrayHandle.elementCount(); ++index)
-    {
-        MDataHandle handle = arrayHandle.inputValue();
-        MDataHandle childHandle = handle.child(childAttribute);
-        
-        const double x = childHandle.child(childAttribute.attrX).asAngle().asRadians();
-        const double y = childHandle.child(childAttribute.attrY).asAngle().asRadians();
-        const double z = childHandle.child(childAttribute.attrZ).asAngle().asRadians();
-        
-        out[index] = MEulerRotation(x, y, z);
-        arrayHandle.next();
-    }
+    getAttribute(dataBlock, attribute, childAttribute, out);
     
     return out;
 }
@@ -603,35 +756,17 @@ inline std::vector<MEulerRotation> getAttribute(MDataBlock& dataBlock, const Att
 template <>
 inline MQuaternion getAttribute(MDataBlock& dataBlock, const Attribute& attribute)
 {
-    MDataHandle handle = dataBlock.inputValue(attribute.attr);
-    
-    const double x = handle.child(attribute.attrX).asDouble();
-    const double y = handle.child(attribute.attrY).asDouble();
-    const double z = handle.child(attribute.attrZ).asDouble();
-    const double w = handle.child(attribute.attrW).asDouble();
+    ProfilingStage stage(ProfilingStage::kRead);
     
-    return MQuaternion(x, y, z, w);
+    MDataHandle handle = dataBlock.inputValue(attribute.attr);
+    return getValue<MQuaternion>(handle, attribute);
 }
 
 template <>
 inline std::vector<MQuaternion> getAttribute(MDataBlock& dataBlock, const Attribute& attribute)
 {
     std::vector<MQuaternion> out;
-    MArrayDataHandle arrayHandle = dataBlock.inputArrayValue(attribute);
-    
-    out.resize(arrayHandle.elementCount());
-    for (unsigned index = 0u; index < arrayHandle.elementCount(); ++index)
-    {
-        MDataHandle handle = arrayHandle.inputValue();
-        
-        const double x = handle.child(attribute.attrX).asDouble();
-        const double y = handle.child(attribute.attrY).asDouble();
-        const double z = handle.child(attribute.attrZ).asDouble();
-        const double w = handle.child(attribute.attrW).asDouble();
-        
-        out[index] = MQuaternion(x, y, z, w);
-        arrayHandle.next();
-    }
+    getAttribute(dataBlock, attribute, out);
     
     return out;
 }
@@ -640,28 +775,15 @@ template <>
 inline std::vector<MQuaternion> getAttribute(MDataBlock& dataBlock, const Attribute& attribute, const Attribute& childAttribute)
 {
     std::vector<MQuaternion> out;
-    MArrayDataHandle arrayHandle = dataBlock.inputArrayValue(attribute);
-    
-    out.resize(arrayHandle.elementCount());
-    for (unsigned index = 0u; index < arrayHandle.elementCount(); ++index)
-    {
-        MDataHandle handle = arrayHandle.inputValue();
-        MDataHandle childHandle = handle.child(childAttribute);
-        
-        const double x = childHandle.child(childAttribute.attrX).asDouble();
-        const double y = childHandle.child(childAttribute.attrY).asDouble();
-        const double z = childHandle.child(childAttribute.attrZ).asDouble();
-        const double w = childHandle.child(childAttribute.attrW).asDouble();
-        
-        out[index] = MQuaternion(x, y, z, w);
-        arrayHandle.next();
-    }
+    getAttribute(dataBlock, attribute, childAttribute, out);
     
     return out;
 }
 
 inline MObject getAttribute(MDataBlock& dataBlock, const Attribute& attribute, MFnData::Type type)
 {
+    ProfilingStage stage(ProfilingStage::kRead);
+    
     MDataHandle handle = dataBlock.inputValue(attribute);
     
     switch (type)
@@ -672,14 +794,31 @@ inline MObject getAttribute(MDataBlock& dataBlock, const Attribute& attribute, M
             return handle.asNurbsCurve();
         case MFnData::kNurbsSurface:
             return handle.asNurbsSurface();
+        case MFnData::kDoubleArray:
+        case MFnData::kVectorArray:
+        case MFnData::kMatrixArray:
+            return handle.data();
         default:
             return MObject();
     }
 }
 
+// Returns the array of a typed array data input, the array references the values of the data object
+// so that the kernels read them without a copy
+template <typename TType>
+inline typename ArrayDataTraits<TType>::Array getArrayDataAttribute(MDataBlock& dataBlock, const Attribute& attribute)
+{
+    ProfilingStage stage(ProfilingStage::kRead);
+    
+    const typename ArrayDataTraits<TType>::FnData dataFn(dataBlock.inputValue(attribute).data());
+    return dataFn.array();
+}
+
 template <>
 inline MTransformationMatrix::RotationOrder getAttribute(MDataBlock& dataBlock, const Attribute& attribute)
 {
+    ProfilingStage stage(ProfilingStage::kRead);
+    
     MDataHandle handle = dataBlock.inputValue(attribute);
     return MTransformationMatrix::RotationOrder(handle.asShort() + 1);
 }
@@ -687,6 +826,8 @@ inline MTransformationMatrix::RotationOrder getAttribute(MDataBlock& dataBlock,
 template <>
 inline MEulerRotation::RotationOrder getAttribute(MDataBlock& dataBlock, const Attribute& attribute)
 {
+    ProfilingStage stage(ProfilingStage::kRead);
+    
     MDataHandle handle = dataBlock.inputValue(attribute);
     return MEulerRotation::RotationOrder(handle.asShort());
 }
@@ -696,6 +837,8 @@ inline MEulerRotation::RotationOrder getAttribute(MDataBlock& dataBlock, const A
 template <typename TType>
 inline void setAttribute(MDataBlock& dataBlock, const Attribute& attribute, TType value)
 {
+    ProfilingStage stage(ProfilingStage::kWrite);
+    
     MDataHandle handle = dataBlock.outputValue(attribute);
     handle.set(value);
     handle.setClean();
@@ -704,61 +847,161 @@ inline void setAttribute(MDataBlock& dataBlock, const Attribute& attribute, TTyp
 template <>
 inline void setAttribute(MDataBlock& dataBlock, const Attribute& attribute, MPoint value)
 {
+    ProfilingStage stage(ProfilingStage::kWrite);
+    
     MDataHandle handle = dataBlock.outputValue(attribute);
     handle.set(MVector(value));
     handle.setClean();
 }
 
+// Rotations are numeric compounds so all three angles are written in radians through the parent handle
 template <>
 inline void setAttribute(MDataBlock& dataBlock, const Attribute& attribute, MEulerRotation value)
 {
-    MDataHandle outputXHandle = dataBlock.outputValue(attribute.attrX);
-    outputXHandle.set(MAngle(value.x));
-    outputXHandle.setClean();
-    
-    MDataHandle outputYHandle = dataBlock.outputValue(attribute.attrY);
-    outputYHandle.set(MAngle(value.y));
-    outputYHandle.setClean();
+    ProfilingStage stage(ProfilingStage::kWrite);
     
-    MDataHandle outputZHandle = dataBlock.outputValue(attribute.attrZ);
-    outputZHandle.set(MAngle(value.z));
-    outputZHandle.setClean();
+    MDataHandle outputHandle = dataBlock.outputValue(attribute.attr);
+    outputHandle.set3Double(value.x, value.y, value.z);
+    outputHandle.setClean();
 }
 
 template <>
 inline void setAttribute(MDataBlock& dataBlock, const Attribute& attribute, MQuaternion value)
 {
-    MDataHandle outputXHandle = dataBlock.outputValue(attribute.attrX);
-    outputXHandle.set(value.x);
-    outputXHandle.setClean();
+    ProfilingStage stage(ProfilingStage::kWrite);
     
-    MDataHandle outputYHandle = dataBlock.outputValue(attribute.attrY);
-    outputYHandle.set(value.y);
-    outputYHandle.setClean();
+    MDataHandle outputHandle = dataBlock.outputValue(attribute.attr);
+    outputHandle.child(attribute.attrX).set(value.x);
+    outputHandle.child(attribute.attrY).set(value.y);
+    outputHandle.child(attribute.attrZ).set(value.z);
+    outputHandle.child(attribute.attrW).set(value.w);
+    outputHandle.setClean();
+}
+
+// Writes a single value to a data handle, compound values are written through their children
+template <typename TType>
+inline void setValue(MDataHandle& handle, const Attribute&, const TType& value)
+{
+    handle.set(value);
+}
+
+inline void setValue(MDataHandle& handle, const Attribute&, const MEulerRotation& value)
+{
+    handle.set3Double(value.x, value.y, value.z);
+}
+
+inline void setValue(MDataHandle& handle, const Attribute& attribute, const MQuaternion& value)
+{
+    handle.child(attribute.attrX).set(value.x);
+    handle.child(attribute.attrY).set(value.y);
+    handle.child(attribute.attrZ).set(value.z);
+    handle.child(attribute.attrW).set(value.w);
+}
+
+// Writes array outputs in place when the existing elements match the logical indices being written,
+// otherwise the array is rebuilt through a new builder
+template <typename TIterator>
+inline void setArrayAttribute(MDataBlock& dataBlock, const Attribute& attribute, unsigned count, TIterator first)
+{
+    ProfilingStage stage(ProfilingStage::kWrite);
     
-    MDataHandle outputZHandle = dataBlock.outputValue(attribute.attrZ);
-    outputZHandle.set(value.z);
-    outputZHandle.setClean();
+    MArrayDataHandle handle = dataBlock.outputArrayValue(attribute);
+    
+    bool inPlace = handle.elementCount() == count;
+    if (inPlace && count != 0u)
+    {
+        // Logical indices are sorted and unique, the last one tells whether the elements are contiguous
+        handle.jumpToArrayElement(count - 1u);
+        inPlace = handle.elementIndex() == count - 1u;
+    }
+    
+    if (inPlace)
+    {
+        handle.jumpToArrayElement(0u);
+        for (unsigned index = 0u; index < count; ++index, ++first)
+        {
+            MDataHandle itemHandle = handle.outputValue();
+            setValue(itemHandle, attribute, *first);
+            handle.next();
+        }
+    }
+    else
+    {
+        MArrayDataBuilder builder(&dataBlock, attribute, count);
+        for (unsigned index = 0u; index < count; ++index, ++first)
+        {
+            MDataHandle itemHandle = builder.addLast();
+            setValue(itemHandle, attribute, *first);
+        }
+        
+        handle.set(builder);
+    }
     
-    MDataHandle outputWHandle = dataBlock.outputValue(attribute.attrW);
-    outputWHandle.set(value.w);
-    outputWHandle.setClean();
+    handle.setAllClean();
 }
 
 template <typename TType>
 inline void setAttribute(MDataBlock& dataBlock, const Attribute& attribute, const std::vector<TType>& values)
 {
-    MArrayDataHandle handle = dataBlock.outputArrayValue(attribute);
-    MArrayDataBuilder builder(&dataBlock, attribute, unsigned(values.size()));
+    setArrayAttribute(dataBlock, attribute, unsigned(values.size()), values.begin());
+}
+
+template <typename TType>
+inline void setAttribute(MDataBlock& dataBlock, const Attribute& attribute, ArrayView<TType>& values)
+{
+    setArrayAttribute(dataBlock, attribute, values.size(), values.begin());
+}
+
+// Copies an input array attribute to an output array attribute, the output elements are compacted to the logical
+// indices 0 to count - 1 in the order of the input elements
+template <typename TType>
+inline void copyArrayAttribute(MDataBlock& dataBlock, const Attribute& outputAttribute, const Attribute& inputAttribute)
+{
+    ArrayView<TType> values(dataBlock, inputAttribute);
+    setAttribute(dataBlock, outputAttribute, values);
+}
+
+// Copies the single element of an input array attribute that a compacted output element comes from, which is the
+// input element at the physical position given by the output logical index. Only that element is pulled from the
+// input and a missing output element is added to the existing array. Returns false when there is no such element.
+template <typename TType>
+inline bool copyArrayElement(MDataBlock& dataBlock, const Attribute& outputAttribute, const Attribute& inputAttribute,
+                             const MObject& node, unsigned index)
+{
+    ProfilingStage stage(ProfilingStage::kWrite);
+    
+    const MPlug inputPlug(node, inputAttribute);
+    if (index >= inputPlug.numElements()) return false;
+    
+    MDataHandle inputHandle = dataBlock.inputValue(inputPlug.elementByPhysicalIndex(index));
+    const TType value = getValue<TType>(inputHandle, inputAttribute);
     
-    for (const auto& value : values)
+    MArrayDataHandle outputHandle = dataBlock.outputArrayValue(outputAttribute);
+    if (!outputHandle.jumpToElement(index))
     {
-        MDataHandle itemHandle = builder.addLast();
-        itemHandle.set(value);
+        MArrayDataBuilder builder = outputHandle.builder();
+        builder.addElement(index);
+        outputHandle.set(builder);
+        outputHandle.jumpToElement(index);
     }
     
-    handle.set(builder);
-    handle.setAllClean();
+    MDataHandle outputItemHandle = outputHandle.outputValue();
+    setValue(outputItemHandle, outputAttribute, value);
+    outputItemHandle.setClean();
+    
+    return true;
+}
+
+inline void setArrayDataAttribute(MDataBlock& dataBlock, const Attribute& attribute, const MDoubleArray& values)
+{
+    ProfilingStage stage(ProfilingStage::kWrite);
+    
+    MFnDoubleArrayData dataFn;
+    const MObject data = dataFn.create(values);
+    
+    MDataHandle handle = dataBlock.outputValue(attribute);
+    handle.set(data);
+    handle.setClean();
 }
 
 
@@ -824,6 +1067,120 @@ MQuaternion operator*(const MQuaternion& a, double b)
 }
 
 
+// Input types whose kernels are costly enough for nodes to skip them when their inputs did not change
+template <typename TType>
+struct MemoizeInputs
+{
+    static constexpr bool value = false;
+};
+
+template <>
+struct MemoizeInputs<MMatrix>
+{
+    static constexpr bool value = true;
+};
+
+// Raw bits of the inputs read by the previous evaluation of a node
+// Values are compared and stored in a single pass, arrays also record their size so that a resize is a change
+class InputMemo
+{
+public:
+    // Returns true when the values are bit-identical to those given to the previous call
+    template <typename... TTypes>
+    bool update(const TTypes&... values)
+    {
+        position_ = 0u;
+        changed_ = !valid_;
+        
+        const int expand[] = {0, (append(values), 0)...};
+        (void)expand;
+        
+        changed_ |= position_ != bits_.size();
+        bits_.resize(position_);
+        valid_ = true;
+        
+        return !changed_;
+    }
+    
+    void reset()
+    {
+        valid_ = false;
+    }
+
+private:
+    template <typename TType>
+    void append(const TType& value)
+    {
+        append(&value, sizeof(TType));
+    }
+    
+    template <typename TType>
+    void append(const std::vector<TType>& values)
+    {
+        const size_t size = values.size();
+        append(&size, sizeof(size_t));
+        append(values.data(), values.size() * sizeof(TType));
+    }
+    
+    void append(const void* data, size_t size)
+    {
+        if (size == 0u) return;
+        
+        if (position_ + size > bits_.size())
+        {
+            bits_.resize(position_ + size);
+            changed_ = true;
+        }
+        
+        if (changed_ || std::memcmp(&bits_[position_], data, size) != 0)
+        {
+            std::memcpy(&bits_[position_], data, size);
+            changed_ = true;
+        }
+        
+        position_ += size;
+    }
+    
+    std::vector<unsigned char> bits_;
+    size_t position_ = 0u;
+    bool changed_ = true;
+    bool valid_ = false;
+};
+
+
+// Node wrapper created by BaseNode, records the compute in the Maya Profiler and times it when statistics or tracing are enabled
+template<typename TNode, const char* TTypeName>
+class InstrumentedNode : public TNode
+{
+public:
+    MStatus compute(const MPlug& plug, MDataBlock& dataBlock) override
+    {
+        MProfilingScope scope(NodeProfiler::category(), MProfiler::kColorE_L3, TTypeName);
+        
+        const bool stats = ComputeStats::isEnabled();
+        const bool trace = ComputeTrace::isEnabled();
+        if (!stats && !trace) return TNode::compute(plug, dataBlock);
+        
+        const auto start = std::chrono::steady_clock::now();
+        const MStatus status = TNode::compute(plug, dataBlock);
+        const auto end = std::chrono::steady_clock::now();
+        
+        if (stats)
+        {
+            ComputeStats::record(TNode::kStatsSlot, status,
+                                 uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()));
+        }
+        
+        if (trace)
+        {
+            ComputeTrace::record(TTypeName, this->name(), start, end);
+        }
+        
+        return status;
+    }
+};
+
+
 // Base node type definition used for all math nodes in this library
 template<typename TClass, const char* TTypeName>
 class BaseNode : public MPxNode
@@ -831,10 +1188,13 @@ class BaseNode : public MPxNode
 public:
     static void registerNode(class MFnPlugin& pluginFn, int typeId)
     {
+        const std::string typeName = std::string(NODE_NAME_PREFIX) + TTypeName;
+        
         kTypeId = typeId;
-        pluginFn.registerNode((std::string(NODE_NAME_PREFIX) + TTypeName).c_str(),
+        kStatsSlot = ComputeStats::registerNodeType(typeName);
+        pluginFn.registerNode(typeName.c_str(),
                               typeId,
-                              []() -> void* { return new TClass(); },
+                              []() -> void* { return new InstrumentedNode<TClass, TTypeName>(); },
                               TClass::initialize);
     }
     
@@ -849,8 +1209,30 @@ public:
     }
 
 protected:
+    // Opt-in memoization for nodes with costly kernels, call with every input value the output depends on
+    // When it returns true the outputs computed last time are still valid and only need to be set clean.
+    // Other contexts evaluate into their own data block so only the normal context is memoized.
+    template <typename... TTypes>
+    bool inputsUnchanged(MDataBlock& dataBlock, const TTypes&... values)
+    {
+        if (!dataBlock.context().isNormal())
+        {
+            inputMemo_.reset();
+            return false;
+        }
+        
+        return inputMemo_.update(values...);
+    }
+    
     static int kTypeId;
+    static unsigned kStatsSlot;
+
+private:
+    InputMemo inputMemo_;
 };
 
 template<typename TClass, const char* TTypeName>
 int BaseNode<TClass, TTypeName>::kTypeId = -1;
+
+template<typename TClass, const char* TTypeName>
+unsigned BaseNode<TClass, TTypeName>::kStatsSlot = ComputeStats::kMaxNodeTypes;
@@ -0,0 +1,318 @@
+// Copyright (c) 2018-2023 Serguei Kalentchouk et al. All rights reserved.
+// Use of this source code is governed by an MIT license that can be found in the LICENSE file.
+#include "Array.h"
+
+#include "Interpolate.h"
+#include "Rotation.h"
+#include "Simd.h"
+
+namespace core
+{
+
+namespace
+{
+
+inline double logScale(double scale)
+{
+    return scale != 0.0 ? std::log(std::abs(scale)) : 0.0;
+}
+
+inline Vector logScale(const Vector& scale)
+{
+    return {logScale(scale.x), logScale(scale.y), logScale(scale.z)};
+}
+
+inline Vector expScale(const Vector& scale)
+{
+    return {std::exp(scale.x), std::exp(scale.y), std::exp(scale.z)};
+}
+
+const Quaternion kZeroTerm = {0.0, 0.0, 0.0, 0.0};
+const Transform kZeroTransformTerm = {kZeroVector, kZeroVector, kZeroTerm, kZeroVector};
+
+inline double weightSum(const double* weights, size_t count)
+{
+    return simd::sum(weights, count);
+}
+
+}
+
+double sum(const double* values, size_t count)
+{
+    return simd::sum(values, count);
+}
+
+int sum(const int* values, size_t count)
+{
+    return simd::sum(values, count);
+}
+
+Vector sum(const Vector* values, size_t count)
+{
+    Vector out = kZeroVector;
+    for (size_t i = 0u; i < count; ++i)
+    {
+        out = out + values[i];
+    }
+
+    return out;
+}
+
+Quaternion sum(const Quaternion* values, size_t count)
+{
+    Quaternion out = kZeroTerm;
+    for (size_t i = 0u; i < count; ++i)
+    {
+        out = out + values[i];
+    }
+
+    return out;
+}
+
+Transform sum(const Transform* values, size_t count)
+{
+    Transform out = kZeroTransformTerm;
+    for (size_t i = 0u; i < count; ++i)
+    {
+        out = out + values[i];
+    }
+
+    return out;
+}
+
+double average(const double* values, size_t count)
+{
+    if (count == 0u) return 0.0;
+
+    return sum(values, count) / double(count);
+}
+
+double average(const int* values, size_t count)
+{
+    if (count == 0u) return 0.0;
+
+    return double(sum(values, count)) / double(count);
+}
+
+Vector average(const Vector* values, size_t count)
+{
+    if (count == 0u) return kZeroVector;
+
+    return sum(values, count) / double(count);
+}
+
+Quaternion average(const Quaternion* values, size_t count)
+{
+    Quaternion out = kZeroTerm;
+    for (size_t i = 0u; i < count; ++i)
+    {
+        out = out + averageTerm(values[i], 1.0);
+    }
+
+    return averageFromTerms(out, double(count));
+}
+
+EulerRotation average(const EulerRotation* values, size_t count)
+{
+    Quaternion out = kZeroTerm;
+    for (size_t i = 0u; i < count; ++i)
+    {
+        out = out + averageTerm(values[i], 1.0);
+    }
+
+    return toEulerRotation(averageFromTerms(out, double(count)));
+}
+
+Matrix average(const Transform* values, size_t count)
+{
+    Transform out = kZeroTransformTerm;
+    for (size_t i = 0u; i < count; ++i)
+    {
+        out = out + averageTerm(values[i], 1.0);
+    }
+
+    return averageFromTerms(out, double(count));
+}
+
+double average(const double* values, const double* weights, size_t count)
+{
+    if (count == 0u) return 0.0;
+
+    const double totalWeight = weightSum(weights, count);
+    if (almostEquals(totalWeight, 0.0)) return 0.0;
+
+    double out = 0.0;
+    for (size_t i = 0u; i < count; ++i)
+    {
+        out += values[i] * weights[i];
+    }
+
+    return out / totalWeight;
+}
+
+double average(const int* values, const double* weights, size_t count)
+{
+    if (count == 0u) return 0.0;
+
+    const double totalWeight = weightSum(weights, count);
+    if (almostEquals(totalWeight, 0.0)) return 0.0;
+
+    double out = 0.0;
+    for (size_t i = 0u; i < count; ++i)
+    {
+        out += values[i] * weights[i];
+    }
+
+    return out / totalWeight;
+}
+
+Vector average(const Vector* values, const double* weights, size_t count)
+{
+    if (count == 0u) return kZeroVector;
+
+    const double totalWeight = weightSum(weights, count);
+    if (almostEquals(totalWeight, 0.0)) return kZeroVector;
+
+    Vector out = kZeroVector;
+    for (size_t i = 0u; i < count; ++i)
+    {
+        out = out + values[i] * weights[i];
+    }
+
+    return out / totalWeight;
+}
+
+Quaternion average(const Quaternion* values, const double* weights, size_t count)
+{
+    Quaternion out = kZeroTerm;
+    for (size_t i = 0u; i < count; ++i)
+    {
+        out = out + averageTerm(values[i], weights[i]);
+    }
+
+    return averageFromTerms(out, weightSum(weights, count));
+}
+
+EulerRotation average(const EulerRotation* values, const double* weights, size_t count)
+{
+    Quaternion out = kZeroTerm;
+    for (size_t i = 0u; i < count; ++i)
+    {
+        out = out + averageTerm(values[i], weights[i]);
+    }
+
+    return toEulerRotation(averageFromTerms(out, weightSum(weights, count)));
+}
+
+Matrix average(const Transform* values, const double* weights, size_t count)
+{
+    Transform out = kZeroTransformTerm;
+    for (size_t i = 0u; i < count; ++i)
+    {
+        out = out + averageTerm(values[i], weights[i]);
+    }
+
+    return averageFromTerms(out, weightSum(weights, count));
+}
+
+Quaternion averageTerm(const Quaternion& value, double weight)
+{
+    return log(value) * weight;
+}
+
+Quaternion averageTerm(const EulerRotation& value, double weight)
+{
+    return log(toQuaternion(value)) * weight;
+}
+
+Transform averageTerm(const Transform& value, double weight)
+{
+    return {logScale(value.scale) * weight, value.shear * weight, log(value.rotation) * weight, value.translation * weight};
+}
+
+double averageFromTerms(double total, double totalWeight)
+{
+    if (almostEquals(totalWeight, 0.0)) return 0.0;
+
+    return total / totalWeight;
+}
+
+Vector averageFromTerms(const Vector& total, double totalWeight)
+{
+    if (almostEquals(totalWeight, 0.0)) return kZeroVector;
+
+    return total / totalWeight;
+}
+
+Quaternion averageFromTerms(const Quaternion& total, double totalWeight)
+{
+    if (almostEquals(totalWeight, 0.0)) return kIdentityQuaternion;
+
+    return exp(total / totalWeight);
+}
+
+Matrix averageFromTerms(const Transform& total, double totalWeight)
+{
+    if (almostEquals(totalWeight, 0.0)) return kIdentityMatrix;
+
+    const double weightInv = 1.0 / totalWeight;
+
+    Transform out;
+    out.scale = expScale(total.scale * weightInv);
+    out.shear = total.shear * weightInv;
+    out.rotation = exp(total.rotation * weightInv);
+    out.translation = total.translation * weightInv;
+
+    return compose(out);
+}
+
+void normalize(const double* values, size_t count, double* out)
+{
+    const double s = sum(values, count);
+    const double divisor = almostEquals(s, 0.0) ? 1.0 : s;
+
+    simd::divide(values, count, divisor, out);
+}
+
+void clamp(const double* values, size_t count, double* out)
+{
+    simd::clamp(values, count, out);
+}
+
+void normalizeWeights(const double* values, size_t count, double* out)
+{
+    const double s = simd::clampedSum(values, count, out);
+    if (s < 1.0) return;
+
+    simd::divide(out, count, s, out);
+}
+
+double minElement(const double* values, size_t count)
+{
+    if (count == 0u) return 0.0;
+
+    return simd::minElement(values, count);
+}
+
+int minElement(const int* values, size_t count)
+{
+    if (count == 0u) return 0;
+
+    return simd::minElement(values, count);
+}
+
+double maxElement(const double* values, size_t count)
+{
+    if (count == 0u) return 0.0;
+
+    return simd::maxElement(values, count);
+}
+
+int maxElement(const int* values, size_t count)
+{
+    if (count == 0u) return 0;
+
+    return simd::maxElement(values, count);
+}
+
+}
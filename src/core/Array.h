@@ -0,0 +1,54 @@
+// Copyright (c) 2018-2023 Serguei Kalentchouk et al. All rights reserved.
+// Use of this source code is governed by an MIT license that can be found in the LICENSE file.
+#pragma once
+
+#include "Types.h"
+
+namespace core
+{
+
+double sum(const double* values, size_t count);
+int sum(const int* values, size_t count);
+Vector sum(const Vector* values, size_t count);
+Quaternion sum(const Quaternion* values, size_t count);
+Transform sum(const Transform* values, size_t count);
+
+double average(const double* values, size_t count);
+double average(const int* values, size_t count);
+Vector average(const Vector* values, size_t count);
+Quaternion average(const Quaternion* values, size_t count);
+EulerRotation average(const EulerRotation* values, size_t count);
+// Note: this algorithm does not consider negative scaling
+Matrix average(const Transform* values, size_t count);
+
+double average(const double* values, const double* weights, size_t count);
+double average(const int* values, const double* weights, size_t count);
+Vector average(const Vector* values, const double* weights, size_t count);
+Quaternion average(const Quaternion* values, const double* weights, size_t count);
+EulerRotation average(const EulerRotation* values, const double* weights, size_t count);
+Matrix average(const Transform* values, const double* weights, size_t count);
+
+// Averages split into per element terms, the average is the sum of the terms divided by the sum of the weights
+// Terms can be added to and removed from running totals which lets the nodes update an average incrementally
+inline double averageTerm(double value, double weight) { return value * weight; }
+inline Vector averageTerm(const Vector& value, double weight) { return value * weight; }
+Quaternion averageTerm(const Quaternion& value, double weight);
+Quaternion averageTerm(const EulerRotation& value, double weight);
+Transform averageTerm(const Transform& value, double weight);
+
+double averageFromTerms(double total, double totalWeight);
+Vector averageFromTerms(const Vector& total, double totalWeight);
+Quaternion averageFromTerms(const Quaternion& total, double totalWeight);
+Matrix averageFromTerms(const Transform& total, double totalWeight);
+
+// Map operations write count values to out, which may alias values
+void normalize(const double* values, size_t count, double* out);
+void clamp(const double* values, size_t count, double* out);
+void normalizeWeights(const double* values, size_t count, double* out);
+
+double minElement(const double* values, size_t count);
+int minElement(const int* values, size_t count);
+double maxElement(const double* values, size_t count);
+int maxElement(const int* values, size_t count);
+
+}
@@ -0,0 +1,193 @@
+// Copyright (c) 2018-2023 Serguei Kalentchouk et al. All rights reserved.
+// Use of this source code is governed by an MIT license that can be found in the LICENSE file.
+#include "Interpolate.h"
+
+#include "Rotation.h"
+
+namespace core
+{
+
+namespace
+{
+
+// Relative length below which an axis is considered to have collapsed during the orthogonalization
+const double kDegenerateAxis = 1.0e-12;
+
+inline bool isDegenerate(double axisLength, const Vector& row)
+{
+    return axisLength <= kDegenerateAxis * length(row);
+}
+
+// Unit vector perpendicular to the given unit vector
+inline Vector perpendicular(const Vector& axis)
+{
+    const Vector other = std::abs(axis.x) < 0.9 ? Vector{1.0, 0.0, 0.0} : Vector{0.0, 1.0, 0.0};
+    const Vector out = cross(axis, other);
+
+    return out / length(out);
+}
+
+}
+
+Quaternion slerp(const Quaternion& value1, const Quaternion& value2, double alpha, int spin)
+{
+    const double kPi = 3.14159265358979323846;
+
+    double cosTheta = dot(value1, value2);
+    const bool flip = cosTheta < 0.0;
+    if (flip)
+    {
+        cosTheta = -cosTheta;
+    }
+
+    double weight1, weight2;
+    if (1.0 - cosTheta < 1.0e-7)
+    {
+        weight1 = 1.0 - alpha;
+        weight2 = alpha;
+    }
+    else
+    {
+        const double theta = std::acos(cosTheta);
+        const double phi = theta + spin * kPi;
+        const double sinTheta = std::sin(theta);
+
+        weight1 = std::sin(theta - alpha * phi) / sinTheta;
+        weight2 = std::sin(alpha * phi) / sinTheta;
+    }
+
+    if (flip)
+    {
+        weight2 = -weight2;
+    }
+
+    return value1 * weight1 + value2 * weight2;
+}
+
+Matrix lerp(const Transform& value1, const Transform& value2, double alpha)
+{
+    Transform out;
+    out.scale = lerp(value1.scale, value2.scale, alpha);
+    out.shear = lerp(value1.shear, value2.shear, alpha);
+    out.rotation = slerp(value1.rotation, value2.rotation, alpha);
+    out.translation = lerp(value1.translation, value2.translation, alpha);
+
+    return compose(out);
+}
+
+Matrix compose(const Transform& transform)
+{
+    const Matrix rotation = toMatrix(transform.rotation);
+    const Vector& scale = transform.scale;
+    const Vector& shear = transform.shear;
+
+    // Rows of the scale and shear product, [S] * [Sh]
+    const double scaleShear[3][3] = {{scale.x, 0.0, 0.0},
+                                     {scale.y * shear.x, scale.y, 0.0},
+                                     {scale.z * shear.y, scale.z * shear.z, scale.z}};
+
+    Matrix out = kIdentityMatrix;
+    for (unsigned i = 0u; i < 3u; ++i)
+    {
+        for (unsigned j = 0u; j < 3u; ++j)
+        {
+            out.m[i][j] = scaleShear[i][0] * rotation.m[0][j] +
+                          scaleShear[i][1] * rotation.m[1][j] +
+                          scaleShear[i][2] * rotation.m[2][j];
+        }
+    }
+
+    out.m[3][0] = transform.translation.x;
+    out.m[3][1] = transform.translation.y;
+    out.m[3][2] = transform.translation.z;
+
+    return out;
+}
+
+Matrix compose(const Vector& translation, const EulerRotation& rotation, const Vector& scale)
+{
+    Matrix out = toMatrix(rotation);
+    const double rowScale[3] = {scale.x, scale.y, scale.z};
+    for (unsigned i = 0u; i < 3u; ++i)
+    {
+        out.m[i][0] *= rowScale[i];
+        out.m[i][1] *= rowScale[i];
+        out.m[i][2] *= rowScale[i];
+    }
+
+    out.m[3][0] = translation.x;
+    out.m[3][1] = translation.y;
+    out.m[3][2] = translation.z;
+
+    return out;
+}
+
+void compose(const Vector* translations, const EulerRotation* rotations, const Vector* scales, size_t count, Matrix* out)
+{
+    for (size_t i = 0u; i < count; ++i)
+    {
+        out[i] = compose(translations[i], rotations[i], scales[i]);
+    }
+}
+
+Transform decompose(const Matrix& matrix)
+{
+    const auto& in = matrix.m;
+    const Vector rows[3] = {{in[0][0], in[0][1], in[0][2]},
+                            {in[1][0], in[1][1], in[1][2]},
+                            {in[2][0], in[2][1], in[2][2]}};
+
+    Transform out;
+    out.translation = getTranslation(matrix);
+
+    // Gram-Schmidt orthogonalization of the rows, the QR split of [S] * [Sh] * [R] with the unit axes as rows of R
+    out.scale.x = length(rows[0]);
+    const Vector axisX = out.scale.x != 0.0 ? rows[0] / out.scale.x : Vector{1.0, 0.0, 0.0};
+
+    const double xy = dot(rows[1], axisX);
+    Vector axisY = rows[1] - axisX * xy;
+    out.scale.y = length(axisY);
+    if (isDegenerate(out.scale.y, rows[1]))
+    {
+        out.scale.y = 0.0;
+        axisY = perpendicular(axisX);
+    }
+    else
+    {
+        axisY = axisY / out.scale.y;
+    }
+
+    const double xz = dot(rows[2], axisX);
+    const double yz = dot(rows[2], axisY);
+    Vector axisZ = rows[2] - axisX * xz - axisY * yz;
+    out.scale.z = length(axisZ);
+    if (isDegenerate(out.scale.z, rows[2]))
+    {
+        out.scale.z = 0.0;
+        axisZ = cross(axisX, axisY);
+    }
+    else
+    {
+        axisZ = axisZ / out.scale.z;
+    }
+
+    if (dot(cross(axisX, axisY), axisZ) < 0.0)
+    {
+        out.scale.z = -out.scale.z;
+        axisZ = -axisZ;
+    }
+
+    out.shear.x = out.scale.y != 0.0 ? xy / out.scale.y : 0.0;
+    out.shear.y = out.scale.z != 0.0 ? xz / out.scale.z : 0.0;
+    out.shear.z = out.scale.z != 0.0 ? yz / out.scale.z : 0.0;
+
+    const Matrix rotation = {{{axisX.x, axisX.y, axisX.z, 0.0},
+                              {axisY.x, axisY.y, axisY.z, 0.0},
+                              {axisZ.x, axisZ.y, axisZ.z, 0.0},
+                              {0.0, 0.0, 0.0, 1.0}}};
+    out.rotation = MatrixToQuaternion(rotation);
+
+    return out;
+}
+
+}
@@ -0,0 +1,66 @@
+// Copyright (c) 2018-2023 Serguei Kalentchouk et al. All rights reserved.
+// Use of this source code is governed by an MIT license that can be found in the LICENSE file.
+#pragma once
+
+#include "Types.h"
+
+namespace core
+{
+
+inline double lerp(double value1, double value2, double alpha)
+{
+    return value1 + (value2 - value1) * alpha;
+}
+
+inline Vector lerp(const Vector& value1, const Vector& value2, double alpha)
+{
+    return value1 + (value2 - value1) * alpha;
+}
+
+// Spherical interpolation, spin adds extra half turns the same way as the Maya slerp function
+Quaternion slerp(const Quaternion& value1, const Quaternion& value2, double alpha, int spin = 0);
+
+// Interpolates scale, shear and translation linearly and rotation spherically
+Matrix lerp(const Transform& value1, const Transform& value2, double alpha);
+
+// Composes the transform components into a matrix
+Matrix compose(const Transform& transform);
+
+// Composes a matrix from translation, euler rotation and scale as [S] * [R] * [T],
+// same as MTransformationMatrix without shear or pivots
+Matrix compose(const Vector& translation, const EulerRotation& rotation, const Vector& scale);
+// Composes count matrices, one from each translation, rotation and scale triple
+void compose(const Vector* translations, const EulerRotation* rotations, const Vector* scales, size_t count, Matrix* out);
+
+// Decomposes the matrix into the components composed by compose, equivalent to MTransformationMatrix without pivots
+// A negative determinant is carried by the z scale, degenerate axes get zero scale and shear
+Transform decompose(const Matrix& matrix);
+
+inline double remapValue(double value, double low1, double high1, double low2, double high2)
+{
+    const double divisor = (high1 - low1);
+    if (almostEquals(divisor, 0.0)) return 0.0;
+
+    return low2 + (high2 - low2) * ((value - low1) / divisor);
+}
+
+inline int remapValue(int value, int low1, int high1, int low2, int high2)
+{
+    const float divisor = float(high1 - low1);
+    if (std::abs(divisor) <= std::numeric_limits<float>::epsilon()) return 0;
+
+    const float result = low2 + (high2 - low2) * ((value - low1) / divisor);
+    return result > 0.0f ? int(result + 0.5f) : int(result - 0.5f);
+}
+
+inline double distance(const Vector& value1, const Vector& value2)
+{
+    return length(value1 - value2);
+}
+
+inline double distance(const Matrix& value1, const Matrix& value2)
+{
+    return length(getTranslation(value1) - getTranslation(value2));
+}
+
+}
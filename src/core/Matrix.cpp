@@ -0,0 +1,127 @@
+// Copyright (c) 2018-2023 Serguei Kalentchouk et al. All rights reserved.
+// Use of this source code is governed by an MIT license that can be found in the LICENSE file.
+#include "Matrix.h"
+
+namespace core
+{
+
+namespace
+{
+
+const double kRigidTolerance = 1.0e-12;
+
+inline double determinant3(const Matrix& matrix)
+{
+    const auto& m = matrix.m;
+    return m[0][0] * (m[1][1] * m[2][2] - m[1][2] * m[2][1]) -
+           m[0][1] * (m[1][0] * m[2][2] - m[1][2] * m[2][0]) +
+           m[0][2] * (m[1][0] * m[2][1] - m[1][1] * m[2][0]);
+}
+
+// Moves the translation row back through the inverted 3x3 block of out
+inline void setInverseTranslation(const Matrix& matrix, Matrix& out)
+{
+    for (unsigned j = 0u; j < 3u; ++j)
+    {
+        out.m[3][j] = -(matrix.m[3][0] * out.m[0][j] + matrix.m[3][1] * out.m[1][j] + matrix.m[3][2] * out.m[2][j]);
+    }
+
+    out.m[0][3] = 0.0;
+    out.m[1][3] = 0.0;
+    out.m[2][3] = 0.0;
+    out.m[3][3] = 1.0;
+}
+
+}
+
+MatrixClass classify(const Matrix& matrix)
+{
+    if (!isAffine(matrix)) return MatrixClass::kGeneral;
+
+    const auto& m = matrix.m;
+    const double xx = m[0][0] * m[0][0] + m[0][1] * m[0][1] + m[0][2] * m[0][2];
+    const double yy = m[1][0] * m[1][0] + m[1][1] * m[1][1] + m[1][2] * m[1][2];
+    const double zz = m[2][0] * m[2][0] + m[2][1] * m[2][1] + m[2][2] * m[2][2];
+    const double xy = m[0][0] * m[1][0] + m[0][1] * m[1][1] + m[0][2] * m[1][2];
+    const double xz = m[0][0] * m[2][0] + m[0][1] * m[2][1] + m[0][2] * m[2][2];
+    const double yz = m[1][0] * m[2][0] + m[1][1] * m[2][1] + m[1][2] * m[2][2];
+
+    const double tolerance = kRigidTolerance * xx;
+    if (xx > 0.0 &&
+        std::abs(yy - xx) <= tolerance && std::abs(zz - xx) <= tolerance &&
+        std::abs(xy) <= tolerance && std::abs(xz) <= tolerance && std::abs(yz) <= tolerance)
+    {
+        return MatrixClass::kRigid;
+    }
+
+    // The determinant is compared relative to the product of the row lengths, its bound, so that near singular
+    // matrices fall back to the general inverse regardless of their scale
+    return std::abs(determinant3(matrix)) > kRigidTolerance * std::sqrt(xx * yy * zz) ? MatrixClass::kAffine
+                                                                                       : MatrixClass::kGeneral;
+}
+
+Matrix inverseRigid(const Matrix& matrix)
+{
+    const auto& m = matrix.m;
+    const double scale = 1.0 / (m[0][0] * m[0][0] + m[0][1] * m[0][1] + m[0][2] * m[0][2]);
+
+    Matrix out;
+    for (unsigned i = 0u; i < 3u; ++i)
+    {
+        for (unsigned j = 0u; j < 3u; ++j)
+        {
+            out.m[i][j] = m[j][i] * scale;
+        }
+    }
+
+    setInverseTranslation(matrix, out);
+
+    return out;
+}
+
+Matrix inverseAffine(const Matrix& matrix)
+{
+    const auto& m = matrix.m;
+    const double determinantInv = 1.0 / determinant3(matrix);
+
+    // Adjugate of the upper 3x3 divided by its determinant
+    Matrix out;
+    out.m[0][0] = (m[1][1] * m[2][2] - m[1][2] * m[2][1]) * determinantInv;
+    out.m[0][1] = (m[0][2] * m[2][1] - m[0][1] * m[2][2]) * determinantInv;
+    out.m[0][2] = (m[0][1] * m[1][2] - m[0][2] * m[1][1]) * determinantInv;
+    out.m[1][0] = (m[1][2] * m[2][0] - m[1][0] * m[2][2]) * determinantInv;
+    out.m[1][1] = (m[0][0] * m[2][2] - m[0][2] * m[2][0]) * determinantInv;
+    out.m[1][2] = (m[0][2] * m[1][0] - m[0][0] * m[1][2]) * determinantInv;
+    out.m[2][0] = (m[1][0] * m[2][1] - m[1][1] * m[2][0]) * determinantInv;
+    out.m[2][1] = (m[0][1] * m[2][0] - m[0][0] * m[2][1]) * determinantInv;
+    out.m[2][2] = (m[0][0] * m[1][1] - m[0][1] * m[1][0]) * determinantInv;
+
+    setInverseTranslation(matrix, out);
+
+    return out;
+}
+
+Matrix multiplyAffine(const Matrix& a, const Matrix& b)
+{
+    Matrix out;
+    for (unsigned i = 0u; i < 4u; ++i)
+    {
+        for (unsigned j = 0u; j < 3u; ++j)
+        {
+            out.m[i][j] = a.m[i][0] * b.m[0][j] + a.m[i][1] * b.m[1][j] + a.m[i][2] * b.m[2][j];
+        }
+    }
+
+    out.m[3][0] += b.m[3][0];
+    out.m[3][1] += b.m[3][1];
+    out.m[3][2] += b.m[3][2];
+
+    out.m[0][3] = 0.0;
+    out.m[1][3] = 0.0;
+    out.m[2][3] = 0.0;
+    out.m[3][3] = 1.0;
+
+    return out;
+}
+
+}
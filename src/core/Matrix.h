@@ -0,0 +1,36 @@
+// Copyright (c) 2018-2023 Serguei Kalentchouk et al. All rights reserved.
+// Use of this source code is governed by an MIT license that can be found in the LICENSE file.
+#pragma once
+
+#include "Types.h"
+
+namespace core
+{
+
+// Structure of a transformation matrix, from the most to the least specialized
+enum class MatrixClass
+{
+    // Affine with orthogonal axes of equal length, a rotation with uniform scale and translation
+    kRigid,
+    // Last column is (0, 0, 0, 1) and the upper 3x3 is not singular
+    kAffine,
+    kGeneral
+};
+
+inline bool isAffine(const Matrix& matrix)
+{
+    return matrix.m[0][3] == 0.0 && matrix.m[1][3] == 0.0 && matrix.m[2][3] == 0.0 && matrix.m[3][3] == 1.0;
+}
+
+// Picks the cheapest inverse that is exact for the matrix, within a relative tolerance of 1e-12 for rigid matrices
+MatrixClass classify(const Matrix& matrix);
+
+// Inverse of a rigid matrix, the transposed axes divided by the squared scale with the translation moved back
+Matrix inverseRigid(const Matrix& matrix);
+// Inverse of an affine matrix with a non singular upper 3x3
+Matrix inverseAffine(const Matrix& matrix);
+
+// Product of two affine matrices, the projective column is not computed
+Matrix multiplyAffine(const Matrix& a, const Matrix& b);
+
+}
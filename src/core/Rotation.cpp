@@ -0,0 +1,194 @@
+// Copyright (c) 2018-2023 Serguei Kalentchouk et al. All rights reserved.
+// Use of this source code is governed by an MIT license that can be found in the LICENSE file.
+#include "Rotation.h"
+
+namespace core
+{
+
+namespace
+{
+
+const double kHalfPi = 1.57079632679489661923;
+
+// Axis indices for each rotation order, from the first applied axis to the last
+const unsigned kRotationAxes[6][3] = {{0, 1, 2},
+                                      {1, 2, 0},
+                                      {2, 0, 1},
+                                      {0, 2, 1},
+                                      {1, 0, 2},
+                                      {2, 1, 0}};
+
+inline bool isOddOrder(RotationOrder order)
+{
+    return order >= kXZY;
+}
+
+inline double getComponent(const EulerRotation& rotation, unsigned axis)
+{
+    return axis == 0 ? rotation.x : (axis == 1 ? rotation.y : rotation.z);
+}
+
+inline void setComponent(EulerRotation& rotation, unsigned axis, double value)
+{
+    if (axis == 0) rotation.x = value;
+    else if (axis == 1) rotation.y = value;
+    else rotation.z = value;
+}
+
+inline Quaternion axisRotation(unsigned axis, double angle)
+{
+    Quaternion out = {0.0, 0.0, 0.0, std::cos(angle * 0.5)};
+    const double s = std::sin(angle * 0.5);
+
+    if (axis == 0) out.x = s;
+    else if (axis == 1) out.y = s;
+    else out.z = s;
+
+    return out;
+}
+
+}
+
+Quaternion MatrixToQuaternion(const Matrix& matrix)
+{
+    // w, x, y, z
+    double out[4];
+    const auto& in = matrix.m;
+
+    out[0] = 0.5 * std::sqrt(std::max(0.0, 1.0 + in[0][0] + in[1][1] + in[2][2]));
+    out[1] = 0.5 * std::sqrt(std::max(0.0, 1.0 + in[0][0] - in[1][1] - in[2][2]));
+    out[2] = 0.5 * std::sqrt(std::max(0.0, 1.0 - in[0][0] + in[1][1] - in[2][2]));
+    out[3] = 0.5 * std::sqrt(std::max(0.0, 1.0 - in[0][0] - in[1][1] + in[2][2]));
+
+    out[1] = std::copysign(out[1], in[2][1] - in[1][2]);
+    out[2] = std::copysign(out[2], in[0][2] - in[2][0]);
+    out[3] = std::copysign(out[3], in[1][0] - in[0][1]);
+
+    return conjugate(normal(Quaternion{out[1], out[2], out[3], out[0]}));
+}
+
+Quaternion toQuaternion(const EulerRotation& rotation)
+{
+    const unsigned* axes = kRotationAxes[rotation.order];
+
+    return axisRotation(axes[0], getComponent(rotation, axes[0])) *
+           axisRotation(axes[1], getComponent(rotation, axes[1])) *
+           axisRotation(axes[2], getComponent(rotation, axes[2]));
+}
+
+Matrix toMatrix(const Quaternion& rotation)
+{
+    const Quaternion q = normal(rotation);
+
+    const double xx = q.x * q.x, yy = q.y * q.y, zz = q.z * q.z;
+    const double xy = q.x * q.y, xz = q.x * q.z, yz = q.y * q.z;
+    const double wx = q.w * q.x, wy = q.w * q.y, wz = q.w * q.z;
+
+    return {{{1.0 - 2.0 * (yy + zz), 2.0 * (xy + wz), 2.0 * (xz - wy), 0.0},
+             {2.0 * (xy - wz), 1.0 - 2.0 * (xx + zz), 2.0 * (yz + wx), 0.0},
+             {2.0 * (xz + wy), 2.0 * (yz - wx), 1.0 - 2.0 * (xx + yy), 0.0},
+             {0.0, 0.0, 0.0, 1.0}}};
+}
+
+Matrix toMatrix(const EulerRotation& rotation)
+{
+    const unsigned i = kRotationAxes[rotation.order][0];
+    const unsigned j = kRotationAxes[rotation.order][1];
+    const unsigned k = kRotationAxes[rotation.order][2];
+
+    // Odd orders are the even product in a mirrored frame, which negates the angles
+    const double sign = isOddOrder(rotation.order) ? -1.0 : 1.0;
+    const double angleI = getComponent(rotation, i);
+    const double angleJ = getComponent(rotation, j);
+    const double angleK = getComponent(rotation, k);
+
+    const double ci = std::cos(angleI), si = sign * std::sin(angleI);
+    const double cj = std::cos(angleJ), sj = sign * std::sin(angleJ);
+    const double ck = std::cos(angleK), sk = sign * std::sin(angleK);
+
+    // Product of the axis rotations [Ri] * [Rj] * [Rk] expanded in place
+    Matrix out = kIdentityMatrix;
+    out.m[i][i] = cj * ck;
+    out.m[i][j] = cj * sk;
+    out.m[i][k] = -sj;
+    out.m[j][i] = si * sj * ck - ci * sk;
+    out.m[j][j] = si * sj * sk + ci * ck;
+    out.m[j][k] = si * cj;
+    out.m[k][i] = ci * sj * ck + si * sk;
+    out.m[k][j] = ci * sj * sk - si * ck;
+    out.m[k][k] = ci * cj;
+
+    return out;
+}
+
+EulerRotation toEulerRotation(const Matrix& matrix, RotationOrder order)
+{
+    // Remove scale from the rotation rows
+    double m[3][3];
+    for (unsigned row = 0u; row < 3u; ++row)
+    {
+        const double norm = std::sqrt(matrix.m[row][0] * matrix.m[row][0] +
+                                      matrix.m[row][1] * matrix.m[row][1] +
+                                      matrix.m[row][2] * matrix.m[row][2]);
+        const double scale = norm > 0.0 ? 1.0 / norm : 0.0;
+
+        m[row][0] = matrix.m[row][0] * scale;
+        m[row][1] = matrix.m[row][1] * scale;
+        m[row][2] = matrix.m[row][2] * scale;
+    }
+
+    const unsigned i = kRotationAxes[order][0];
+    const unsigned j = kRotationAxes[order][1];
+    const unsigned k = kRotationAxes[order][2];
+    const double sign = isOddOrder(order) ? -1.0 : 1.0;
+
+    double angleI, angleJ, angleK;
+    const double sinJ = -sign * m[i][k];
+
+    if (std::abs(sinJ) < 1.0 - 1.0e-12)
+    {
+        angleJ = std::asin(sinJ);
+        angleI = std::atan2(sign * m[j][k], m[k][k]);
+        angleK = std::atan2(sign * m[i][j], m[i][i]);
+    }
+    else
+    {
+        // Gimbal lock, attribute all of the remaining rotation to the first axis
+        angleJ = std::copysign(kHalfPi, sinJ);
+        angleI = std::atan2(-sign * m[k][j], m[j][j]);
+        angleK = 0.0;
+    }
+
+    EulerRotation out = {0.0, 0.0, 0.0, order};
+    setComponent(out, i, angleI);
+    setComponent(out, j, angleJ);
+    setComponent(out, k, angleK);
+
+    return out;
+}
+
+EulerRotation toEulerRotation(const Quaternion& rotation, RotationOrder order)
+{
+    return toEulerRotation(toMatrix(rotation), order);
+}
+
+double twist(const Quaternion& rotation, unsigned axis)
+{
+    if (axis > 2u) return 0.0;
+
+    // The twist is the projection of the quaternion onto the axis, its angle is 2 * atan2(q_axis, q_w)
+    double axisComponent = axis == 0u ? rotation.x : (axis == 1u ? rotation.y : rotation.z);
+    double w = rotation.w;
+
+    // q and -q are the same rotation, fold onto the positive w hemisphere to keep the angle within [-pi, pi]
+    // and report a half turn as +pi, the same as the euler decomposition of the twist rotation
+    if (w < 0.0 || (w == 0.0 && axisComponent < 0.0))
+    {
+        axisComponent = -axisComponent;
+        w = -w;
+    }
+
+    return 2.0 * std::atan2(axisComponent, w);
+}
+
+}
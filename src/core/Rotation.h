@@ -0,0 +1,26 @@
+// Copyright (c) 2018-2023 Serguei Kalentchouk et al. All rights reserved.
+// Use of this source code is governed by an MIT license that can be found in the LICENSE file.
+#pragma once
+
+#include "Types.h"
+
+namespace core
+{
+
+// Alternative matrix to quaternion conversion to overcome some numerical instability
+// observed with the output from MTransformationMatrix.rotation()
+Quaternion MatrixToQuaternion(const Matrix& matrix);
+
+// Rotation conversions, equivalent to the MEulerRotation and MQuaternion conversions
+Quaternion toQuaternion(const EulerRotation& rotation);
+Matrix toMatrix(const Quaternion& rotation);
+Matrix toMatrix(const EulerRotation& rotation);
+EulerRotation toEulerRotation(const Matrix& matrix, RotationOrder order);
+EulerRotation toEulerRotation(const Quaternion& rotation, RotationOrder order = kXYZ);
+
+// Twist angle around the given axis, in radians, from the swing-twist split of the rotation
+// Equivalent to the matching euler component of the rotation with the other two axes removed,
+// the quaternion does not need to be normalized
+double twist(const Quaternion& rotation, unsigned axis);
+
+}
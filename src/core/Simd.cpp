@@ -0,0 +1,886 @@
+// Copyright (c) 2018-2023 Serguei Kalentchouk et al. All rights reserved.
+// Use of this source code is governed by an MIT license that can be found in the LICENSE file.
+#include "Simd.h"
+
+#include <atomic>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define CORE_SIMD_X86
+#include <immintrin.h>
+#endif
+
+#if defined(CORE_SIMD_X86) && defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// GCC and Clang only accept intrinsics in functions compiled for their instruction set,
+// MSVC accepts them anywhere so the kernels are built without the rest of the library requiring the instructions
+#if defined(__GNUC__) || defined(__clang__)
+#define CORE_TARGET(isa) __attribute__((target(isa)))
+#else
+#define CORE_TARGET(isa)
+#endif
+
+namespace core
+{
+
+namespace
+{
+
+const size_t kLanes = 8u;
+// Number of elements a block kernel sums before the pairwise split takes over, must be a multiple of the lanes
+const size_t kBlockSize = 1024u;
+
+struct Kernels
+{
+    InstructionSet instructionSet;
+    double (*sumBlock)(const double*, size_t);
+    double (*clampSumBlock)(const double*, size_t, double*);
+    void (*divide)(const double*, size_t, double, double*);
+    double (*minElement)(const double*, size_t);
+    double (*maxElement)(const double*, size_t);
+    int (*sumInt)(const int*, size_t);
+    int (*minInt)(const int*, size_t);
+    int (*maxInt)(const int*, size_t);
+};
+
+// The scalar operations mirror the vector instructions, including which operand is returned for equal values and NaN
+inline double minOf(double a, double b) { return a < b ? a : b; }
+inline double maxOf(double a, double b) { return a > b ? a : b; }
+inline double clampOf(double value) { return maxOf(minOf(1.0, value), 0.0); }
+inline double add(double a, double b) { return a + b; }
+
+// Lanes are reduced in the order the vector kernels fold their registers: the upper half onto the lower half
+template <typename TOp>
+inline double reduceLanes(const double (&lanes)[kLanes], TOp op)
+{
+    return op(op(op(lanes[0], lanes[4]), op(lanes[2], lanes[6])), op(op(lanes[1], lanes[5]), op(lanes[3], lanes[7])));
+}
+
+double sumBlockScalar(const double* values, size_t count)
+{
+    double lanes[kLanes] = {};
+
+    size_t i = 0u;
+    for (; i + kLanes <= count; i += kLanes)
+    {
+        for (size_t lane = 0u; lane < kLanes; ++lane)
+        {
+            lanes[lane] += values[i + lane];
+        }
+    }
+
+    double out = reduceLanes(lanes, add);
+    for (; i < count; ++i)
+    {
+        out += values[i];
+    }
+
+    return out;
+}
+
+double clampSumBlockScalar(const double* values, size_t count, double* out)
+{
+    double lanes[kLanes] = {};
+
+    size_t i = 0u;
+    for (; i + kLanes <= count; i += kLanes)
+    {
+        for (size_t lane = 0u; lane < kLanes; ++lane)
+        {
+            out[i + lane] = clampOf(values[i + lane]);
+            lanes[lane] += out[i + lane];
+        }
+    }
+
+    double total = reduceLanes(lanes, add);
+    for (; i < count; ++i)
+    {
+        out[i] = clampOf(values[i]);
+        total += out[i];
+    }
+
+    return total;
+}
+
+void divideScalar(const double* values, size_t count, double divisor, double* out)
+{
+    for (size_t i = 0u; i < count; ++i)
+    {
+        out[i] = values[i] / divisor;
+    }
+}
+
+template <double (*TOp)(double, double)>
+double extremeScalar(const double* values, size_t count)
+{
+    if (count < kLanes)
+    {
+        double out = values[0];
+        for (size_t i = 1u; i < count; ++i)
+        {
+            out = TOp(out, values[i]);
+        }
+
+        return out;
+    }
+
+    double lanes[kLanes];
+    for (size_t lane = 0u; lane < kLanes; ++lane)
+    {
+        lanes[lane] = values[lane];
+    }
+
+    size_t i = kLanes;
+    for (; i + kLanes <= count; i += kLanes)
+    {
+        for (size_t lane = 0u; lane < kLanes; ++lane)
+        {
+            lanes[lane] = TOp(lanes[lane], values[i + lane]);
+        }
+    }
+
+    double out = reduceLanes(lanes, TOp);
+    for (; i < count; ++i)
+    {
+        out = TOp(out, values[i]);
+    }
+
+    return out;
+}
+
+// Integer sums are exact in any order, they are accumulated unsigned so that overflow wraps like the vector adds
+int sumIntScalar(const int* values, size_t count)
+{
+    unsigned out = 0u;
+    for (size_t i = 0u; i < count; ++i)
+    {
+        out += unsigned(values[i]);
+    }
+
+    return int(out);
+}
+
+int minIntScalar(const int* values, size_t count)
+{
+    int out = values[0];
+    for (size_t i = 1u; i < count; ++i)
+    {
+        out = values[i] < out ? values[i] : out;
+    }
+
+    return out;
+}
+
+int maxIntScalar(const int* values, size_t count)
+{
+    int out = values[0];
+    for (size_t i = 1u; i < count; ++i)
+    {
+        out = values[i] > out ? values[i] : out;
+    }
+
+    return out;
+}
+
+const Kernels kScalarKernels = {
+    InstructionSet::kScalar,
+    &sumBlockScalar,
+    &clampSumBlockScalar,
+    &divideScalar,
+    &extremeScalar<minOf>,
+    &extremeScalar<maxOf>,
+    &sumIntScalar,
+    &minIntScalar,
+    &maxIntScalar};
+
+#if defined(CORE_SIMD_X86)
+
+CORE_TARGET("sse2") inline double reduceSum(__m128d value)
+{
+    return _mm_cvtsd_f64(value) + _mm_cvtsd_f64(_mm_unpackhi_pd(value, value));
+}
+
+CORE_TARGET("sse2") inline double reduceMin(__m128d value)
+{
+    return minOf(_mm_cvtsd_f64(value), _mm_cvtsd_f64(_mm_unpackhi_pd(value, value)));
+}
+
+CORE_TARGET("sse2") inline double reduceMax(__m128d value)
+{
+    return maxOf(_mm_cvtsd_f64(value), _mm_cvtsd_f64(_mm_unpackhi_pd(value, value)));
+}
+
+CORE_TARGET("sse2") inline __m128d clampUnit(__m128d value)
+{
+    return _mm_max_pd(_mm_min_pd(_mm_set1_pd(1.0), value), _mm_setzero_pd());
+}
+
+CORE_TARGET("avx2") inline __m128d foldHalves(__m256d value)
+{
+    return _mm_add_pd(_mm256_castpd256_pd128(value), _mm256_extractf128_pd(value, 1));
+}
+
+CORE_TARGET("avx2") inline __m256d clampUnit(__m256d value)
+{
+    return _mm256_max_pd(_mm256_min_pd(_mm256_set1_pd(1.0), value), _mm256_setzero_pd());
+}
+
+// The unmasked AVX-512 intrinsics of GCC pass an undefined register through their mask, which -Wall reports as
+// uninitialized inside target attributed functions, the zero masked forms with every lane set compile to the same code
+CORE_TARGET("avx512f") inline __m512d min512(__m512d a, __m512d b)
+{
+    return _mm512_maskz_min_pd(__mmask8(0xFF), a, b);
+}
+
+CORE_TARGET("avx512f") inline __m512d max512(__m512d a, __m512d b)
+{
+    return _mm512_maskz_max_pd(__mmask8(0xFF), a, b);
+}
+
+// Halves of the eight lanes, _mm512_castpd512_pd256 goes through the same unmasked extract
+CORE_TARGET("avx512f") inline __m256d lowerHalf(__m512d value)
+{
+    return _mm512_maskz_extractf64x4_pd(__mmask8(0xF), value, 0);
+}
+
+CORE_TARGET("avx512f") inline __m256d upperHalf(__m512d value)
+{
+    return _mm512_maskz_extractf64x4_pd(__mmask8(0xF), value, 1);
+}
+
+CORE_TARGET("avx512f") inline __m512d clampUnit(__m512d value)
+{
+    return max512(min512(_mm512_set1_pd(1.0), value), _mm512_setzero_pd());
+}
+
+// SSE2 holds the eight lanes in four registers
+CORE_TARGET("sse2") double sumBlockSSE2(const double* values, size_t count)
+{
+    __m128d sum0 = _mm_setzero_pd();
+    __m128d sum1 = _mm_setzero_pd();
+    __m128d sum2 = _mm_setzero_pd();
+    __m128d sum3 = _mm_setzero_pd();
+
+    size_t i = 0u;
+    for (; i + kLanes <= count; i += kLanes)
+    {
+        sum0 = _mm_add_pd(sum0, _mm_loadu_pd(values + i));
+        sum1 = _mm_add_pd(sum1, _mm_loadu_pd(values + i + 2u));
+        sum2 = _mm_add_pd(sum2, _mm_loadu_pd(values + i + 4u));
+        sum3 = _mm_add_pd(sum3, _mm_loadu_pd(values + i + 6u));
+    }
+
+    double out = reduceSum(_mm_add_pd(_mm_add_pd(sum0, sum2), _mm_add_pd(sum1, sum3)));
+    for (; i < count; ++i)
+    {
+        out += values[i];
+    }
+
+    return out;
+}
+
+CORE_TARGET("sse2") double clampSumBlockSSE2(const double* values, size_t count, double* out)
+{
+    __m128d sum0 = _mm_setzero_pd();
+    __m128d sum1 = _mm_setzero_pd();
+    __m128d sum2 = _mm_setzero_pd();
+    __m128d sum3 = _mm_setzero_pd();
+
+    size_t i = 0u;
+    for (; i + kLanes <= count; i += kLanes)
+    {
+        const __m128d value0 = clampUnit(_mm_loadu_pd(values + i));
+        const __m128d value1 = clampUnit(_mm_loadu_pd(values + i + 2u));
+        const __m128d value2 = clampUnit(_mm_loadu_pd(values + i + 4u));
+        const __m128d value3 = clampUnit(_mm_loadu_pd(values + i + 6u));
+
+        _mm_storeu_pd(out + i, value0);
+        _mm_storeu_pd(out + i + 2u, value1);
+        _mm_storeu_pd(out + i + 4u, value2);
+        _mm_storeu_pd(out + i + 6u, value3);
+
+        sum0 = _mm_add_pd(sum0, value0);
+        sum1 = _mm_add_pd(sum1, value1);
+        sum2 = _mm_add_pd(sum2, value2);
+        sum3 = _mm_add_pd(sum3, value3);
+    }
+
+    double total = reduceSum(_mm_add_pd(_mm_add_pd(sum0, sum2), _mm_add_pd(sum1, sum3)));
+    for (; i < count; ++i)
+    {
+        out[i] = clampOf(values[i]);
+        total += out[i];
+    }
+
+    return total;
+}
+
+CORE_TARGET("sse2") void divideSSE2(const double* values, size_t count, double divisor, double* out)
+{
+    const __m128d divisorValue = _mm_set1_pd(divisor);
+
+    size_t i = 0u;
+    for (; i + 2u <= count; i += 2u)
+    {
+        _mm_storeu_pd(out + i, _mm_div_pd(_mm_loadu_pd(values + i), divisorValue));
+    }
+
+    divideScalar(values + i, count - i, divisor, out + i);
+}
+
+CORE_TARGET("sse2") double minElementSSE2(const double* values, size_t count)
+{
+    if (count < kLanes) return extremeScalar<minOf>(values, count);
+
+    __m128d min0 = _mm_loadu_pd(values);
+    __m128d min1 = _mm_loadu_pd(values + 2u);
+    __m128d min2 = _mm_loadu_pd(values + 4u);
+    __m128d min3 = _mm_loadu_pd(values + 6u);
+
+    size_t i = kLanes;
+    for (; i + kLanes <= count; i += kLanes)
+    {
+        min0 = _mm_min_pd(min0, _mm_loadu_pd(values + i));
+        min1 = _mm_min_pd(min1, _mm_loadu_pd(values + i + 2u));
+        min2 = _mm_min_pd(min2, _mm_loadu_pd(values + i + 4u));
+        min3 = _mm_min_pd(min3, _mm_loadu_pd(values + i + 6u));
+    }
+
+    double out = reduceMin(_mm_min_pd(_mm_min_pd(min0, min2), _mm_min_pd(min1, min3)));
+    for (; i < count; ++i)
+    {
+        out = minOf(out, values[i]);
+    }
+
+    return out;
+}
+
+CORE_TARGET("sse2") double maxElementSSE2(const double* values, size_t count)
+{
+    if (count < kLanes) return extremeScalar<maxOf>(values, count);
+
+    __m128d max0 = _mm_loadu_pd(values);
+    __m128d max1 = _mm_loadu_pd(values + 2u);
+    __m128d max2 = _mm_loadu_pd(values + 4u);
+    __m128d max3 = _mm_loadu_pd(values + 6u);
+
+    size_t i = kLanes;
+    for (; i + kLanes <= count; i += kLanes)
+    {
+        max0 = _mm_max_pd(max0, _mm_loadu_pd(values + i));
+        max1 = _mm_max_pd(max1, _mm_loadu_pd(values + i + 2u));
+        max2 = _mm_max_pd(max2, _mm_loadu_pd(values + i + 4u));
+        max3 = _mm_max_pd(max3, _mm_loadu_pd(values + i + 6u));
+    }
+
+    double out = reduceMax(_mm_max_pd(_mm_max_pd(max0, max2), _mm_max_pd(max1, max3)));
+    for (; i < count; ++i)
+    {
+        out = maxOf(out, values[i]);
+    }
+
+    return out;
+}
+
+CORE_TARGET("sse2") int sumIntSSE2(const int* values, size_t count)
+{
+    __m128i sum = _mm_setzero_si128();
+
+    size_t i = 0u;
+    for (; i + 4u <= count; i += 4u)
+    {
+        sum = _mm_add_epi32(sum, _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i)));
+    }
+
+    int lanes[4];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), sum);
+
+    return int(unsigned(sumIntScalar(lanes, 4u)) + unsigned(sumIntScalar(values + i, count - i)));
+}
+
+// AVX2 holds the eight lanes in two registers
+CORE_TARGET("avx2") double sumBlockAVX2(const double* values, size_t count)
+{
+    __m256d sum0 = _mm256_setzero_pd();
+    __m256d sum1 = _mm256_setzero_pd();
+
+    size_t i = 0u;
+    for (; i + kLanes <= count; i += kLanes)
+    {
+        sum0 = _mm256_add_pd(sum0, _mm256_loadu_pd(values + i));
+        sum1 = _mm256_add_pd(sum1, _mm256_loadu_pd(values + i + 4u));
+    }
+
+    double out = reduceSum(foldHalves(_mm256_add_pd(sum0, sum1)));
+    for (; i < count; ++i)
+    {
+        out += values[i];
+    }
+
+    return out;
+}
+
+CORE_TARGET("avx2") double clampSumBlockAVX2(const double* values, size_t count, double* out)
+{
+    __m256d sum0 = _mm256_setzero_pd();
+    __m256d sum1 = _mm256_setzero_pd();
+
+    size_t i = 0u;
+    for (; i + kLanes <= count; i += kLanes)
+    {
+        const __m256d value0 = clampUnit(_mm256_loadu_pd(values + i));
+        const __m256d value1 = clampUnit(_mm256_loadu_pd(values + i + 4u));
+
+        _mm256_storeu_pd(out + i, value0);
+        _mm256_storeu_pd(out + i + 4u, value1);
+
+        sum0 = _mm256_add_pd(sum0, value0);
+        sum1 = _mm256_add_pd(sum1, value1);
+    }
+
+    double total = reduceSum(foldHalves(_mm256_add_pd(sum0, sum1)));
+    for (; i < count; ++i)
+    {
+        out[i] = clampOf(values[i]);
+        total += out[i];
+    }
+
+    return total;
+}
+
+CORE_TARGET("avx2") void divideAVX2(const double* values, size_t count, double divisor, double* out)
+{
+    const __m256d divisorValue = _mm256_set1_pd(divisor);
+
+    size_t i = 0u;
+    for (; i + 4u <= count; i += 4u)
+    {
+        _mm256_storeu_pd(out + i, _mm256_div_pd(_mm256_loadu_pd(values + i), divisorValue));
+    }
+
+    divideScalar(values + i, count - i, divisor, out + i);
+}
+
+CORE_TARGET("avx2") double minElementAVX2(const double* values, size_t count)
+{
+    if (count < kLanes) return extremeScalar<minOf>(values, count);
+
+    __m256d min0 = _mm256_loadu_pd(values);
+    __m256d min1 = _mm256_loadu_pd(values + 4u);
+
+    size_t i = kLanes;
+    for (; i + kLanes <= count; i += kLanes)
+    {
+        min0 = _mm256_min_pd(min0, _mm256_loadu_pd(values + i));
+        min1 = _mm256_min_pd(min1, _mm256_loadu_pd(values + i + 4u));
+    }
+
+    const __m256d folded = _mm256_min_pd(min0, min1);
+    double out = reduceMin(_mm_min_pd(_mm256_castpd256_pd128(folded), _mm256_extractf128_pd(folded, 1)));
+    for (; i < count; ++i)
+    {
+        out = minOf(out, values[i]);
+    }
+
+    return out;
+}
+
+CORE_TARGET("avx2") double maxElementAVX2(const double* values, size_t count)
+{
+    if (count < kLanes) return extremeScalar<maxOf>(values, count);
+
+    __m256d max0 = _mm256_loadu_pd(values);
+    __m256d max1 = _mm256_loadu_pd(values + 4u);
+
+    size_t i = kLanes;
+    for (; i + kLanes <= count; i += kLanes)
+    {
+        max0 = _mm256_max_pd(max0, _mm256_loadu_pd(values + i));
+        max1 = _mm256_max_pd(max1, _mm256_loadu_pd(values + i + 4u));
+    }
+
+    const __m256d folded = _mm256_max_pd(max0, max1);
+    double out = reduceMax(_mm_max_pd(_mm256_castpd256_pd128(folded), _mm256_extractf128_pd(folded, 1)));
+    for (; i < count; ++i)
+    {
+        out = maxOf(out, values[i]);
+    }
+
+    return out;
+}
+
+CORE_TARGET("avx2") int sumIntAVX2(const int* values, size_t count)
+{
+    __m256i sum = _mm256_setzero_si256();
+
+    size_t i = 0u;
+    for (; i + 8u <= count; i += 8u)
+    {
+        sum = _mm256_add_epi32(sum, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i)));
+    }
+
+    int lanes[8];
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), sum);
+
+    return int(unsigned(sumIntScalar(lanes, 8u)) + unsigned(sumIntScalar(values + i, count - i)));
+}
+
+CORE_TARGET("avx2") int minIntAVX2(const int* values, size_t count)
+{
+    if (count < 8u) return minIntScalar(values, count);
+
+    __m256i min = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values));
+    for (size_t i = 8u; i + 8u <= count; i += 8u)
+    {
+        min = _mm256_min_epi32(min, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i)));
+    }
+
+    // The remaining elements overlap the last full register, which does not change the minimum
+    min = _mm256_min_epi32(min, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + count - 8u)));
+
+    int lanes[8];
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), min);
+
+    return minIntScalar(lanes, 8u);
+}
+
+CORE_TARGET("avx2") int maxIntAVX2(const int* values, size_t count)
+{
+    if (count < 8u) return maxIntScalar(values, count);
+
+    __m256i max = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values));
+    for (size_t i = 8u; i + 8u <= count; i += 8u)
+    {
+        max = _mm256_max_epi32(max, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i)));
+    }
+
+    max = _mm256_max_epi32(max, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + count - 8u)));
+
+    int lanes[8];
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), max);
+
+    return maxIntScalar(lanes, 8u);
+}
+
+// AVX-512 holds the eight lanes in a single register
+CORE_TARGET("avx512f") double sumBlockAVX512(const double* values, size_t count)
+{
+    __m512d sum = _mm512_setzero_pd();
+
+    size_t i = 0u;
+    for (; i + kLanes <= count; i += kLanes)
+    {
+        sum = _mm512_add_pd(sum, _mm512_loadu_pd(values + i));
+    }
+
+    double out = reduceSum(foldHalves(_mm256_add_pd(lowerHalf(sum), upperHalf(sum))));
+    for (; i < count; ++i)
+    {
+        out += values[i];
+    }
+
+    return out;
+}
+
+CORE_TARGET("avx512f") double clampSumBlockAVX512(const double* values, size_t count, double* out)
+{
+    __m512d sum = _mm512_setzero_pd();
+
+    size_t i = 0u;
+    for (; i + kLanes <= count; i += kLanes)
+    {
+        const __m512d value = clampUnit(_mm512_loadu_pd(values + i));
+        _mm512_storeu_pd(out + i, value);
+        sum = _mm512_add_pd(sum, value);
+    }
+
+    double total = reduceSum(foldHalves(_mm256_add_pd(lowerHalf(sum), upperHalf(sum))));
+    for (; i < count; ++i)
+    {
+        out[i] = clampOf(values[i]);
+        total += out[i];
+    }
+
+    return total;
+}
+
+CORE_TARGET("avx512f") void divideAVX512(const double* values, size_t count, double divisor, double* out)
+{
+    const __m512d divisorValue = _mm512_set1_pd(divisor);
+
+    size_t i = 0u;
+    for (; i + 8u <= count; i += 8u)
+    {
+        _mm512_storeu_pd(out + i, _mm512_div_pd(_mm512_loadu_pd(values + i), divisorValue));
+    }
+
+    divideScalar(values + i, count - i, divisor, out + i);
+}
+
+CORE_TARGET("avx512f") double minElementAVX512(const double* values, size_t count)
+{
+    if (count < kLanes) return extremeScalar<minOf>(values, count);
+
+    __m512d min = _mm512_loadu_pd(values);
+
+    size_t i = kLanes;
+    for (; i + kLanes <= count; i += kLanes)
+    {
+        min = min512(min, _mm512_loadu_pd(values + i));
+    }
+
+    const __m256d folded = _mm256_min_pd(lowerHalf(min), upperHalf(min));
+    double out = reduceMin(_mm_min_pd(_mm256_castpd256_pd128(folded), _mm256_extractf128_pd(folded, 1)));
+    for (; i < count; ++i)
+    {
+        out = minOf(out, values[i]);
+    }
+
+    return out;
+}
+
+CORE_TARGET("avx512f") double maxElementAVX512(const double* values, size_t count)
+{
+    if (count < kLanes) return extremeScalar<maxOf>(values, count);
+
+    __m512d max = _mm512_loadu_pd(values);
+
+    size_t i = kLanes;
+    for (; i + kLanes <= count; i += kLanes)
+    {
+        max = max512(max, _mm512_loadu_pd(values + i));
+    }
+
+    const __m256d folded = _mm256_max_pd(lowerHalf(max), upperHalf(max));
+    double out = reduceMax(_mm_max_pd(_mm256_castpd256_pd128(folded), _mm256_extractf128_pd(folded, 1)));
+    for (; i < count; ++i)
+    {
+        out = maxOf(out, values[i]);
+    }
+
+    return out;
+}
+
+const Kernels kSSE2Kernels = {
+    InstructionSet::kSSE2,
+    &sumBlockSSE2,
+    &clampSumBlockSSE2,
+    &divideSSE2,
+    &minElementSSE2,
+    &maxElementSSE2,
+    &sumIntSSE2,
+    &minIntScalar,
+    &maxIntScalar};
+
+const Kernels kAVX2Kernels = {
+    InstructionSet::kAVX2,
+    &sumBlockAVX2,
+    &clampSumBlockAVX2,
+    &divideAVX2,
+    &minElementAVX2,
+    &maxElementAVX2,
+    &sumIntAVX2,
+    &minIntAVX2,
+    &maxIntAVX2};
+
+// The integer kernels are bound by memory bandwidth with AVX2 already
+const Kernels kAVX512Kernels = {
+    InstructionSet::kAVX512,
+    &sumBlockAVX512,
+    &clampSumBlockAVX512,
+    &divideAVX512,
+    &minElementAVX512,
+    &maxElementAVX512,
+    &sumIntAVX2,
+    &minIntAVX2,
+    &maxIntAVX2};
+
+#endif
+
+InstructionSet detectInstructionSet()
+{
+#if !defined(CORE_SIMD_X86)
+    return InstructionSet::kScalar;
+#elif defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    const int maxLeaf = info[0];
+
+    __cpuid(info, 1);
+    const bool sse2 = (info[3] & (1 << 26)) != 0;
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const bool avx = (info[2] & (1 << 28)) != 0;
+
+    // The operating system must save the vector registers on context switches for the wider sets to be usable
+    const unsigned long long xcr0 = osxsave ? _xgetbv(0) : 0u;
+    const bool ymmState = (xcr0 & 0x6u) == 0x6u;
+    const bool zmmState = (xcr0 & 0xe6u) == 0xe6u;
+
+    bool avx2 = false;
+    bool avx512 = false;
+    if (maxLeaf >= 7)
+    {
+        __cpuidex(info, 7, 0);
+        avx2 = (info[1] & (1 << 5)) != 0;
+        avx512 = (info[1] & (1 << 16)) != 0;
+    }
+
+    if (avx && avx512 && zmmState) return InstructionSet::kAVX512;
+    if (avx && avx2 && ymmState) return InstructionSet::kAVX2;
+    if (sse2) return InstructionSet::kSSE2;
+
+    return InstructionSet::kScalar;
+#else
+    // The builtins also check that the operating system saves the vector registers
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) return InstructionSet::kAVX512;
+    if (__builtin_cpu_supports("avx2")) return InstructionSet::kAVX2;
+    if (__builtin_cpu_supports("sse2")) return InstructionSet::kSSE2;
+
+    return InstructionSet::kScalar;
+#endif
+}
+
+const Kernels& kernelsFor(InstructionSet instructionSet)
+{
+    const InstructionSet supported = supportedInstructionSet();
+    if (instructionSet > supported)
+    {
+        instructionSet = supported;
+    }
+
+    switch (instructionSet)
+    {
+#if defined(CORE_SIMD_X86)
+        case InstructionSet::kAVX512:
+            return kAVX512Kernels;
+        case InstructionSet::kAVX2:
+            return kAVX2Kernels;
+        case InstructionSet::kSSE2:
+            return kSSE2Kernels;
+#endif
+        default:
+            return kScalarKernels;
+    }
+}
+
+std::atomic<const Kernels*> activeKernels(nullptr);
+
+const Kernels& kernels()
+{
+    const Kernels* out = activeKernels.load(std::memory_order_acquire);
+    if (out == nullptr)
+    {
+        // Concurrent first uses store the same kernels
+        out = &kernelsFor(supportedInstructionSet());
+        activeKernels.store(out, std::memory_order_release);
+    }
+
+    return *out;
+}
+
+double pairwiseSum(const Kernels& kernels, const double* values, size_t count)
+{
+    if (count <= kBlockSize) return kernels.sumBlock(values, count);
+
+    const size_t half = count / 2u / kLanes * kLanes;
+    return pairwiseSum(kernels, values, half) + pairwiseSum(kernels, values + half, count - half);
+}
+
+double pairwiseClampSum(const Kernels& kernels, const double* values, size_t count, double* out)
+{
+    if (count <= kBlockSize) return kernels.clampSumBlock(values, count, out);
+
+    const size_t half = count / 2u / kLanes * kLanes;
+    return pairwiseClampSum(kernels, values, half, out) +
+           pairwiseClampSum(kernels, values + half, count - half, out + half);
+}
+
+}
+
+InstructionSet supportedInstructionSet()
+{
+    static const InstructionSet supported = detectInstructionSet();
+    return supported;
+}
+
+InstructionSet activeInstructionSet()
+{
+    return kernels().instructionSet;
+}
+
+InstructionSet selectInstructionSet(InstructionSet instructionSet)
+{
+    const Kernels& selected = kernelsFor(instructionSet);
+    activeKernels.store(&selected, std::memory_order_release);
+
+    return selected.instructionSet;
+}
+
+const char* instructionSetName(InstructionSet instructionSet)
+{
+    switch (instructionSet)
+    {
+        case InstructionSet::kSSE2:
+            return "sse2";
+        case InstructionSet::kAVX2:
+            return "avx2";
+        case InstructionSet::kAVX512:
+            return "avx512";
+        default:
+            return "scalar";
+    }
+}
+
+namespace simd
+{
+
+double sum(const double* values, size_t count)
+{
+    return pairwiseSum(kernels(), values, count);
+}
+
+int sum(const int* values, size_t count)
+{
+    return kernels().sumInt(values, count);
+}
+
+void clamp(const double* values, size_t count, double* out)
+{
+    kernels().clampSumBlock(values, count, out);
+}
+
+void divide(const double* values, size_t count, double divisor, double* out)
+{
+    kernels().divide(values, count, divisor, out);
+}
+
+double clampedSum(const double* values, size_t count, double* out)
+{
+    return pairwiseClampSum(kernels(), values, count, out);
+}
+
+double minElement(const double* values, size_t count)
+{
+    return kernels().minElement(values, count);
+}
+
+int minElement(const int* values, size_t count)
+{
+    return kernels().minInt(values, count);
+}
+
+double maxElement(const double* values, size_t count)
+{
+    return kernels().maxElement(values, count);
+}
+
+int maxElement(const int* values, size_t count)
+{
+    return kernels().maxInt(values, count);
+}
+
+}
+
+}
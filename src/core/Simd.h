@@ -0,0 +1,49 @@
+// Copyright (c) 2018-2023 Serguei Kalentchouk et al. All rights reserved.
+// Use of this source code is governed by an MIT license that can be found in the LICENSE file.
+#pragma once
+
+#include <cstddef>
+
+namespace core
+{
+
+// Instruction sets of the vectorized array kernels, ordered from the least to the most capable
+enum class InstructionSet
+{
+    kScalar,
+    kSSE2,
+    kAVX2,
+    kAVX512
+};
+
+// Best instruction set supported by the CPU and the operating system
+InstructionSet supportedInstructionSet();
+InstructionSet activeInstructionSet();
+// Selects the kernels of the given instruction set, or of the best supported one below it, and returns the selection
+// The plugin selects the supported set on load, until then the kernels are selected on first use
+InstructionSet selectInstructionSet(InstructionSet instructionSet);
+const char* instructionSetName(InstructionSet instructionSet);
+
+namespace simd
+{
+
+// Sums are computed pairwise over blocks that are accumulated in eight lanes and reduced in a fixed order,
+// every instruction set performs the same additions so the results are identical whichever one is active
+double sum(const double* values, size_t count);
+int sum(const int* values, size_t count);
+
+// Map operations write count values to out, which may alias values
+void clamp(const double* values, size_t count, double* out);
+void divide(const double* values, size_t count, double divisor, double* out);
+// Clamps the values to the unit range and returns the sum of the clamped values
+double clampedSum(const double* values, size_t count, double* out);
+
+// Count must be greater than zero
+double minElement(const double* values, size_t count);
+int minElement(const int* values, size_t count);
+double maxElement(const double* values, size_t count);
+int maxElement(const int* values, size_t count);
+
+}
+
+}
@@ -0,0 +1,224 @@
+// Copyright (c) 2018-2023 Serguei Kalentchouk et al. All rights reserved.
+// Use of this source code is governed by an MIT license that can be found in the LICENSE file.
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+
+// Maya independent value types used by the math kernels
+// Note that all types are plain aggregates and follow Maya conventions, row vectors and
+// row-major matrices, so that they can be copied to and from the Maya types member-wise
+namespace core
+{
+
+struct Vector
+{
+    double x, y, z;
+};
+
+struct Quaternion
+{
+    double x, y, z, w;
+};
+
+struct Matrix
+{
+    double m[4][4];
+
+    double* operator[](unsigned row) { return m[row]; }
+    const double* operator[](unsigned row) const { return m[row]; }
+};
+
+// Values match MEulerRotation::RotationOrder
+enum RotationOrder
+{
+    kXYZ = 0,
+    kYZX,
+    kZXY,
+    kXZY,
+    kYXZ,
+    kZYX
+};
+
+struct EulerRotation
+{
+    double x, y, z;
+    RotationOrder order;
+};
+
+// Transform decomposed into its scale, shear, rotation and translation components
+// The matrix is composed as [S] * [Sh] * [R] * [T], same as MTransformationMatrix without pivots
+struct Transform
+{
+    Vector scale;
+    Vector shear;
+    Quaternion rotation;
+    Vector translation;
+};
+
+const Vector kZeroVector = {0.0, 0.0, 0.0};
+const Quaternion kIdentityQuaternion = {0.0, 0.0, 0.0, 1.0};
+const Matrix kIdentityMatrix = {{{1.0, 0.0, 0.0, 0.0},
+                                 {0.0, 1.0, 0.0, 0.0},
+                                 {0.0, 0.0, 1.0, 0.0},
+                                 {0.0, 0.0, 0.0, 1.0}}};
+const Transform kIdentityTransform = {{1.0, 1.0, 1.0}, {0.0, 0.0, 0.0}, {0.0, 0.0, 0.0, 1.0}, {0.0, 0.0, 0.0}};
+
+
+inline bool almostEquals(double a, double b)
+{
+    return std::abs(a - b) <= std::numeric_limits<double>::epsilon() * std::max(1.0, std::abs(a + b));
+}
+
+
+// Vector operators
+inline Vector operator+(const Vector& a, const Vector& b)
+{
+    return {a.x + b.x, a.y + b.y, a.z + b.z};
+}
+
+inline Vector operator-(const Vector& a, const Vector& b)
+{
+    return {a.x - b.x, a.y - b.y, a.z - b.z};
+}
+
+inline Vector operator-(const Vector& a)
+{
+    return {-a.x, -a.y, -a.z};
+}
+
+inline Vector operator*(const Vector& a, double b)
+{
+    return {a.x * b, a.y * b, a.z * b};
+}
+
+inline Vector operator/(const Vector& a, double b)
+{
+    return {a.x / b, a.y / b, a.z / b};
+}
+
+inline double dot(const Vector& a, const Vector& b)
+{
+    return a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+inline Vector cross(const Vector& a, const Vector& b)
+{
+    return {a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x};
+}
+
+inline double length(const Vector& a)
+{
+    return std::sqrt(dot(a, a));
+}
+
+
+// Quaternion operators
+inline Quaternion operator+(const Quaternion& a, const Quaternion& b)
+{
+    return {a.x + b.x, a.y + b.y, a.z + b.z, a.w + b.w};
+}
+
+inline Quaternion operator-(const Quaternion& a, const Quaternion& b)
+{
+    return {a.x - b.x, a.y - b.y, a.z - b.z, a.w - b.w};
+}
+
+inline Quaternion operator*(const Quaternion& a, double b)
+{
+    return {a.x * b, a.y * b, a.z * b, a.w * b};
+}
+
+inline Quaternion operator/(const Quaternion& a, double b)
+{
+    return {a.x / b, a.y / b, a.z / b, a.w / b};
+}
+
+// Note that the product follows the MQuaternion convention, a * b applies a first and then b
+inline Quaternion operator*(const Quaternion& a, const Quaternion& b)
+{
+    return {b.w * a.x + b.x * a.w + b.y * a.z - b.z * a.y,
+            b.w * a.y - b.x * a.z + b.y * a.w + b.z * a.x,
+            b.w * a.z + b.x * a.y - b.y * a.x + b.z * a.w,
+            b.w * a.w - b.x * a.x - b.y * a.y - b.z * a.z};
+}
+
+inline double dot(const Quaternion& a, const Quaternion& b)
+{
+    return a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w;
+}
+
+inline Quaternion conjugate(const Quaternion& a)
+{
+    return {-a.x, -a.y, -a.z, a.w};
+}
+
+inline Quaternion normal(const Quaternion& a)
+{
+    const double norm = std::sqrt(dot(a, a));
+    if (norm == 0.0) return a;
+
+    return a / norm;
+}
+
+// Natural log of a unit quaternion, the result is a pure quaternion
+inline Quaternion log(const Quaternion& a)
+{
+    const double sinTheta = std::sqrt(a.x * a.x + a.y * a.y + a.z * a.z);
+    if (sinTheta <= std::numeric_limits<double>::epsilon()) return {a.x, a.y, a.z, 0.0};
+
+    const double scale = std::atan2(sinTheta, a.w) / sinTheta;
+    return {a.x * scale, a.y * scale, a.z * scale, 0.0};
+}
+
+// Exponent of a pure quaternion, the scalar component is ignored
+inline Quaternion exp(const Quaternion& a)
+{
+    const double theta = std::sqrt(a.x * a.x + a.y * a.y + a.z * a.z);
+    if (theta <= std::numeric_limits<double>::epsilon()) return {a.x, a.y, a.z, std::cos(theta)};
+
+    const double scale = std::sin(theta) / theta;
+    return {a.x * scale, a.y * scale, a.z * scale, std::cos(theta)};
+}
+
+
+// Transform operators, component-wise so that terms of transform averages can be accumulated
+inline Transform operator+(const Transform& a, const Transform& b)
+{
+    return {a.scale + b.scale, a.shear + b.shear, a.rotation + b.rotation, a.translation + b.translation};
+}
+
+inline Transform operator-(const Transform& a, const Transform& b)
+{
+    return {a.scale - b.scale, a.shear - b.shear, a.rotation - b.rotation, a.translation - b.translation};
+}
+
+inline Transform operator*(const Transform& a, double b)
+{
+    return {a.scale * b, a.shear * b, a.rotation * b, a.translation * b};
+}
+
+
+// Matrix operators
+inline Matrix operator*(const Matrix& a, const Matrix& b)
+{
+    Matrix out;
+    for (unsigned i = 0u; i < 4u; ++i)
+    {
+        for (unsigned j = 0u; j < 4u; ++j)
+        {
+            out.m[i][j] = a.m[i][0] * b.m[0][j] + a.m[i][1] * b.m[1][j] + a.m[i][2] * b.m[2][j] + a.m[i][3] * b.m[3][j];
+        }
+    }
+
+    return out;
+}
+
+inline Vector getTranslation(const Matrix& a)
+{
+    return {a.m[3][0], a.m[3][1], a.m[3][2]};
+}
+
+}
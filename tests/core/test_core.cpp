@@ -0,0 +1,556 @@
+// Copyright (c) 2018-2023 Serguei Kalentchouk et al. All rights reserved.
+// Use of this source code is governed by an MIT license that can be found in the LICENSE file.
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "../../src/core/Array.h"
+#include "../../src/core/Interpolate.h"
+#include "../../src/core/Matrix.h"
+#include "../../src/core/Rotation.h"
+#include "../../src/core/Simd.h"
+
+// Core library unittest
+// The expected values mirror the node tests so the kernels can be verified without Maya
+namespace
+{
+
+const double kDegrees = 3.14159265358979323846 / 180.0;
+
+int failures = 0;
+
+void check(bool condition, const char* expression, const char* file, int line)
+{
+    if (!condition)
+    {
+        std::printf("%s:%d: check failed: %s\n", file, line, expression);
+        ++failures;
+    }
+}
+
+#define CHECK(expression) check((expression), #expression, __FILE__, __LINE__)
+#define CHECK_CLOSE(a, b, tolerance) check(std::abs((a) - (b)) <= (tolerance), #a " == " #b, __FILE__, __LINE__)
+
+void checkMatrix(const core::Matrix& matrix, const double (&expected)[16], double tolerance, int line)
+{
+    for (unsigned i = 0u; i < 16u; ++i)
+    {
+        check(std::abs(matrix.m[i / 4][i % 4] - expected[i]) <= tolerance, "matrix element", __FILE__, line);
+    }
+}
+
+void testArray()
+{
+    const double values[] = {5.0, -3.0, 2.0};
+    const int intValues[] = {3, 2, 2};
+    const double weights[] = {1.0, 0.5, 0.25};
+
+    CHECK_CLOSE(core::sum(values, 3), 4.0, 1e-12);
+    CHECK(core::sum(intValues, 3) == 7);
+    CHECK_CLOSE(core::average(intValues, 3), 7.0 / 3.0, 1e-12);
+    CHECK_CLOSE(core::average(values, 0), 0.0, 1e-12);
+    CHECK_CLOSE(core::maxElement(values, 3), 5.0, 1e-12);
+    CHECK_CLOSE(core::minElement(values, 3), -3.0, 1e-12);
+
+    const core::Vector vectors[] = {{1.0, 0.0, 0.0}, {0.0, 1.0, 0.0}, {0.0, 0.0, 1.0}};
+    const core::Vector weighted = core::average(vectors, weights, 3);
+    CHECK_CLOSE(weighted.x, 0.571428, 1e-6);
+    CHECK_CLOSE(weighted.y, 0.285714, 1e-6);
+    CHECK_CLOSE(weighted.z, 0.142857, 1e-6);
+
+    const double rawWeights[] = {0.8, 0.2, -0.2, 1.2};
+    double normalized[4];
+    core::normalizeWeights(rawWeights, 4, normalized);
+    CHECK_CLOSE(normalized[0], 0.4, 1e-12);
+    CHECK_CLOSE(normalized[1], 0.1, 1e-12);
+    CHECK_CLOSE(normalized[2], 0.0, 1e-12);
+    CHECK_CLOSE(normalized[3], 0.5, 1e-12);
+
+    const double arrayValues[] = {40.0, 10.0};
+    core::normalize(arrayValues, 2, normalized);
+    CHECK_CLOSE(normalized[0], 0.8, 1e-12);
+    CHECK_CLOSE(normalized[1], 0.2, 1e-12);
+}
+
+void testAverageRotation()
+{
+    const core::Quaternion quaternions[] = {{0.0, 0.0, 0.0, 1.0},
+                                            {0.0, 0.7071068, 0.0, 0.7071068},
+                                            {-0.7071068, 0.0, 0.0, 0.7071068}};
+    const core::Quaternion quaternion = core::average(quaternions, 3);
+    CHECK_CLOSE(quaternion.x, -0.256, 1e-3);
+    CHECK_CLOSE(quaternion.y, 0.256, 1e-3);
+    CHECK_CLOSE(quaternion.z, 0.0, 1e-3);
+    CHECK_CLOSE(quaternion.w, 0.932, 1e-3);
+
+    const core::EulerRotation rotations[] = {{0.0, 0.0, 0.0, core::kXYZ},
+                                             {0.0, 90.0 * kDegrees, 0.0, core::kXYZ},
+                                             {-90.0 * kDegrees, 0.0, 0.0, core::kXYZ}};
+    const double weights[] = {1.0 / 3.0, 1.0 / 3.0, 1.0 / 3.0};
+    const core::EulerRotation rotation = core::average(rotations, weights, 3);
+    CHECK_CLOSE(rotation.x / kDegrees, -32.874, 1e-3);
+    CHECK_CLOSE(rotation.y / kDegrees, 28.493, 1e-3);
+    CHECK_CLOSE(rotation.z / kDegrees, -8.567, 1e-3);
+}
+
+void testAverageMatrix()
+{
+    const core::Matrix matrix2 = {{{0.0, 0.0, -1.0, 0.0}, {0.0, 1.0, 0.0, 0.0}, {1.0, 0.0, 0.0, 0.0}, {2.0, 0.0, 0.0, 1.0}}};
+    const core::Matrix matrix3 = {{{1.0, 0.0, 0.0, 0.0}, {0.0, 0.0, -1.0, 0.0}, {0.0, 1.0, 0.0, 0.0}, {0.0, 0.0, 2.0, 1.0}}};
+
+    const core::Transform transforms[] = {
+        core::kIdentityTransform,
+        {{1.0, 1.0, 1.0}, core::kZeroVector, core::MatrixToQuaternion(matrix2), core::getTranslation(matrix2)},
+        {{1.0, 1.0, 1.0}, core::kZeroVector, core::MatrixToQuaternion(matrix3), core::getTranslation(matrix3)}};
+
+    const double expected[16] = {0.869, -0.131, -0.477, 0.0,
+                                 -0.131, 0.869, -0.477, 0.0,
+                                 0.477, 0.477, 0.738, 0.0,
+                                 0.667, 0.0, 0.667, 1.0};
+
+    checkMatrix(core::average(transforms, 3), expected, 1e-3, __LINE__);
+
+    const double weights[] = {1.0 / 3.0, 1.0 / 3.0, 1.0 / 3.0};
+    checkMatrix(core::average(transforms, weights, 3), expected, 1e-3, __LINE__);
+}
+
+void testAverageTerms()
+{
+    const core::Quaternion quaternions[] = {{0.0, 0.0, 0.0, 1.0},
+                                            {0.0, 0.7071068, 0.0, 0.7071068},
+                                            {-0.7071068, 0.0, 0.0, 0.7071068}};
+    const double weights[] = {1.0, 0.5, 0.25};
+
+    // Replacing the term of one element in the running totals matches the average computed from scratch
+    core::Quaternion total = {0.0, 0.0, 0.0, 0.0};
+    double totalWeight = 0.0;
+    for (unsigned i = 0u; i < 3u; ++i)
+    {
+        total = total + core::averageTerm(quaternions[i], weights[i]);
+        totalWeight += weights[i];
+    }
+
+    const core::Quaternion replaced[] = {quaternions[0], quaternions[1], {0.0, 0.0, 0.7071068, 0.7071068}};
+    total = total - core::averageTerm(quaternions[2], weights[2]) + core::averageTerm(replaced[2], weights[2]);
+
+    const core::Quaternion running = core::averageFromTerms(total, totalWeight);
+    const core::Quaternion expected = core::average(replaced, weights, 3);
+    CHECK_CLOSE(running.x, expected.x, 1e-12);
+    CHECK_CLOSE(running.y, expected.y, 1e-12);
+    CHECK_CLOSE(running.z, expected.z, 1e-12);
+    CHECK_CLOSE(running.w, expected.w, 1e-12);
+
+    // Totals of contiguous terms match the running totals
+    core::Quaternion terms[3];
+    for (unsigned i = 0u; i < 3u; ++i)
+    {
+        terms[i] = core::averageTerm(replaced[i], weights[i]);
+    }
+
+    const core::Quaternion summed = core::averageFromTerms(core::sum(terms, 3), core::sum(weights, 3));
+    CHECK_CLOSE(summed.x, expected.x, 1e-12);
+    CHECK_CLOSE(summed.y, expected.y, 1e-12);
+    CHECK_CLOSE(summed.z, expected.z, 1e-12);
+    CHECK_CLOSE(summed.w, expected.w, 1e-12);
+
+    CHECK_CLOSE(core::averageFromTerms(core::averageTerm(2.0, 0.0), 0.0), 0.0, 1e-12);
+    CHECK_CLOSE(core::averageFromTerms(core::averageTerm(2.0, 0.5) + core::averageTerm(4.0, 1.5), 2.0), 3.5, 1e-12);
+}
+
+void testInterpolate()
+{
+    const core::Quaternion identity = core::kIdentityQuaternion;
+    const core::Quaternion flipped = {1.0, 0.0, 0.0, 0.0};
+
+    const core::Quaternion shortPath = core::slerp(identity, flipped, 0.5);
+    CHECK_CLOSE(shortPath.x, 0.7071, 1e-4);
+    CHECK_CLOSE(shortPath.w, 0.7071, 1e-4);
+
+    const core::Quaternion longPath = core::slerp(identity, flipped, 0.5, -1);
+    CHECK_CLOSE(longPath.x, -0.7071, 1e-4);
+    CHECK_CLOSE(longPath.w, 0.7071, 1e-4);
+
+    const core::Transform transform1 = {{1.0, 1.0, 1.0}, core::kZeroVector, identity, {10.0, -10.0, 10.0}};
+    const core::Transform transform2 = {{1.0, 1.0, 1.0}, core::kZeroVector, {0.0, 1.0, 0.0, 0.0}, {5.0, -5.0, 5.0}};
+    const double expected[16] = {0.0, 0.0, -1.0, 0.0,
+                                 0.0, 1.0, 0.0, 0.0,
+                                 1.0, 0.0, 0.0, 0.0,
+                                 7.5, -7.5, 7.5, 1.0};
+
+    checkMatrix(core::lerp(transform1, transform2, 0.5), expected, 1e-6, __LINE__);
+
+    CHECK_CLOSE(core::remapValue(0.5, 0.0, 1.0, 10.0, 20.0), 15.0, 1e-12);
+    CHECK_CLOSE(core::remapValue(0.5, 1.0, 1.0, 10.0, 20.0), 0.0, 1e-12);
+    CHECK(core::remapValue(5, 0, 10, 0, 3) == 2);
+    CHECK_CLOSE(core::distance(core::Vector{1.0, 2.0, 2.0}, core::kZeroVector), 3.0, 1e-12);
+}
+
+void testComposeShear()
+{
+    const core::Transform transform = {{2.0, 3.0, 4.0}, {0.5, 0.25, 0.75}, core::kIdentityQuaternion, core::kZeroVector};
+    const double expected[16] = {2.0, 0.0, 0.0, 0.0,
+                                 1.5, 3.0, 0.0, 0.0,
+                                 1.0, 3.0, 4.0, 0.0,
+                                 0.0, 0.0, 0.0, 1.0};
+
+    checkMatrix(core::compose(transform), expected, 1e-12, __LINE__);
+}
+
+double randomRange(double low, double high)
+{
+    return low + (high - low) * (std::rand() / double(RAND_MAX));
+}
+
+void testDecompose()
+{
+    std::srand(11);
+    for (unsigned iteration = 0u; iteration < 500u; ++iteration)
+    {
+        const core::EulerRotation rotation = {randomRange(-3.0, 3.0), randomRange(-3.0, 3.0), randomRange(-3.0, 3.0),
+                                              core::RotationOrder(iteration % 6u)};
+        const core::Transform transform = {{randomRange(0.1, 4.0), randomRange(0.1, 4.0), randomRange(0.1, 4.0)},
+                                           {randomRange(-1.0, 1.0), randomRange(-1.0, 1.0), randomRange(-1.0, 1.0)},
+                                           core::toQuaternion(rotation),
+                                           {randomRange(-10.0, 10.0), randomRange(-10.0, 10.0), randomRange(-10.0, 10.0)}};
+
+        // Positive scales are recovered component-wise, rotations up to the sign of the quaternion
+        const core::Transform result = core::decompose(core::compose(transform));
+        CHECK_CLOSE(result.scale.x, transform.scale.x, 1e-9);
+        CHECK_CLOSE(result.scale.y, transform.scale.y, 1e-9);
+        CHECK_CLOSE(result.scale.z, transform.scale.z, 1e-9);
+        CHECK_CLOSE(result.shear.x, transform.shear.x, 1e-9);
+        CHECK_CLOSE(result.shear.y, transform.shear.y, 1e-9);
+        CHECK_CLOSE(result.shear.z, transform.shear.z, 1e-9);
+        CHECK_CLOSE(std::abs(core::dot(result.rotation, transform.rotation)), 1.0, 1e-9);
+        CHECK_CLOSE(result.translation.x, transform.translation.x, 1e-12);
+
+        // Negative scales are folded into the rotation and the z scale, the matrix is still recovered
+        core::Transform mirrored = transform;
+        mirrored.scale.x = -mirrored.scale.x;
+        const core::Matrix matrix = core::compose(mirrored);
+        const core::Matrix roundTrip = core::compose(core::decompose(matrix));
+        for (unsigned i = 0u; i < 16u; ++i)
+        {
+            CHECK_CLOSE(roundTrip.m[i / 4][i % 4], matrix.m[i / 4][i % 4], 1e-9);
+        }
+    }
+
+    // A collapsed axis keeps a valid rotation
+    const core::Matrix flat = {{{2.0, 0.0, 0.0, 0.0}, {4.0, 0.0, 0.0, 0.0}, {0.0, 0.0, 3.0, 0.0}, {0.0, 0.0, 0.0, 1.0}}};
+    const core::Transform result = core::decompose(flat);
+    CHECK(result.scale.x == 2.0 && result.scale.y == 0.0 && result.shear.x == 0.0);
+    CHECK_CLOSE(core::dot(result.rotation, result.rotation), 1.0, 1e-12);
+}
+
+void testComposeTRS()
+{
+    std::srand(17);
+    core::Vector translations[60];
+    core::EulerRotation rotations[60];
+    core::Vector scales[60];
+    for (unsigned i = 0u; i < 60u; ++i)
+    {
+        translations[i] = {randomRange(-10.0, 10.0), randomRange(-10.0, 10.0), randomRange(-10.0, 10.0)};
+        rotations[i] = {randomRange(-3.0, 3.0), randomRange(-3.0, 3.0), randomRange(-3.0, 3.0), core::RotationOrder(i % 6u)};
+        scales[i] = {randomRange(-4.0, 4.0), randomRange(-4.0, 4.0), randomRange(-4.0, 4.0)};
+    }
+
+    core::Matrix batch[60];
+    core::compose(translations, rotations, scales, 60u, batch);
+
+    for (unsigned i = 0u; i < 60u; ++i)
+    {
+        // Same result as the transform composition through a quaternion
+        const core::Transform transform = {scales[i], core::kZeroVector, core::toQuaternion(rotations[i]), translations[i]};
+        const core::Matrix expected = core::compose(transform);
+        const core::Matrix matrix = core::compose(translations[i], rotations[i], scales[i]);
+        for (unsigned j = 0u; j < 16u; ++j)
+        {
+            CHECK_CLOSE(matrix.m[j / 4][j % 4], expected.m[j / 4][j % 4], 1e-9);
+            CHECK(batch[i].m[j / 4][j % 4] == matrix.m[j / 4][j % 4]);
+        }
+    }
+}
+
+void checkIdentity(const core::Matrix& matrix, double tolerance, int line)
+{
+    checkMatrix(matrix, {1.0, 0.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 0.0, 1.0}, tolerance, line);
+}
+
+void testMatrixFastPaths()
+{
+    std::srand(19);
+    for (unsigned iteration = 0u; iteration < 200u; ++iteration)
+    {
+        const core::EulerRotation rotation = {randomRange(-3.0, 3.0), randomRange(-3.0, 3.0), randomRange(-3.0, 3.0),
+                                              core::RotationOrder(iteration % 6u)};
+        const core::Vector translation = {randomRange(-10.0, 10.0), randomRange(-10.0, 10.0), randomRange(-10.0, 10.0)};
+        const double uniform = randomRange(0.1, 4.0);
+
+        const core::Matrix rigid = core::compose(translation, rotation, {uniform, uniform, uniform});
+        CHECK(core::classify(rigid) == core::MatrixClass::kRigid);
+        checkIdentity(rigid * core::inverseRigid(rigid), 1e-9, __LINE__);
+
+        const core::Transform transform = {{uniform, randomRange(0.1, 4.0), -randomRange(0.1, 4.0)},
+                                           {randomRange(-1.0, 1.0), randomRange(-1.0, 1.0), randomRange(-1.0, 1.0)},
+                                           core::toQuaternion(rotation), translation};
+        const core::Matrix affine = core::compose(transform);
+        CHECK(core::classify(affine) == core::MatrixClass::kAffine);
+        checkIdentity(affine * core::inverseAffine(affine), 1e-9, __LINE__);
+
+        // The affine product performs the same sums as the general product
+        const core::Matrix product = core::multiplyAffine(rigid, affine);
+        const core::Matrix expected = rigid * affine;
+        for (unsigned i = 0u; i < 16u; ++i)
+        {
+            CHECK(product.m[i / 4][i % 4] == expected.m[i / 4][i % 4]);
+        }
+    }
+
+    core::Matrix projective = core::kIdentityMatrix;
+    projective.m[0][3] = 0.5;
+    CHECK(core::classify(projective) == core::MatrixClass::kGeneral);
+    CHECK(!core::isAffine(projective));
+
+    core::Matrix singular = core::kIdentityMatrix;
+    singular.m[2][2] = 0.0;
+    CHECK(core::classify(singular) == core::MatrixClass::kGeneral);
+
+    // Near singular matrices are classified relative to their scale
+    core::Matrix nearSingular = core::kIdentityMatrix;
+    nearSingular.m[2][0] = 1.0;
+    nearSingular.m[2][1] = 1.0;
+    nearSingular.m[2][2] = 1.0e-14;
+    CHECK(core::classify(nearSingular) == core::MatrixClass::kGeneral);
+
+    core::Matrix small = core::kIdentityMatrix;
+    small.m[0][0] = 1.0e-6;
+    small.m[1][1] = 2.0e-6;
+    small.m[2][2] = 3.0e-6;
+    CHECK(core::classify(small) == core::MatrixClass::kAffine);
+}
+
+// Reference euler matrix built from the individual axis rotations, row vector convention
+core::Matrix eulerMatrix(const core::EulerRotation& rotation)
+{
+    const unsigned axes[6][3] = {{0, 1, 2}, {1, 2, 0}, {2, 0, 1}, {0, 2, 1}, {1, 0, 2}, {2, 1, 0}};
+    const double angles[3] = {rotation.x, rotation.y, rotation.z};
+
+    core::Matrix out = core::kIdentityMatrix;
+    for (unsigned index = 0u; index < 3u; ++index)
+    {
+        const unsigned axis = axes[rotation.order][index];
+        const unsigned a = (axis + 1) % 3;
+        const unsigned b = (axis + 2) % 3;
+        const double c = std::cos(angles[axis]);
+        const double s = std::sin(angles[axis]);
+
+        core::Matrix axisMatrix = core::kIdentityMatrix;
+        axisMatrix.m[a][a] = c;
+        axisMatrix.m[a][b] = s;
+        axisMatrix.m[b][a] = -s;
+        axisMatrix.m[b][b] = c;
+
+        out = out * axisMatrix;
+    }
+
+    return out;
+}
+
+void testEulerConversions()
+{
+    std::srand(7);
+    for (unsigned iteration = 0u; iteration < 200u; ++iteration)
+    {
+        for (int order = core::kXYZ; order <= core::kZYX; ++order)
+        {
+            const double x = (std::rand() / double(RAND_MAX) - 0.5) * 3.0;
+            const double y = (std::rand() / double(RAND_MAX) - 0.5) * 3.0;
+            const double z = (std::rand() / double(RAND_MAX) - 0.5) * 3.0;
+            const core::EulerRotation rotation = {x, y, z, core::RotationOrder(order)};
+
+            const core::Matrix reference = eulerMatrix(rotation);
+            const core::Matrix matrix = core::toMatrix(rotation);
+            for (unsigned i = 0u; i < 16u; ++i)
+            {
+                CHECK_CLOSE(matrix.m[i / 4][i % 4], reference.m[i / 4][i % 4], 1e-9);
+            }
+
+            const core::EulerRotation result = core::toEulerRotation(reference, core::RotationOrder(order));
+            const core::Matrix roundTrip = eulerMatrix(result);
+            for (unsigned i = 0u; i < 16u; ++i)
+            {
+                CHECK_CLOSE(roundTrip.m[i / 4][i % 4], reference.m[i / 4][i % 4], 1e-9);
+            }
+
+            const core::Quaternion quaternion = core::MatrixToQuaternion(reference);
+            const core::Matrix quaternionMatrix = core::toMatrix(quaternion);
+            for (unsigned i = 0u; i < 16u; ++i)
+            {
+                CHECK_CLOSE(quaternionMatrix.m[i / 4][i % 4], reference.m[i / 4][i % 4], 1e-9);
+            }
+        }
+    }
+
+    // Gimbal lock
+    for (int order = core::kXYZ; order <= core::kZYX; ++order)
+    {
+        const double axes[6][3] = {{0.3, 1.0, -0.2}, {-0.2, 0.3, 1.0}, {1.0, -0.2, 0.3},
+                                   {0.3, -0.2, 1.0}, {1.0, 0.3, -0.2}, {-0.2, 1.0, 0.3}};
+        const double halfPi = 90.0 * kDegrees;
+        const core::EulerRotation rotation = {axes[order][0] == 1.0 ? halfPi : axes[order][0],
+                                              axes[order][1] == 1.0 ? halfPi : axes[order][1],
+                                              axes[order][2] == 1.0 ? halfPi : axes[order][2],
+                                              core::RotationOrder(order)};
+
+        const core::Matrix reference = eulerMatrix(rotation);
+        const core::Matrix roundTrip = eulerMatrix(core::toEulerRotation(reference, core::RotationOrder(order)));
+        for (unsigned i = 0u; i < 16u; ++i)
+        {
+            CHECK_CLOSE(roundTrip.m[i / 4][i % 4], reference.m[i / 4][i % 4], 1e-9);
+        }
+    }
+}
+
+void testTwist()
+{
+    const core::EulerRotation rotation = {0.0, -90.0 * kDegrees, -90.0 * kDegrees, core::kXYZ};
+    CHECK_CLOSE(core::twist(core::toQuaternion(rotation), 0) / kDegrees, -90.0, 1e-4);
+
+    const core::Matrix matrix = {{{0.0, 0.0, 1.0, 0.0}, {1.0, 0.0, 0.0, 0.0}, {0.0, 1.0, 0.0, 0.0}, {0.0, 0.0, 0.0, 1.0}}};
+    CHECK_CLOSE(core::twist(core::MatrixToQuaternion(matrix), 0) / kDegrees, -90.0, 1e-4);
+
+    // Half turns are reported as +pi whichever sign the quaternion has
+    const double kPi = 180.0 * kDegrees;
+    CHECK_CLOSE(core::twist({1.0, 0.0, 0.0, 0.0}, 0), kPi, 1e-12);
+    CHECK_CLOSE(core::twist({-1.0, 0.0, 0.0, 0.0}, 0), kPi, 1e-12);
+    CHECK_CLOSE(core::twist({0.0, 0.0, -1.0, -0.0}, 2), kPi, 1e-12);
+    CHECK_CLOSE(core::twist({0.0, 1.0, 0.0, 0.0}, 0), 0.0, 1e-12);
+
+    std::srand(13);
+    for (unsigned iteration = 0u; iteration < 200u; ++iteration)
+    {
+        for (int order = core::kXYZ; order <= core::kZYX; ++order)
+        {
+            const core::EulerRotation rotation = {randomRange(-3.0, 3.0), randomRange(-3.0, 3.0), randomRange(-3.0, 3.0),
+                                                  core::RotationOrder(order)};
+            const core::Quaternion quaternion = core::toQuaternion(rotation);
+            const double components[3] = {quaternion.x, quaternion.y, quaternion.z};
+
+            for (unsigned axis = 0u; axis < 3u; ++axis)
+            {
+                // Reference twist from the euler decomposition of the rotation with the other two axes removed,
+                // in an order that applies the axis first so that its angle is not folded into [-pi/2, pi/2]
+                const core::RotationOrder firstAxisOrders[3] = {core::kXYZ, core::kYZX, core::kZXY};
+                core::Quaternion twistRotation = {0.0, 0.0, 0.0, quaternion.w};
+                if (axis == 0u) twistRotation.x = components[0];
+                else if (axis == 1u) twistRotation.y = components[1];
+                else twistRotation.z = components[2];
+
+                const core::EulerRotation reference = core::toEulerRotation(core::normal(twistRotation), firstAxisOrders[axis]);
+                const double expected = axis == 0u ? reference.x : (axis == 1u ? reference.y : reference.z);
+                CHECK_CLOSE(core::twist(quaternion, axis), expected, 1e-9);
+                CHECK_CLOSE(core::twist(quaternion * 3.0, axis), expected, 1e-9);
+                CHECK_CLOSE(core::twist(quaternion * -1.0, axis), expected, 1e-9);
+            }
+
+            // A rotation around a single axis twists by its angle in every order
+            const double angle = randomRange(-3.0, 3.0);
+            const core::EulerRotation single = {0.0, angle, 0.0, core::RotationOrder(order)};
+            CHECK_CLOSE(core::twist(core::toQuaternion(single), 1), angle, 1e-9);
+        }
+    }
+}
+
+void testSimd()
+{
+    // Odd sizes exercise the block splits and the remainders, the magnitudes make the summation order visible
+    std::vector<double> values(10007u);
+    std::vector<int> intValues(values.size());
+    for (size_t i = 0u; i < values.size(); ++i)
+    {
+        values[i] = std::sin(double(i) * 0.37) * std::pow(10.0, double(i % 10u) - 9.0);
+        intValues[i] = int(i * 7919u % 2003u) - 1000;
+    }
+    values[4321] = 3.5;
+    values[9999] = -2.5;
+
+    double expectedSum = 0.0;
+    int expectedIntSum = 0;
+    for (size_t i = 0u; i < values.size(); ++i)
+    {
+        expectedSum += values[i];
+        expectedIntSum += intValues[i];
+    }
+
+    const size_t sizes[] = {0u, 1u, 7u, 8u, 9u, 1024u, 1025u, 4099u, values.size()};
+    const core::InstructionSet original = core::activeInstructionSet();
+
+    for (const size_t size : sizes)
+    {
+        core::selectInstructionSet(core::InstructionSet::kScalar);
+        std::vector<double> scalarWeights(size);
+        const double scalarSum = core::sum(values.data(), size);
+        const double scalarMin = core::minElement(values.data(), size);
+        const double scalarMax = core::maxElement(values.data(), size);
+        core::normalizeWeights(values.data(), size, scalarWeights.data());
+
+        for (int set = int(core::InstructionSet::kSSE2); set <= int(core::supportedInstructionSet()); ++set)
+        {
+            // Every instruction set must return the same bits as the scalar kernels
+            core::selectInstructionSet(core::InstructionSet(set));
+            std::vector<double> weights(size);
+            const double sum = core::sum(values.data(), size);
+            const double min = core::minElement(values.data(), size);
+            const double max = core::maxElement(values.data(), size);
+            core::normalizeWeights(values.data(), size, weights.data());
+
+            CHECK(std::memcmp(&sum, &scalarSum, sizeof(double)) == 0);
+            CHECK(std::memcmp(&min, &scalarMin, sizeof(double)) == 0);
+            CHECK(std::memcmp(&max, &scalarMax, sizeof(double)) == 0);
+            CHECK(size == 0u || std::memcmp(weights.data(), scalarWeights.data(), size * sizeof(double)) == 0);
+        }
+    }
+
+    for (int set = int(core::InstructionSet::kScalar); set <= int(core::supportedInstructionSet()); ++set)
+    {
+        core::selectInstructionSet(core::InstructionSet(set));
+        CHECK_CLOSE(core::sum(values.data(), values.size()), expectedSum, 1e-9);
+        CHECK(core::sum(intValues.data(), intValues.size()) == expectedIntSum);
+        CHECK(core::minElement(intValues.data(), intValues.size()) == -1000);
+        CHECK(core::maxElement(intValues.data(), intValues.size()) == 1002);
+        CHECK(core::maxElement(values.data(), values.size()) == 3.5);
+        CHECK(core::minElement(values.data(), values.size()) == -2.5);
+
+        std::vector<double> clamped(values.size());
+        core::clamp(values.data(), values.size(), clamped.data());
+        CHECK(clamped[4321] == 1.0 && clamped[9999] == 0.0);
+    }
+
+    core::selectInstructionSet(original);
+}
+
+}
+
+int main()
+{
+    std::printf("Maya Math Nodes Core Unittest\n");
+
+    testArray();
+    testSimd();
+    testAverageRotation();
+    testAverageMatrix();
+    testAverageTerms();
+    testInterpolate();
+    testComposeShear();
+    testDecompose();
+    testComposeTRS();
+    testMatrixFastPaths();
+    testEulerConversions();
+    testTwist();
+
+    std::printf("Test results: %d failure(s)\n", failures);
+
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
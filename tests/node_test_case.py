@@ -42,6 +42,34 @@ class NodeTestCase(unittest.TestCase):
             else:
                 cmds.setAttr('{0}.{1}'.format(node, attr), inputs[attr])
         
+        self.assertOutput(node, output, places)
+        
+        return node
+    
+    def create_array_data_node(self, node_type, inputs, output, places=4):
+        """Typed array data node test utility
+        
+        Same as create_node except that inputs are provided as dictionary of attribute name and a tuple of
+        data type and values, ex: {'input': ('doubleArray', [1.0, 2.0])}.
+        """
+        full_node_type = '{0}{1}'.format(node_name_prefix, node_type)
+        
+        node = cmds.createNode(full_node_type, skipSelect=True)
+        self.assertTrue(cmds.objectType(node, isType=full_node_type))
+        
+        for attr in inputs:
+            data_type, values = inputs[attr]
+            if data_type == 'vectorArray':
+                cmds.setAttr('{0}.{1}'.format(node, attr), len(values), *values, type=data_type)
+            else:
+                cmds.setAttr('{0}.{1}'.format(node, attr), values, type=data_type)
+        
+        self.assertOutput(node, output, places)
+        
+        return node
+    
+    def assertOutput(self, node, output, places=4):
+        """Assert that the node output matches the expected value"""
         if isinstance(output, bool):
             self.assertEquals(cmds.getAttr('{0}.output'.format(node)), output)
         elif isinstance(output, list):
@@ -52,8 +80,6 @@ class NodeTestCase(unittest.TestCase):
             self.assertItemsAlmostEqual(result, output, places)
         else:
             self.assertAlmostEqual(cmds.getAttr('{0}.output'.format(node)), output, places)
-        
-        return node
     
     def assertItemsAlmostEqual(self, expected_seq, actual_seq, places=7, msg=None):
         """Assert that container items are near equal within epsilon threshold"""
@@ -1,6 +1,8 @@
 # Copyright (c) 2018 Serguei Kalentchouk et al. All rights reserved.
 # Use of this source code is governed by an MIT license that can be found in the LICENSE file.
-from node_test_case import NodeTestCase
+import math
+
+from node_test_case import NodeTestCase, cmds
 
 
 class TestArray(NodeTestCase):
@@ -39,6 +41,60 @@ class TestArray(NodeTestCase):
     def test_average(self):
         self.create_node('Average', {'input[0]': 5.0, 'input[1]': 5.0, 'input[2]': 5.0}, 5.0)
     
+    def test_average_update(self):
+        values = {0: 1.0, 1: 2.5, 3: -4.0, 5: 8.0}
+        node = self.create_node('Average', {'input[0]': 1.0, 'input[1]': 2.5, 'input[3]': -4.0, 'input[5]': 8.0}, 1.875)
+        
+        def average():
+            return sum(values.values()) / len(values)
+        
+        keys = {1: 3.0, 2: -7.5, 3: 0.25, 4: 11.0}
+        for frame in keys:
+            cmds.setKeyframe(node, attribute='input[3]', time=frame, value=keys[frame])
+        
+        for frame in sorted(keys):
+            cmds.currentTime(frame)
+            values[3] = keys[frame]
+            self.assertAlmostEqual(cmds.getAttr('{0}.output'.format(node)), average())
+        
+        # Evaluating at another time must not change the result at the current time
+        cmds.currentTime(2)
+        values[3] = keys[2]
+        self.assertAlmostEqual(cmds.getAttr('{0}.output'.format(node)), average())
+        self.assertAlmostEqual(cmds.getAttr('{0}.output'.format(node), time=4), (1.0 + 2.5 + 11.0 + 8.0) / 4.0)
+        self.assertAlmostEqual(cmds.getAttr('{0}.output'.format(node)), average())
+        
+        cmds.setAttr('{0}.{1}'.format(node, 'input[5]'), -3.0)
+        values[5] = -3.0
+        self.assertAlmostEqual(cmds.getAttr('{0}.output'.format(node)), average())
+        
+        cmds.setAttr('{0}.{1}'.format(node, 'input[4]'), 6.5)
+        values[4] = 6.5
+        self.assertAlmostEqual(cmds.getAttr('{0}.output'.format(node)), average())
+        
+        cmds.removeMultiInstance('{0}.{1}'.format(node, 'input[0]'))
+        del values[0]
+        self.assertAlmostEqual(cmds.getAttr('{0}.output'.format(node)), average())
+    
+    def test_sum_update_matches_fresh_sum(self):
+        values = [1.0e3, 0.1, -7.3, 2.2e-3, 5.5, -1.0e3, 0.7, 3.3]
+        node = self.create_node('Sum', {'input[{0}]'.format(index): value for index, value in enumerate(values)},
+                                sum(values))
+        
+        # Updates replace one term of the running total each, within the rebuild interval of 256 updates the
+        # result must stay within 1e-9 of the sum computed from scratch
+        for update in range(200):
+            index = (update * 3) % len(values)
+            values[index] = ((update * 37) % 101 - 50) * 0.173
+            cmds.setAttr('{0}.input[{1}]'.format(node, index), values[index])
+            self.assertAlmostEqual(cmds.getAttr('{0}.output'.format(node)), math.fsum(values), delta=1e-9)
+        
+        # Evaluating another context reduces from scratch, the next evaluation rebuilds the running total
+        cmds.getAttr('{0}.output'.format(node), time=10)
+        values[0] = 1.0e3
+        cmds.setAttr('{0}.input[0]'.format(node), values[0])
+        self.assertAlmostEqual(cmds.getAttr('{0}.output'.format(node)), math.fsum(values), delta=1e-12)
+    
     def test_weighted_average(self):
         self.create_node('WeightedAverage', {'input[0].value': 5.0, 'input[0].weight': 1.0,
                                              'input[1].value': 5.0, 'input[1].weight': 0.5,
@@ -150,3 +206,31 @@ class TestArray(NodeTestCase):
     
     def test_normalize_weights_array(self):
         self.create_node('NormalizeWeightsArray', {'input[0]': 0.8, 'input[1]': 0.2, 'input[2]': -0.2, 'input[3]': 1.2}, [0.4, 0.1, 0.0, 0.5])
+    
+    def test_sum_double_array_data(self):
+        self.create_array_data_node('SumDoubleArrayData', {'input': ('doubleArray', [5.0, -3.0, 2.0])}, 4.0)
+    
+    def test_sum_vector_array_data(self):
+        self.create_array_data_node('SumVectorArrayData', {'input': ('vectorArray', [(5.0, 1.0, 0.0),
+                                                                                      (-3.0, -2.0, 1.0),
+                                                                                      (2.0, 0.0, 3.0)])}, [4.0, -1.0, 4.0])
+    
+    def test_max_element_double_array_data(self):
+        self.create_array_data_node('MaxElementDoubleArrayData', {'input': ('doubleArray', [5.0, -3.0, 2.0])}, 5.0)
+    
+    def test_min_element_double_array_data(self):
+        self.create_array_data_node('MinElementDoubleArrayData', {'input': ('doubleArray', [5.0, -3.0, 2.0])}, -3.0)
+    
+    def test_average_double_array_data(self):
+        self.create_array_data_node('AverageDoubleArrayData', {'input': ('doubleArray', [3.0, 2.0, 2.0])}, 7.0 / 3)
+    
+    def test_weighted_average_double_array_data(self):
+        self.create_array_data_node('WeightedAverageDoubleArrayData', {'input': ('doubleArray', [4.0, 1.0]),
+                                                                        'weight': ('doubleArray', [0.5])}, 2.0)
+    
+    def test_normalize_double_array_data(self):
+        self.create_array_data_node('NormalizeDoubleArrayData', {'input': ('doubleArray', [40.0, 10.0])}, [0.8, 0.2])
+    
+    def test_normalize_weights_double_array_data(self):
+        self.create_array_data_node('NormalizeWeightsDoubleArrayData', {'input': ('doubleArray', [0.8, 0.2, -0.2, 1.2])},
+                                    [0.4, 0.1, 0.0, 0.5])
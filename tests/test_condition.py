@@ -42,6 +42,23 @@ class TestCondition(NodeTestCase):
         cmds.setAttr('{0}.{1}'.format(node, 'condition'), True)
         self.assertAlmostEqual(cmds.getAttr('{0}.output[0]'.format(node)), -1.0)
     
+    def test_select_array_sparse(self):
+        node = self.create_node('SelectArray', {'input1[0]': 1.0, 'input1[5]': 2.0,
+                                                'input2[0]': -1.0, 'input2[5]': -2.0}, [1.0, 2.0])
+        
+        # Sparse inputs are compacted, the output element 1 comes from the input element 5
+        self.assertEqual(cmds.getAttr('{0}.output'.format(node), multiIndices=True), [0, 1])
+        
+        cmds.setAttr('{0}.{1}'.format(node, 'condition'), True)
+        self.assertAlmostEqual(cmds.getAttr('{0}.output[1]'.format(node)), -2.0)
+    
+    def test_select_double_array_data(self):
+        node = self.create_array_data_node('SelectDoubleArrayData', {'input1': ('doubleArray', [1.0, 2.0]),
+                                                                     'input2': ('doubleArray', [-1.0, -2.0])}, [1.0, 2.0])
+        
+        cmds.setAttr('{0}.{1}'.format(node, 'condition'), True)
+        self.assertItemsAlmostEqual(cmds.getAttr('{0}.output'.format(node)), [-1.0, -2.0], 4)
+    
     def test_select_int(self):
         self.create_node('SelectInt', {'input1': 1, 'input2': 2, 'condition': True}, 2)
     
@@ -1,6 +1,11 @@
 # Copyright (c) 2018 Serguei Kalentchouk et al. All rights reserved.
 # Use of this source code is governed by an MIT license that can be found in the LICENSE file.
-from node_test_case import NodeTestCase
+import math
+import random
+
+import maya.api.OpenMaya as om
+
+from node_test_case import NodeTestCase, cmds
 
 
 class TestConvert(NodeTestCase):
@@ -67,6 +72,56 @@ class TestConvert(NodeTestCase):
         
         self.create_node('ScaleFromMatrix', {'input': matrix}, [0.5, 0.5, 0.5])
     
+    def assertDecomposeMatches(self, scale_node, rotation_node, matrix):
+        """Assert that the scale and rotation nodes match the MTransformationMatrix decomposition"""
+        reference = om.MTransformationMatrix(matrix)
+        
+        cmds.setAttr('{0}.input'.format(scale_node), list(matrix), type='matrix')
+        cmds.setAttr('{0}.input'.format(rotation_node), list(matrix), type='matrix')
+        
+        self.assertItemsAlmostEqual(cmds.getAttr('{0}.output'.format(scale_node))[0],
+                                    reference.scale(om.MSpace.kTransform), 6)
+        
+        # the quaternions may differ in sign only
+        rotation = om.MQuaternion(cmds.getAttr('{0}.output'.format(rotation_node))[0])
+        expected = reference.rotation(asQuaternion=True)
+        dot = rotation.x * expected.x + rotation.y * expected.y + rotation.z * expected.z + rotation.w * expected.w
+        self.assertAlmostEqual(abs(dot), 1.0, 6)
+    
+    def test_decompose_matches_transformation_matrix(self):
+        random.seed(5)
+        
+        scale_node = cmds.createNode('math_ScaleFromMatrix', skipSelect=True)
+        rotation_node = cmds.createNode('math_QuaternionFromMatrix', skipSelect=True)
+        
+        for _ in range(50):
+            xform = om.MTransformationMatrix()
+            xform.setScale([random.uniform(0.1, 4.0) for _ in range(3)], om.MSpace.kTransform)
+            xform.setShear([random.uniform(-1.0, 1.0) for _ in range(3)], om.MSpace.kTransform)
+            xform.setRotation(om.MEulerRotation([random.uniform(-3.0, 3.0) for _ in range(3)]))
+            xform.setTranslation(om.MVector([random.uniform(-10.0, 10.0) for _ in range(3)]), om.MSpace.kTransform)
+            
+            self.assertDecomposeMatches(scale_node, rotation_node, xform.asMatrix())
+    
+    def test_decompose_scale_and_shear(self):
+        scale_node = cmds.createNode('math_ScaleFromMatrix', skipSelect=True)
+        rotation_node = cmds.createNode('math_QuaternionFromMatrix', skipSelect=True)
+        
+        # negative scale, non-uniform scale, shear and a negative scale with shear
+        cases = [([1.5, 2.0, -0.5], [0.0, 0.0, 0.0]),
+                 ([0.25, 3.0, 1.5], [0.0, 0.0, 0.0]),
+                 ([1.0, 2.0, 0.5], [0.5, -0.25, 0.75]),
+                 ([2.0, 1.0, -3.0], [0.3, 0.0, -0.4])]
+        
+        for scale, shear in cases:
+            xform = om.MTransformationMatrix()
+            xform.setScale(scale, om.MSpace.kTransform)
+            xform.setShear(shear, om.MSpace.kTransform)
+            xform.setRotation(om.MEulerRotation(0.3, -1.2, 2.0))
+            xform.setTranslation(om.MVector(1.0, -2.0, 3.0), om.MSpace.kTransform)
+            
+            self.assertDecomposeMatches(scale_node, rotation_node, xform.asMatrix())
+    
     def test_matrix_from_trs(self):
         result = [0.0, 0.0, -1.0, 0.0,
                   0.0, 1.0, 0.0, 0.0,
@@ -77,6 +132,28 @@ class TestConvert(NodeTestCase):
                          {'translation': [1.0, 2.0, 3.0], 'rotation': [0.0, 90.0, 0.0]},
                          result)
     
+    def test_matrix_from_trs_matches_transformation_matrix(self):
+        random.seed(3)
+        
+        node = cmds.createNode('math_MatrixFromTRS', skipSelect=True)
+        
+        for order in range(6):
+            translation = [random.uniform(-10.0, 10.0) for _ in range(3)]
+            rotation = [random.uniform(-180.0, 180.0) for _ in range(3)]
+            scale = [random.uniform(-4.0, 4.0) for _ in range(3)]
+            
+            xform = om.MTransformationMatrix()
+            xform.setTranslation(om.MVector(translation), om.MSpace.kTransform)
+            xform.setRotation(om.MEulerRotation([math.radians(angle) for angle in rotation], order))
+            xform.setScale(scale, om.MSpace.kTransform)
+            
+            cmds.setAttr('{0}.translation'.format(node), *translation)
+            cmds.setAttr('{0}.rotation'.format(node), *rotation)
+            cmds.setAttr('{0}.scale'.format(node), *scale)
+            cmds.setAttr('{0}.rotationOrder'.format(node), order)
+            
+            self.assertItemsAlmostEqual(cmds.getAttr('{0}.output'.format(node)), list(xform.asMatrix()), 6)
+    
     def test_axis_from_matrix(self):
         matrix = [0.5, 0.0, 0.0, 0.0,
                   0.0, 0.5, 0.0, 0.0,
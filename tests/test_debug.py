@@ -0,0 +1,18 @@
+# Copyright (c) 2018 Serguei Kalentchouk et al. All rights reserved.
+# Use of this source code is governed by an MIT license that can be found in the LICENSE file.
+from node_test_case import NodeTestCase, cmds
+
+
+class TestDebug(NodeTestCase):
+    def test_debug_log(self):
+        self.create_node('DebugLog', {'input': 1.0}, 1.0)
+        cmds.mathNodesDebugLog(flush=True)
+    
+    def test_debug_log_interval(self):
+        self.create_node('DebugLogVector', {'input': [1.0, 2.0, 3.0], 'interval': 10.0}, [1.0, 2.0, 3.0])
+        cmds.mathNodesDebugLog(flush=True)
+    
+    def test_debug_log_matrix(self):
+        matrix = [float(i) for i in range(16)]
+        self.create_node('DebugLogMatrix', {'input': matrix}, matrix)
+        cmds.mathNodesDebugLog(flush=True)
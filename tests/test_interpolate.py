@@ -39,4 +39,11 @@ class TestInterpolate(NodeTestCase):
                       1.0, 0.0, 0.0, 0.0,
                       7.5, -7.5, 7.5, 1.0]
         
-        self.create_node('LerpMatrix', {'input1': matrix1, 'input2': matrix2, 'alpha': 0.5}, out_matrix)
+        node = self.create_node('LerpMatrix', {'input1': matrix1, 'input2': matrix2, 'alpha': 0.5}, out_matrix)
+        
+        # the memoized output must follow an input change and come back when the input is restored
+        cmds.setAttr('{0}.{1}'.format(node, 'alpha'), 1.0)
+        self.assertItemsAlmostEqual(cmds.getAttr('{0}.output'.format(node)), matrix2, 4)
+        
+        cmds.setAttr('{0}.{1}'.format(node, 'alpha'), 0.5)
+        self.assertItemsAlmostEqual(cmds.getAttr('{0}.output'.format(node)), out_matrix, 4)
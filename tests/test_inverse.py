@@ -1,5 +1,7 @@
 # Copyright (c) 2018 Serguei Kalentchouk et al. All rights reserved.
 # Use of this source code is governed by an MIT license that can be found in the LICENSE file.
+import maya.api.OpenMaya as om
+
 from node_test_case import NodeTestCase
 
 
@@ -17,6 +19,43 @@ class TestInverse(NodeTestCase):
         
         self.create_node('InverseMatrix', {'input': matrix}, inverse_matrix)
     
+    def test_inverse_matrix_paths(self):
+        # uniformly scaled takes the rigid path, non-uniformly scaled the affine path
+        rigid = [0.0, 0.0, -2.0, 0.0,
+                 0.0, 2.0, 0.0, 0.0,
+                 2.0, 0.0, 0.0, 0.0,
+                 4.0, -2.0, 6.0, 1.0]
+        
+        rigid_inverse = [0.0, 0.0, 0.5, 0.0,
+                         0.0, 0.5, 0.0, 0.0,
+                         -0.5, 0.0, 0.0, 0.0,
+                         3.0, 1.0, -2.0, 1.0]
+        
+        affine = [2.0, 0.0, 0.0, 0.0,
+                  0.0, 4.0, 0.0, 0.0,
+                  0.0, 0.0, 0.5, 0.0,
+                  2.0, 4.0, 1.0, 1.0]
+        
+        affine_inverse = [0.5, 0.0, 0.0, 0.0,
+                          0.0, 0.25, 0.0, 0.0,
+                          0.0, 0.0, 2.0, 0.0,
+                          -1.0, -1.0, -2.0, 1.0]
+        
+        for strict in (False, True):
+            self.create_node('InverseMatrix', {'input': rigid, 'strict': strict}, rigid_inverse)
+            self.create_node('InverseMatrix', {'input': affine, 'strict': strict}, affine_inverse)
+    
+    def test_inverse_matrix_near_singular(self):
+        # near singular matrices fall back to the general inverse
+        matrix = [1.0, 0.0, 0.0, 0.0,
+                  0.0, 1.0, 0.0, 0.0,
+                  1.0, 1.0, 1e-14, 0.0,
+                  2.0, 4.0, 1.0, 1.0]
+        
+        inverse_matrix = om.MMatrix(matrix).inverse()
+        
+        self.create_node('InverseMatrix', {'input': matrix}, [inverse_matrix[i] for i in range(16)])
+    
     def test_inverse_quaternion(self):
         self.create_node('InverseQuaternion', {'input': [1.0, 0.0, 0.0, 0.0]}, [-1.0, 0.0, 0.0, 0.0])
     
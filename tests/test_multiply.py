@@ -37,6 +37,25 @@ class TestMultiply(NodeTestCase):
         
         self.create_node('MultiplyMatrix', {'input1': matrix1, 'input2': matrix2}, result)
     
+    def test_multiply_matrix_affine(self):
+        matrix1 = [2.0, 0.0, 0.0, 0.0,
+                   0.0, 1.0, 0.0, 0.0,
+                   0.0, 0.0, 1.0, 0.0,
+                   1.0, 2.0, 3.0, 1.0]
+        
+        matrix2 = [0.0, 1.0, 0.0, 0.0,
+                   -1.0, 0.0, 0.0, 0.0,
+                   0.0, 0.0, 1.0, 0.0,
+                   5.0, 0.0, 0.0, 1.0]
+        
+        result = [0.0, 2.0, 0.0, 0.0,
+                  -1.0, 0.0, 0.0, 0.0,
+                  0.0, 0.0, 1.0, 0.0,
+                  3.0, 1.0, 3.0, 1.0]
+        
+        for strict in (False, True):
+            self.create_node('MultiplyMatrix', {'input1': matrix1, 'input2': matrix2, 'strict': strict}, result)
+    
     def test_multiply_vector(self):
         self.create_node('MultiplyVector', {'input1': [1.0, 1.0, 1.0], 'input2': 0.5}, [0.5, 0.5, 0.5])
 
@@ -0,0 +1,114 @@
+# Copyright (c) 2018 Serguei Kalentchouk et al. All rights reserved.
+# Use of this source code is governed by an MIT license that can be found in the LICENSE file.
+import os
+import tempfile
+
+from node_test_case import NodeTestCase, cmds
+
+
+class TestPackedArray(NodeTestCase):
+    def create_pack_node(self, node_type, values):
+        node = cmds.createNode('math_{0}'.format(node_type), skipSelect=True)
+        for index, value in enumerate(values):
+            if isinstance(value, list) and len(value) == 16:
+                cmds.setAttr('{0}.input[{1}]'.format(node, index), *value, type='matrix')
+            elif isinstance(value, list):
+                cmds.setAttr('{0}.input[{1}]'.format(node, index), *value)
+            else:
+                cmds.setAttr('{0}.input[{1}]'.format(node, index), value)
+        
+        return node
+    
+    def create_packed_node(self, node_type, source, output, places=4):
+        node = cmds.createNode('math_{0}'.format(node_type), skipSelect=True)
+        cmds.connectAttr('{0}.output'.format(source), '{0}.input'.format(node))
+        
+        self.assertOutput(node, output, places)
+        
+        return node
+    
+    def test_average_packed_array(self):
+        pack = self.create_pack_node('PackArray', [3.0, 2.0, 2.0])
+        self.create_packed_node('AveragePackedArray', pack, 7.0 / 3)
+    
+    def test_average_packed_vector_array(self):
+        pack = self.create_pack_node('PackVectorArray', [[1.0, 0.0, 3.0], [3.0, 2.0, 1.0]])
+        self.create_packed_node('AveragePackedVectorArray', pack, [2.0, 1.0, 2.0])
+    
+    def test_average_packed_rotation_array(self):
+        pack = self.create_pack_node('PackRotationArray', [[0.0, 0.0, 0.0], [90.0, 0.0, 0.0]])
+        self.create_packed_node('AveragePackedRotationArray', pack, [45.0, 0.0, 0.0])
+    
+    def test_average_packed_quaternion_array(self):
+        pack = self.create_pack_node('PackQuaternionArray', [[0.0, 0.0, 0.0, 1.0], [0.707107, 0.0, 0.0, 0.707107]])
+        self.create_packed_node('AveragePackedQuaternionArray', pack, [0.382683, 0.0, 0.0, 0.92388])
+    
+    def test_average_packed_matrix_array(self):
+        matrix1 = [1.0, 0.0, 0.0, 0.0,
+                   0.0, 1.0, 0.0, 0.0,
+                   0.0, 0.0, 1.0, 0.0,
+                   2.0, 0.0, 0.0, 1.0]
+        
+        matrix2 = [1.0, 0.0, 0.0, 0.0,
+                   0.0, 1.0, 0.0, 0.0,
+                   0.0, 0.0, 1.0, 0.0,
+                   0.0, 2.0, 0.0, 1.0]
+        
+        result = [1.0, 0.0, 0.0, 0.0,
+                  0.0, 1.0, 0.0, 0.0,
+                  0.0, 0.0, 1.0, 0.0,
+                  1.0, 1.0, 0.0, 1.0]
+        
+        pack = self.create_pack_node('PackMatrixArray', [matrix1, matrix2])
+        self.create_packed_node('AveragePackedMatrixArray', pack, result)
+    
+    def test_normalize_packed_array(self):
+        pack = self.create_pack_node('PackArray', [40.0, 10.0])
+        normalize = cmds.createNode('math_NormalizePackedArray', skipSelect=True)
+        cmds.connectAttr('{0}.output'.format(pack), '{0}.input'.format(normalize))
+        
+        self.create_packed_node('UnpackArray', normalize, [0.8, 0.2])
+    
+    def test_normalize_weights_packed_array(self):
+        pack = self.create_pack_node('PackArray', [0.8, 0.2, -0.2, 1.2])
+        normalize = cmds.createNode('math_NormalizeWeightsPackedArray', skipSelect=True)
+        cmds.connectAttr('{0}.output'.format(pack), '{0}.input'.format(normalize))
+        
+        self.create_packed_node('UnpackArray', normalize, [0.4, 0.1, 0.0, 0.5])
+    
+    def test_select_packed_array(self):
+        pack1 = self.create_pack_node('PackArray', [1.0, 2.0])
+        pack2 = self.create_pack_node('PackArray', [3.0, 4.0])
+        
+        select = cmds.createNode('math_SelectPackedArray', skipSelect=True)
+        cmds.connectAttr('{0}.output'.format(pack1), '{0}.input1'.format(select))
+        cmds.connectAttr('{0}.output'.format(pack2), '{0}.input2'.format(select))
+        cmds.setAttr('{0}.condition'.format(select), True)
+        
+        self.create_packed_node('AveragePackedArray', select, 3.5)
+    
+    def test_mismatched_element_type(self):
+        pack = self.create_pack_node('PackVectorArray', [[1.0, 0.0, 3.0], [3.0, 2.0, 1.0]])
+        self.create_packed_node('AveragePackedArray', pack, 0.0)
+    
+    def test_packed_array_file_io(self):
+        for file_type, extension in (('mayaAscii', 'ma'), ('mayaBinary', 'mb')):
+            cmds.file(new=True, force=True)
+            
+            pack = self.create_pack_node('PackQuaternionArray', [[0.0, 0.0, 0.0, 1.0], [0.707107, 0.0, 0.0, 0.707107]])
+            unpack = cmds.createNode('math_UnpackQuaternionArray', skipSelect=True)
+            cmds.connectAttr('{0}.output'.format(pack), '{0}.input'.format(unpack))
+            
+            # Store the packed array on an unconnected input so that it gets written to the file
+            average = cmds.createNode('math_AveragePackedQuaternionArray', skipSelect=True)
+            cmds.connectAttr('{0}.output'.format(pack), '{0}.input'.format(average))
+            cmds.getAttr('{0}.output'.format(average))
+            cmds.disconnectAttr('{0}.output'.format(pack), '{0}.input'.format(average))
+            
+            path = os.path.join(tempfile.gettempdir(), 'test_packed_array.{0}'.format(extension))
+            cmds.file(rename=path)
+            cmds.file(save=True, type=file_type, force=True)
+            cmds.file(path, open=True, force=True)
+            os.remove(path)
+            
+            self.assertOutput(average, [0.382683, 0.0, 0.0, 0.92388])
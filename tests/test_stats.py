@@ -0,0 +1,37 @@
+# Copyright (c) 2018 Serguei Kalentchouk et al. All rights reserved.
+# Use of this source code is governed by an MIT license that can be found in the LICENSE file.
+import json
+
+from node_test_case import NodeTestCase, cmds
+
+
+class TestStats(NodeTestCase):
+    def tearDown(self):
+        cmds.mathNodesStats(enable=False, reset=True)
+    
+    def test_stats_disabled(self):
+        cmds.mathNodesStats(enable=False, reset=True)
+        self.create_node('Absolute', {'input': -1.0}, 1.0)
+        
+        self.assertEqual(json.loads(cmds.mathNodesStats(json=True))['nodes'], [])
+    
+    def test_stats_query(self):
+        cmds.mathNodesStats(enable=True, reset=True)
+        self.create_node('Absolute', {'input': -1.0}, 1.0)
+        
+        nodes = json.loads(cmds.mathNodesStats(json=True))['nodes']
+        self.assertEqual(len(nodes), 1)
+        self.assertEqual(nodes[0]['type'], 'math_Absolute')
+        self.assertGreaterEqual(nodes[0]['calls'], 1)
+        self.assertGreaterEqual(nodes[0]['total_ns'], nodes[0]['max_ns'])
+        
+        result = cmds.mathNodesStats(list=True)
+        self.assertEqual(len(result), 1)
+        self.assertTrue(result[0].startswith('math_Absolute '))
+    
+    def test_stats_reset(self):
+        cmds.mathNodesStats(enable=True, reset=True)
+        self.create_node('Absolute', {'input': -1.0}, 1.0)
+        cmds.mathNodesStats(reset=True)
+        
+        self.assertEqual(json.loads(cmds.mathNodesStats(json=True))['nodes'], [])
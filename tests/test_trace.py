@@ -0,0 +1,28 @@
+# Copyright (c) 2018 Serguei Kalentchouk et al. All rights reserved.
+# Use of this source code is governed by an MIT license that can be found in the LICENSE file.
+import json
+
+from node_test_case import NodeTestCase, cmds
+
+
+class TestTrace(NodeTestCase):
+    def tearDown(self):
+        cmds.mathNodesTrace(enable=False, clear=True)
+    
+    def test_trace_events(self):
+        cmds.mathNodesTrace(enable=True, clear=True)
+        node = self.create_node('Absolute', {'input': -1.0}, 1.0)
+        
+        events = json.loads(cmds.mathNodesTrace(json=True))['traceEvents']
+        computes = [event for event in events if event['ph'] == 'X']
+        self.assertGreaterEqual(len(computes), 1)
+        self.assertEqual(computes[0]['name'], node)
+        self.assertEqual(computes[0]['cat'], 'Absolute')
+    
+    def test_trace_clear(self):
+        cmds.mathNodesTrace(enable=True, clear=True)
+        self.create_node('Absolute', {'input': -1.0}, 1.0)
+        cmds.mathNodesTrace(clear=True)
+        
+        events = json.loads(cmds.mathNodesTrace(json=True))['traceEvents']
+        self.assertEqual([event for event in events if event['ph'] == 'X'], [])
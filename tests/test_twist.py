@@ -14,3 +14,7 @@ class TestTwist(NodeTestCase):
     
     def test_twist_from_rotation(self):
         self.create_node('TwistFromRotation', {'input': [0.0, -90.0, -90.0]}, -90.0)
+    
+    def test_twist_past_quarter_turn(self):
+        self.create_node('TwistFromRotation', {'input': [0.0, 120.0, 0.0], 'axis': 1}, 120.0)
+        self.create_node('TwistFromRotation', {'input': [30.0, 0.0, -150.0], 'axis': 2, 'rotationOrder': 5}, -150.0)